@@ -0,0 +1,302 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+#include <fs2a/Base16.hpp>
+#include <fs2a/Base32.hpp>
+#include <fs2a/Base64.hpp>
+
+namespace po = boost::program_options;
+
+namespace {
+
+	/// Function that encodes or decodes its input into a preallocated output, returning the output length
+	typedef std::function<size_t(const std::string &, std::string &)> codecfunc_t;
+
+	/// A codec kernel to benchmark
+	typedef struct kernel_s {
+		std::string codec;  ///< Codec name, like base64
+		std::string name;   ///< Kernel name, like reference or table
+		codecfunc_t encode; ///< Encoding function
+		codecfunc_t decode; ///< Decoding function
+	} kernel_t;
+
+	/** Plain character at a time Base64 encoder, as this library had it
+	 * originally. Serves as the baseline for all other kernels. */
+	size_t refB64encode(const std::string & in_i, std::string & out_o)
+	{
+		static const char b64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		const uint8_t * d = reinterpret_cast<const uint8_t *>(in_i.data());
+		size_t i = 0, o = 0;
+
+		for (; i + 2 < in_i.size(); i += 3) {
+			out_o[o++] = b64[d[i] >> 2];
+			out_o[o++] = b64[((d[i] & 0x03) << 4) | (d[i+1] >> 4)];
+			out_o[o++] = b64[((d[i+1] & 0x0F) << 2) | (d[i+2] >> 6)];
+			out_o[o++] = b64[d[i+2] & 0x3F];
+		}
+		if (in_i.size() - i == 1) {
+			out_o[o++] = b64[d[i] >> 2];
+			out_o[o++] = b64[(d[i] & 0x03) << 4];
+			out_o[o++] = '=';
+			out_o[o++] = '=';
+		} else if (in_i.size() - i == 2) {
+			out_o[o++] = b64[d[i] >> 2];
+			out_o[o++] = b64[((d[i] & 0x03) << 4) | (d[i+1] >> 4)];
+			out_o[o++] = b64[(d[i+1] & 0x0F) << 2];
+			out_o[o++] = '=';
+		}
+		return o;
+	}
+
+	/// Plain character at a time Base64 decoder using a search in the alphabet.
+	size_t refB64decode(const std::string & in_i, std::string & out_o)
+	{
+		static const char b64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		uint32_t q = 0;
+		uint8_t off = 0;
+		size_t o = 0;
+
+		for (char c : in_i) {
+			const char * p = c ? strchr(b64, c) : nullptr;
+			if (p == nullptr) {
+				if (c == '=') break;
+				throw std::runtime_error("Invalid Base64 character");
+			}
+			q = (q << 6) | static_cast<uint32_t>(p - b64);
+			if (++off == 4) {
+				out_o[o++] = static_cast<char>(q >> 16);
+				out_o[o++] = static_cast<char>(q >> 8);
+				out_o[o++] = static_cast<char>(q);
+				off = 0;
+			}
+		}
+		if (off == 2) out_o[o++] = static_cast<char>(q >> 4);
+		if (off == 3) {
+			out_o[o++] = static_cast<char>(q >> 10);
+			out_o[o++] = static_cast<char>(q >> 2);
+		}
+		return o;
+	}
+
+	/// Byte at a time hex encoder, the way callers format digests without a codec
+	size_t refB16encode(const std::string & in_i, std::string & out_o)
+	{
+		size_t o = 0;
+		for (const char c : in_i) {
+			std::string h = fmt::format("{:02x}", static_cast<uint8_t>(c));
+			out_o[o++] = h[0];
+			out_o[o++] = h[1];
+		}
+		return o;
+	}
+
+	/// Byte at a time hex decoder, counterpart of refB16encode()
+	size_t refB16decode(const std::string & in_i, std::string & out_o)
+	{
+		size_t o = 0;
+		for (size_t i = 0; i + 1 < in_i.size(); i += 2) {
+			out_o[o++] = static_cast<char>(std::stoul(in_i.substr(i, 2), nullptr, 16));
+		}
+		return o;
+	}
+
+	/// All kernels to benchmark, the first kernel of every codec is its reference.
+	std::vector<kernel_t> kernels()
+	{
+		std::vector<kernel_t> k;
+
+		k.push_back({"base64", "reference", refB64encode, refB64decode});
+		k.push_back({"base64", "table",
+			[](const std::string & in_i, std::string & out_o) {
+				return Fs2a::base64encode(std::as_bytes(std::span(in_i)), std::span<char>(out_o));
+			},
+			[](const std::string & in_i, std::string & out_o) {
+				return Fs2a::base64decode(in_i, std::as_writable_bytes(std::span(out_o)));
+			}
+		});
+		k.push_back({"base64", "stream",
+			[](const std::string & in_i, std::string & out_o) {
+				size_t o = 0;
+				Fs2a::Base64Encoder enc([&](const char * d_i, const size_t l_i) {
+					memcpy(out_o.data() + o, d_i, l_i);
+					o += l_i;
+				});
+				for (size_t i = 0; i < in_i.size(); i += 65536) {
+					enc.update(in_i.data() + i, std::min<size_t>(65536, in_i.size() - i));
+				}
+				enc.finish();
+				return o;
+			},
+			[](const std::string & in_i, std::string & out_o) {
+				size_t o = 0;
+				Fs2a::Base64Decoder dec([&](const char * d_i, const size_t l_i) {
+					memcpy(out_o.data() + o, d_i, l_i);
+					o += l_i;
+				});
+				for (size_t i = 0; i < in_i.size(); i += 65536) {
+					dec.update(in_i.data() + i, std::min<size_t>(65536, in_i.size() - i));
+				}
+				dec.finish();
+				return o;
+			}
+		});
+		k.push_back({"base64", "parallel",
+			[](const std::string & in_i, std::string & out_o) {
+				return Fs2a::base64encodeParallel(std::as_bytes(std::span(in_i)), std::span<char>(out_o));
+			},
+			[](const std::string & in_i, std::string & out_o) {
+				return Fs2a::base64decodeParallel(in_i, std::as_writable_bytes(std::span(out_o)));
+			}
+		});
+
+		k.push_back({"base16", "reference", refB16encode, refB16decode});
+		const std::pair<const char *, Fs2a::Base16::kernel_e> b16[] = {
+			{"scalar", Fs2a::Base16::scalar},
+			{"ssse3", Fs2a::Base16::ssse3},
+			{"avx2", Fs2a::Base16::avx2},
+		};
+		for (const auto & [name, kern] : b16) {
+			if (!Fs2a::Base16::supported(kern)) continue;
+			k.push_back({"base16", name,
+				[kern](const std::string & in_i, std::string & out_o) {
+					Fs2a::Base16::encode(reinterpret_cast<const uint8_t *>(in_i.data()), in_i.size(), out_o.data(), false, kern);
+					return Fs2a::Base16::encodedLength(in_i.size());
+				},
+				[kern](const std::string & in_i, std::string & out_o) {
+					Fs2a::Base16::decode(in_i.data(), in_i.size(), reinterpret_cast<uint8_t *>(out_o.data()), kern);
+					return Fs2a::Base16::decodedLength(in_i.size());
+				}
+			});
+		}
+
+		k.push_back({"base32", "table",
+			[](const std::string & in_i, std::string & out_o) {
+				return Fs2a::base32encode(std::as_bytes(std::span(in_i)), std::span<char>(out_o));
+			},
+			[](const std::string & in_i, std::string & out_o) {
+				return Fs2a::base32decode(in_i, std::as_writable_bytes(std::span(out_o)));
+			}
+		});
+		return k;
+	}
+
+	/** Run a function repeatedly for at least a minimum time.
+	 * @returns Best achieved throughput in GB/s over @p bytes_i bytes per run */
+	double measure(const std::function<void()> & func_i, const size_t bytes_i, const double mintime_i)
+	{
+		typedef std::chrono::steady_clock clk;
+		double best = 0.0, total = 0.0;
+
+		do {
+			// Batch small payloads, otherwise the clock dominates
+			size_t reps = std::max<size_t>(1, 65536 / std::max<size_t>(1, bytes_i));
+			auto start = clk::now();
+			for (size_t r = 0; r < reps; r++) func_i();
+			double secs = std::chrono::duration<double>(clk::now() - start).count();
+			total += secs;
+			if (secs > 0) best = std::max(best, static_cast<double>(bytes_i * reps) / secs / 1e9);
+		} while (total < mintime_i);
+
+		return best;
+	}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+	po::options_description desc("Fs2a codec benchmark");
+	po::variables_map vm;
+	size_t maxsize = 0;
+	double mintime = 0.0;
+	std::string filter;
+
+	// clang-format off
+	desc.add_options()
+	("help,h", "Show this helpful message")
+	("max,m", po::value<size_t>(&maxsize)->default_value(64 << 20), "Largest payload in bytes")
+	("time,t", po::value<double>(&mintime)->default_value(0.2), "Minimum seconds per measurement")
+	("filter,f", po::value<std::string>(&filter)->default_value(""), "Only run codecs or kernels containing this string");
+	// clang-format on
+	po::store(po::parse_command_line(argc, argv, desc), vm);
+	po::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	std::mt19937_64 rng(42);
+	std::vector<kernel_t> ks = kernels();
+
+	fmt::print("{:<8} {:<10} {:>10} {:>12} {:>12}\n", "codec", "kernel", "bytes", "enc GB/s", "dec GB/s");
+	for (size_t size = 16; size <= maxsize; size *= 4) {
+		std::string data(size, '\0');
+		for (auto & c : data) c = static_cast<char>(rng());
+
+		std::map<std::string, std::string> refenc; // Reference encoding per codec
+		for (const auto & k : ks) {
+			if (!filter.empty() && k.codec.find(filter) == std::string::npos &&
+				k.name.find(filter) == std::string::npos) continue;
+
+			// The first kernel of a codec is its reference, others should produce the same
+			std::string enc(2 * size + 16, '\0'), dec(size + 16, '\0');
+			enc.resize(k.encode(data, enc));
+			if (k.name == "reference") refenc[k.codec] = enc;
+			else if (refenc.count(k.codec) && enc != refenc[k.codec]) {
+				fmt::print(stderr, "{} {} encoding differs from reference at {} bytes\n", k.codec, k.name, size);
+				return 1;
+			}
+			dec.resize(k.decode(enc, dec));
+			if (dec != data) {
+				fmt::print(stderr, "{} {} decoding doesn't round trip at {} bytes\n", k.codec, k.name, size);
+				return 1;
+			}
+
+			std::string out(2 * size + 16, '\0');
+			double e = measure([&]() { k.encode(data, out); }, size, mintime);
+			double d = measure([&]() { k.decode(enc, out); }, size, mintime);
+			fmt::print("{:<8} {:<10} {:>10} {:>12.3f} {:>12.3f}\n", k.codec, k.name, size, e, d);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <sstream>
+#include <string>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/ArenaTable.hpp>
+#include <fs2a/readCSV.hpp>
+
+#define CHECKNAME arenatableCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(arena);
+	CPPUNIT_TEST(cells);
+	CPPUNIT_TEST(copies);
+	CPPUNIT_TEST(headered);
+	CPPUNIT_TEST(compact);
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+
+	void arena() {
+		Fs2a::StringArena a(64);
+
+		CPPUNIT_ASSERT_EQUAL(size_t(0), a.chunks());
+		CPPUNIT_ASSERT(a.store("").empty());
+		CPPUNIT_ASSERT_EQUAL(size_t(0), a.chunks());
+
+		std::string_view x = a.store("abcdefgh");
+		CPPUNIT_ASSERT_EQUAL(std::string("abcdefgh"), std::string(x));
+		CPPUNIT_ASSERT_EQUAL(size_t(1), a.chunks());
+
+		// A large string gets its own chunk, smaller ones keep filling the current chunk
+		std::string big(100, 'x');
+		std::string_view y = a.store(big);
+		std::string_view z = a.store("ijkl");
+		CPPUNIT_ASSERT_EQUAL(size_t(2), a.chunks());
+		CPPUNIT_ASSERT_EQUAL(x.data() + 8, z.data());
+		CPPUNIT_ASSERT_EQUAL(big, std::string(y));
+		CPPUNIT_ASSERT_EQUAL(size_t(112), a.used());
+		CPPUNIT_ASSERT_EQUAL(size_t(164), a.capacity());
+
+		// Moving keeps the strings where they are
+		Fs2a::StringArena b(std::move(a));
+		CPPUNIT_ASSERT_EQUAL(size_t(0), a.chunks());
+		CPPUNIT_ASSERT_EQUAL(std::string("abcdefgh"), std::string(x));
+
+		b.clear();
+		CPPUNIT_ASSERT_EQUAL(size_t(0), b.capacity());
+	}
+
+	void cells() {
+		Fs2a::ArenaTable t;
+
+		CPPUNIT_ASSERT_THROW(t.set(0, 0, "x"), std::logic_error);
+		t.columns(2);
+		t.set(1, 2, "hello");
+		CPPUNIT_ASSERT_EQUAL(3U, t.rows());
+		CPPUNIT_ASSERT(t.cell(1, 2) == "hello");
+		CPPUNIT_ASSERT(t.cell(0, 2).empty());
+		CPPUNIT_ASSERT_THROW(t.set(2, 0, "x"), std::out_of_range);
+
+		{
+			std::string tmp = "temporary";
+			t.set(0, 0, tmp);
+		}
+		CPPUNIT_ASSERT(t.cell(0, 0) == "temporary");
+	}
+
+	void copies() {
+		Fs2a::ArenaTable t;
+		t.columns(1);
+		t.set(0, 0, "original");
+
+		Fs2a::ArenaTable c(t);
+		CPPUNIT_ASSERT(c.cell(0, 0) == "original");
+		CPPUNIT_ASSERT(c.cell(0, 0).data() != t.cell(0, 0).data());
+
+		Fs2a::ArenaTable m(std::move(c));
+		CPPUNIT_ASSERT(m.cell(0, 0) == "original");
+
+		Fs2a::Table<std::string> s = m.toTable();
+		CPPUNIT_ASSERT_EQUAL(std::string("original"), s.cell(0, 0));
+		Fs2a::ArenaTable back(s);
+		CPPUNIT_ASSERT(back.cell(0, 0) == "original");
+	}
+
+	void headered() {
+		std::stringstream sss;
+
+		sss << "Name;Name;Amount\nAlice;\"Smith; Jr.\";\"1\"\"2\"\nBob;Jones;3\n";
+		Fs2a::HeaderedArenaTable t;
+		CPPUNIT_ASSERT_NO_THROW(Fs2a::readCSV(sss, t, ';'));
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(3), t.columns());
+		CPPUNIT_ASSERT_EQUAL(3U, t.rows());
+		CPPUNIT_ASSERT(t.cell("Name", 2) == "Bob");
+		CPPUNIT_ASSERT(t.cell("Name_0", 1) == "Smith; Jr.");
+		CPPUNIT_ASSERT(t.cell("Amount", 1) == "1\"2");
+		CPPUNIT_ASSERT(t.cell(1, 0) == "Name_0");
+		CPPUNIT_ASSERT_THROW(t.cell("Nope", 1), std::invalid_argument);
+	}
+
+	void compact() {
+		const int64_t before = Fs2a::MemoryTally::live();
+		{
+			const std::string_view status = "a rather long status description";
+			Fs2a::ArenaTable t;
+			t.columns(1);
+			for (int i = 0; i < 1000; i++) t.set(0, i, i % 2 ? "EUR" : status);
+			CPPUNIT_ASSERT_EQUAL(1000 / 2 * (3 + status.size()), t.arena().used());
+			const size_t used = t.memoryUsage();
+			CPPUNIT_ASSERT(used >= t.arena().capacity());
+
+			// Every distinct string is kept once
+			const size_t compacted = t.compact();
+			CPPUNIT_ASSERT_EQUAL(3 + status.size(), t.arena().used());
+			CPPUNIT_ASSERT(compacted < used);
+			CPPUNIT_ASSERT_EQUAL(std::string_view("EUR"), t(0, 999));
+			CPPUNIT_ASSERT_EQUAL(t(0, 1).data(), t(0, 3).data());
+			CPPUNIT_ASSERT_EQUAL(int64_t(compacted), Fs2a::MemoryTally::live() - before);
+		}
+		CPPUNIT_ASSERT_EQUAL(before, Fs2a::MemoryTally::live());
+	}
+
+};
+
+#undef CHECKNAME
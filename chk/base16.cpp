@@ -0,0 +1,140 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/Base16.hpp>
+#include <fs2a/CsvWriter.hpp>
+
+#define CHECKNAME base16Check
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(basics);
+	CPPUNIT_TEST(errors);
+	CPPUNIT_TEST(kernels);
+	CPPUNIT_TEST(formatting);
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+
+	void basics() {
+		using namespace std::string_literals;
+		const std::string d = "\x01\xab\xff\x10"s;
+
+		CPPUNIT_ASSERT_EQUAL("01abff10"s, Fs2a::base16encode(d.data(), d.size()));
+		CPPUNIT_ASSERT_EQUAL("01ABFF10"s, Fs2a::base16encode(d.data(), d.size(), true));
+
+		std::vector<char> v = Fs2a::base16decode<char>("01aBFf10");
+		CPPUNIT_ASSERT_EQUAL(d, std::string(v.begin(), v.end()));
+		CPPUNIT_ASSERT(Fs2a::base16decode<char>("").empty());
+	}
+
+	void errors() {
+		CPPUNIT_ASSERT_THROW(Fs2a::base16decode<char>("abc"), std::runtime_error);
+		try {
+			Fs2a::base16decode<char>("00112g33");
+			CPPUNIT_ASSERT(false);
+		} catch (const std::runtime_error & e) {
+			CPPUNIT_ASSERT(std::string(e.what()).find("\"g\" encountered at position 5") != std::string::npos);
+		}
+
+		char out[3];
+		CPPUNIT_ASSERT_THROW(Fs2a::base16encode(std::as_bytes(std::span("ab", 2)), std::span<char>(out)), std::length_error);
+	}
+
+	void kernels() {
+		std::mt19937 rng(16);
+		const Fs2a::Base16::kernel_e ks[] = { Fs2a::Base16::scalar, Fs2a::Base16::ssse3, Fs2a::Base16::avx2 };
+
+		// Every supported kernel should match the scalar one, also on invalid digits
+		for (size_t it = 0; it < 2000; it++) {
+			std::string data(rng() % 200, '\0');
+			for (auto & c : data) c = static_cast<char>(rng());
+			const bool upper = rng() % 2;
+			std::string ref(data.size() * 2, '\0');
+			Fs2a::Base16::encode(reinterpret_cast<const uint8_t *>(data.data()), data.size(), ref.data(), upper, Fs2a::Base16::scalar);
+
+			std::string hex = ref;
+			if (!hex.empty() && rng() % 2) hex[rng() % hex.size()] = static_cast<char>(rng());
+			std::vector<uint8_t> refdec(data.size());
+			size_t refn = Fs2a::Base16::decode(hex.data(), hex.size(), refdec.data(), Fs2a::Base16::scalar);
+
+			for (auto k : ks) {
+				if (!Fs2a::Base16::supported(k)) continue;
+				std::string enc(data.size() * 2, '\0');
+				Fs2a::Base16::encode(reinterpret_cast<const uint8_t *>(data.data()), data.size(), enc.data(), upper, k);
+				CPPUNIT_ASSERT_EQUAL(ref, enc);
+
+				std::vector<uint8_t> dec(data.size());
+				CPPUNIT_ASSERT_EQUAL(refn, Fs2a::Base16::decode(hex.data(), hex.size(), dec.data(), k));
+				CPPUNIT_ASSERT(std::equal(dec.begin(), dec.begin() + refn / 2, refdec.begin()));
+			}
+		}
+	}
+
+	void formatting() {
+		using namespace std::string_literals;
+		const uint8_t digest[] = { 0xde, 0xad, 0xbe, 0xef };
+
+		CPPUNIT_ASSERT_EQUAL("deadbeef"s, fmt::format("{}", Fs2a::hex(digest)));
+		CPPUNIT_ASSERT_EQUAL("DEADBEEF"s, fmt::format("{:X}", Fs2a::hex(digest)));
+		CPPUNIT_ASSERT_EQUAL("DEADBEEF"s, fmt::format("{}", Fs2a::hex(digest, sizeof(digest), true)));
+
+		std::ostringstream oss;
+		oss << Fs2a::hex("\x01\x02"s);
+		CPPUNIT_ASSERT_EQUAL("0102"s, oss.str());
+
+		// Larger than the internal formatting buffer
+		std::string big(1000, '\x5a');
+		CPPUNIT_ASSERT_EQUAL(std::string(2000, '5').size(), fmt::format("{}", Fs2a::hex(big)).size());
+
+		std::ostringstream csv;
+		Fs2a::CsvWriter w(Fs2a::CsvWriter::PayPal);
+		w.destination(&csv);
+		w.header("id");
+		w.header("hash");
+		w.endRow();
+		w.field("1");
+		w.field(Fs2a::hex(digest));
+		CPPUNIT_ASSERT_EQUAL("\"id\",\"hash\"\n\"1\",\"deadbeef\"\n"s, csv.str());
+	}
+
+};
+
+#undef CHECKNAME
@@ -0,0 +1,113 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/Base32.hpp>
+
+#define CHECKNAME base32Check
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(rfc4648);
+	CPPUNIT_TEST(errors);
+	CPPUNIT_TEST(roundtrip);
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+
+	void rfc4648() {
+		using namespace std::string_literals;
+		// Test vectors from RFC 4648 section 10
+		const std::vector<std::string> in = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+		const std::vector<std::string> std = {
+			"", "MY======", "MZXQ====", "MZXW6===", "MZXW6YQ=", "MZXW6YTB", "MZXW6YTBOI======"
+		};
+		const std::vector<std::string> hex = {
+			"", "CO======", "CPNG====", "CPNMU===", "CPNMUOG=", "CPNMUOJ1", "CPNMUOJ1E8======"
+		};
+
+		for (size_t i = 0; i < in.size(); i++) {
+			CPPUNIT_ASSERT_EQUAL(std[i], Fs2a::base32encode<char>(in[i].data(), in[i].size()));
+			CPPUNIT_ASSERT_EQUAL(hex[i], (Fs2a::base32encode<char, Fs2a::Base32Hex>(in[i].data(), in[i].size())));
+
+			std::vector<char> v = Fs2a::base32decode<char>(std[i]);
+			CPPUNIT_ASSERT_EQUAL(in[i], std::string(v.begin(), v.end()));
+			v = Fs2a::base32decode<char, Fs2a::Base32Hex>(hex[i]);
+			CPPUNIT_ASSERT_EQUAL(in[i], std::string(v.begin(), v.end()));
+		}
+
+		CPPUNIT_ASSERT_EQUAL("MZXW6YTBOI"s, (Fs2a::base32encode<char, Fs2a::Base32Unpadded>("foobar", 6)));
+		std::vector<char> v = Fs2a::base32decode<char, Fs2a::Base32Unpadded>("mzxw6ytboi");
+		CPPUNIT_ASSERT_EQUAL("foobar"s, std::string(v.begin(), v.end()));
+	}
+
+	void errors() {
+		// Not a multiple of 8 with padding
+		CPPUNIT_ASSERT_THROW(Fs2a::base32decode<char>("MZXW6"), std::runtime_error);
+		// Wrong amount of padding
+		CPPUNIT_ASSERT_THROW(Fs2a::base32decode<char>("MZXW6Y=="), std::runtime_error);
+		// Invalid length of the last group
+		CPPUNIT_ASSERT_THROW((Fs2a::base32decode<char, Fs2a::Base32Unpadded>("MZX")), std::runtime_error);
+		// Padding not allowed
+		CPPUNIT_ASSERT_THROW((Fs2a::base32decode<char, Fs2a::Base32Unpadded>("MY======")), std::runtime_error);
+		// Invalid character, 1 is not in the standard alphabet
+		try {
+			Fs2a::base32decode<char>("MZXW6Y1B");
+			CPPUNIT_ASSERT(false);
+		} catch (const std::runtime_error & e) {
+			CPPUNIT_ASSERT(std::string(e.what()).find("\"1\" encountered at position 6") != std::string::npos);
+		}
+	}
+
+	void roundtrip() {
+		std::mt19937 rng(32);
+
+		for (size_t it = 0; it < 1000; it++) {
+			std::string data(rng() % 100, '\0');
+			for (auto & c : data) c = static_cast<char>(rng());
+
+			std::string b32 = Fs2a::base32encode<char, Fs2a::Base32Unpadded>(data.data(), data.size());
+			CPPUNIT_ASSERT_EQUAL(Fs2a::Base32Codec<Fs2a::Base32Unpadded>::encodedLength(data.size()), b32.size());
+			std::vector<char> v = Fs2a::base32decode<char, Fs2a::Base32Unpadded>(b32);
+			CPPUNIT_ASSERT_EQUAL(data, std::string(v.begin(), v.end()));
+		}
+	}
+
+};
+
+#undef CHECKNAME
@@ -0,0 +1,399 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/Base64.hpp>
+
+#define CHECKNAME base64Check
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(roundtrip);
+	CPPUNIT_TEST(streamingEncode);
+	CPPUNIT_TEST(streamingDecode);
+	CPPUNIT_TEST(streams);
+	CPPUNIT_TEST(policies);
+	CPPUNIT_TEST(strictness);
+	CPPUNIT_TEST(spans);
+	CPPUNIT_TEST(parallel);
+	CPPUNIT_TEST(equivalence);
+	CPPUNIT_TEST_SUITE_END();
+
+	/** Straightforward reference decoder following the policy rules one
+	 * character at a time, for cross-checking the table driven kernels.
+	 * @returns Decoded data, or "!" followed by nothing when invalid. */
+	template <typename P>
+	static std::string refDecode_(const std::string & b64_i)
+	{
+		std::string out;
+		uint32_t q = 0;
+		int off = 0, pads = 0;
+		bool padded = false;
+
+		auto partial = [&]() {
+			if (off == 2) out.push_back(static_cast<char>(q >> 4));
+			if (off == 3) {
+				out.push_back(static_cast<char>(q >> 10));
+				out.push_back(static_cast<char>(q >> 2));
+			}
+		};
+
+		for (char c : b64_i) {
+			bool skippable = ((c == '\r' || c == '\n') && P::skipNewlines) || (c == '\\' && P::skipBackslash);
+			if (padded) {
+				if (!P::strict) break;
+				if (c == '=' && pads) pads--;
+				else if (!skippable) return "!";
+				continue;
+			}
+			const char * p = c ? strchr(P::alphabet, c) : nullptr;
+			if (p) {
+				q = (q << 6) | static_cast<uint32_t>(p - P::alphabet);
+				if (++off == 4) {
+					out.push_back(static_cast<char>(q >> 16));
+					out.push_back(static_cast<char>(q >> 8));
+					out.push_back(static_cast<char>(q));
+					off = 0;
+				}
+			} else if (skippable) {
+				continue;
+			} else if (c == '=' && P::padding) {
+				if (off < 2) return "!";
+				pads = 3 - off;
+				partial();
+				off = 0;
+				padded = true;
+			} else {
+				return "!";
+			}
+		}
+		if (P::strict && (pads || (P::padding && off) || off == 1)) return "!";
+		partial();
+		return out;
+	}
+
+	/** Decode with every kernel and compare with the reference decoder.
+	 * @returns True when all kernels agree. */
+	template <typename P>
+	static bool crossCheck_(const std::string & b64_i, std::mt19937 & rng_io)
+	{
+		const std::string ref = refDecode_<P>(b64_i);
+		std::string out;
+
+		// One-shot decoding
+		try {
+			std::vector<char> v = Fs2a::base64decode<char, P>(b64_i);
+			out.assign(v.begin(), v.end());
+		} catch (const std::runtime_error &) { out = "!"; }
+		if (out != ref) return false;
+
+		// Streaming in randomly sized chunks
+		out.clear();
+		try {
+			Fs2a::Base64Decoder<P> dec([&out](const char * d_i, const size_t l_i) { out.append(d_i, l_i); });
+			for (size_t i = 0, n = 0; i < b64_i.size(); i += n) {
+				n = std::min<size_t>(1 + rng_io() % 9, b64_i.size() - i);
+				dec.update(b64_i.data() + i, n);
+			}
+			dec.finish();
+		} catch (const std::runtime_error &) { out = "!"; }
+		if (out != ref) return false;
+
+		// Parallel decoding, only for inputs large enough to be split
+		if (b64_i.size() >= 2 * Fs2a::base64ParallelMinimum) {
+			out.assign(Fs2a::Base64Codec<P>::decodedLength(b64_i.size()), '\0');
+			try {
+				out.resize(Fs2a::base64decodeParallel<P>(b64_i, std::as_writable_bytes(std::span(out)), 3));
+			} catch (const std::runtime_error &) { out = "!"; }
+			if (out != ref) return false;
+		}
+
+		return true;
+	}
+
+	/** Fuzz all kernels of a policy with random and mutated inputs.
+	 * @returns Number of mismatches */
+	template <typename P>
+	static size_t fuzz_(std::mt19937 & rng_io, const size_t iterations_i, const size_t maxlen_i)
+	{
+		using namespace std::string_literals;
+		const std::string junk = "=\r\n\\*-_+/ \0\x80"s + P::alphabet;
+		size_t bad = 0;
+
+		for (size_t it = 0; it < iterations_i; it++) {
+			std::string data(rng_io() % maxlen_i, '\0');
+			for (auto & c : data) c = static_cast<char>(rng_io());
+
+			std::string b64 = Fs2a::base64encode<char, P>(data.data(), data.size());
+			if (refDecode_<P>(b64) != data) bad++;
+
+			// Insert, replace or truncate at random places
+			switch (rng_io() % 4) {
+				case 0:
+					break;
+
+				case 1:
+					for (size_t m = rng_io() % 4; m; m--) {
+						b64.insert(b64.begin() + rng_io() % (b64.size() + 1), junk[rng_io() % junk.size()]);
+					}
+					break;
+
+				case 2:
+					if (!b64.empty()) b64[rng_io() % b64.size()] = junk[rng_io() % junk.size()];
+					break;
+
+				case 3:
+					b64.resize(rng_io() % (b64.size() + 1));
+					break;
+			}
+			if (!crossCheck_<P>(b64, rng_io)) bad++;
+		}
+
+		return bad;
+	}
+
+	public:
+
+	void roundtrip() {
+		using namespace std::string_literals;
+
+		CPPUNIT_ASSERT_EQUAL(""s, Fs2a::base64encode<char>("", 0));
+		CPPUNIT_ASSERT_EQUAL("Zg=="s, Fs2a::base64encode<char>("f", 1));
+		CPPUNIT_ASSERT_EQUAL("Zm8="s, Fs2a::base64encode<char>("fo", 2));
+		CPPUNIT_ASSERT_EQUAL("Zm9v"s, Fs2a::base64encode<char>("foo", 3));
+		CPPUNIT_ASSERT_EQUAL("Zm9vYmFy"s, Fs2a::base64encode<char>("foobar", 6));
+
+		std::vector<char> d = Fs2a::base64decode<char>("Zm9v\r\nYmE=");
+		CPPUNIT_ASSERT_EQUAL("fooba"s, std::string(d.begin(), d.end()));
+		CPPUNIT_ASSERT_THROW(Fs2a::base64decode<char>("Z==="), std::runtime_error);
+		CPPUNIT_ASSERT_THROW(Fs2a::base64decode<char>("Zm9v*"), std::runtime_error);
+	}
+
+	void streamingEncode() {
+		std::string data, out;
+
+		for (size_t i = 0; i < 10000; i++) data.push_back(static_cast<char>(i * 7 + i / 13));
+		const std::string ref = Fs2a::base64encode<char>(data.data(), data.size());
+
+		// Every chunk size should give the same result as encoding at once
+		for (size_t chunk : {1, 2, 3, 4, 5, 7, 64, 4095, 4096, 9999}) {
+			out.clear();
+			Fs2a::Base64Encoder enc([&out](const char * d_i, const size_t l_i) { out.append(d_i, l_i); });
+			for (size_t i = 0; i < data.size(); i += chunk) {
+				enc.update(data.data() + i, std::min(chunk, data.size() - i));
+			}
+			enc.finish();
+			CPPUNIT_ASSERT_EQUAL(ref, out);
+			CPPUNIT_ASSERT_THROW(enc.update("x", 1), std::logic_error);
+		}
+	}
+
+	void streamingDecode() {
+		using namespace std::string_literals;
+		std::string data, out;
+
+		for (size_t i = 0; i < 10000; i++) data.push_back(static_cast<char>(i * 11 + i / 7));
+		std::string b64 = Fs2a::base64encode<char>(data.data(), data.size());
+		// Sprinkle some skippable characters
+		for (size_t i = 76; i < b64.size(); i += 78) b64.insert(i, "\r\n");
+
+		for (size_t chunk : {1, 2, 3, 4, 5, 77, 3072, 20000}) {
+			out.clear();
+			Fs2a::Base64Decoder dec([&out](const char * d_i, const size_t l_i) { out.append(d_i, l_i); });
+			for (size_t i = 0; i < b64.size(); i += chunk) {
+				dec.update(b64.data() + i, std::min(chunk, b64.size() - i));
+			}
+			dec.finish();
+			CPPUNIT_ASSERT_EQUAL(data, out);
+		}
+
+		// Unpadded input and padding split over chunks
+		out.clear();
+		Fs2a::Base64Decoder dec([&out](const char * d_i, const size_t l_i) { out.append(d_i, l_i); });
+		dec.update("Zm9vYm", 6);
+		dec.update("E", 1);
+		dec.update("=garbage", 8);
+		dec.finish();
+		CPPUNIT_ASSERT_EQUAL("fooba"s, out);
+
+		// Error positions are counted over all chunks
+		Fs2a::Base64Decoder<> bad([](const char *, const size_t) {});
+		bad.update("Zm9v", 4);
+		try {
+			bad.update("Y*", 2);
+			CPPUNIT_ASSERT(false);
+		} catch (const std::runtime_error & e) {
+			CPPUNIT_ASSERT(std::string(e.what()).find("position 5") != std::string::npos);
+		}
+	}
+
+	void streams() {
+		std::string data;
+
+		for (size_t i = 0; i < 100000; i++) data.push_back(static_cast<char>(i ^ (i >> 8)));
+
+		std::istringstream raw(data);
+		std::ostringstream enc;
+		CPPUNIT_ASSERT_EQUAL(data.size(), Fs2a::base64encode(raw, enc));
+		CPPUNIT_ASSERT_EQUAL(Fs2a::base64encode<char>(data.data(), data.size()), enc.str());
+
+		std::istringstream b64(enc.str());
+		std::ostringstream dec;
+		CPPUNIT_ASSERT_EQUAL(enc.str().size(), Fs2a::base64decode(b64, dec));
+		CPPUNIT_ASSERT_EQUAL(data, dec.str());
+	}
+
+	void policies() {
+		using namespace std::string_literals;
+		typedef Fs2a::Base64Codec<Fs2a::Base64Url> url;
+
+		// Tables are generated at compile time
+		static_assert(url::dec['-'] == 62 && url::dec['_'] == 63);
+		static_assert(url::dec['+'] == url::invalid && url::dec['='] == url::invalid);
+		static_assert(Fs2a::Base64Codec<Fs2a::Base64Lenient>::dec['\n'] == url::skip);
+
+		const std::string d = "\xfb\xff\xbf?";
+		CPPUNIT_ASSERT_EQUAL("+/+/Pw=="s, Fs2a::base64encode<char>(d.data(), d.size()));
+		CPPUNIT_ASSERT_EQUAL("-_-_Pw"s, (Fs2a::base64encode<char, Fs2a::Base64Url>(d.data(), d.size())));
+		CPPUNIT_ASSERT_EQUAL("+/+/Pw"s, (Fs2a::base64encode<char, Fs2a::Base64Unpadded>(d.data(), d.size())));
+
+		std::vector<char> v = Fs2a::base64decode<char, Fs2a::Base64Url>("-_-_Pw");
+		CPPUNIT_ASSERT_EQUAL(d, std::string(v.begin(), v.end()));
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, Fs2a::Base64Url>("+/+/Pw")), std::runtime_error);
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, Fs2a::Base64Url>("-_-_Pw==")), std::runtime_error);
+
+		// Streaming with a policy
+		std::string out;
+		Fs2a::Base64Encoder<Fs2a::Base64Url> enc([&out](const char * d_i, const size_t l_i) { out.append(d_i, l_i); });
+		enc.update(d.data(), 1);
+		enc.update(d.data() + 1, 3);
+		enc.finish();
+		CPPUNIT_ASSERT_EQUAL("-_-_Pw"s, out);
+	}
+
+	void strictness() {
+		typedef Fs2a::Base64Strict S;
+
+		CPPUNIT_ASSERT_NO_THROW((Fs2a::base64decode<char, S>("Zm9vYg==")));
+		// Missing or incomplete padding
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, S>("Zm9vYg")), std::runtime_error);
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, S>("Zm9vYg=")), std::runtime_error);
+		// Data after padding, which the lenient policy ignores
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, S>("Zm9vYg==Zm9v")), std::runtime_error);
+		CPPUNIT_ASSERT_NO_THROW(Fs2a::base64decode<char>("Zm9vYg==Zm9v"));
+		// No skipping of newlines or backslashes
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, S>("Zm9v\nYmFy")), std::runtime_error);
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, S>("Zm9v\\YmFy")), std::runtime_error);
+		// Dangling character in unpadded data
+		CPPUNIT_ASSERT_THROW((Fs2a::base64decode<char, Fs2a::Base64Unpadded>("Zm9vY")), std::runtime_error);
+	}
+
+	void spans() {
+		using namespace std::string_literals;
+		char enc[8];
+		std::byte dec[6];
+		const std::string d = "foob";
+
+		size_t n = Fs2a::base64encode(std::as_bytes(std::span(d)), std::span<char>(enc));
+		CPPUNIT_ASSERT_EQUAL("Zm9vYg=="s, std::string(enc, n));
+		CPPUNIT_ASSERT_THROW(Fs2a::base64encode(std::as_bytes(std::span(d)), std::span<char>(enc, 7)), std::length_error);
+
+		n = Fs2a::base64decode(std::string_view(enc, 8), std::span<std::byte>(dec));
+		CPPUNIT_ASSERT_EQUAL(d, std::string(reinterpret_cast<const char *>(dec), n));
+		CPPUNIT_ASSERT_THROW(Fs2a::base64decode(std::string_view(enc, 8), std::span<std::byte>(dec, 5)), std::length_error);
+	}
+
+	void parallel() {
+		typedef Fs2a::Base64Codec<Fs2a::Base64Lenient> C;
+		std::string data(4 * Fs2a::base64ParallelMinimum + 2, '\0');
+
+		for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<char>(i * 13 + i / 251);
+		const std::string ref = Fs2a::base64encode<char>(data.data(), data.size());
+
+		std::string enc(C::encodedLength(data.size()), '\0');
+		CPPUNIT_ASSERT_EQUAL(ref.size(),
+			Fs2a::base64encodeParallel(std::as_bytes(std::span(data)), std::span<char>(enc), 4));
+		CPPUNIT_ASSERT_EQUAL(ref, enc);
+
+		// Line breaks shift the quads against the part boundaries
+		std::string wrapped;
+		for (size_t i = 0; i < ref.size(); i += 76) wrapped += ref.substr(i, 76) + "\r\n";
+		std::string dec(C::decodedLength(wrapped.size()), '\0');
+		size_t n = Fs2a::base64decodeParallel(wrapped, std::as_writable_bytes(std::span(dec)), 4);
+		CPPUNIT_ASSERT_EQUAL(data, dec.substr(0, n));
+
+		// Errors are found at the same position as the serial decoder does
+		wrapped[wrapped.size() / 3] = '*';
+		try {
+			Fs2a::base64decodeParallel(wrapped, std::as_writable_bytes(std::span(dec)), 4);
+			CPPUNIT_ASSERT(false);
+		} catch (const std::runtime_error & e) {
+			CPPUNIT_ASSERT(std::string(e.what()).find(std::to_string(wrapped.size() / 3)) != std::string::npos);
+		}
+	}
+
+	void equivalence() {
+		std::mt19937 rng(20261019);
+		const std::vector<std::string> edges = {
+			"", "=", "==", "A", "A=", "AA", "AA=", "AA==", "AAA", "AAA=", "AAA==", "AAAA=",
+			"AA==AA", "A===", "AA=\n=", "AAAA\\", "\r\n", "AA\r\n=="
+		};
+
+		for (const auto & e : edges) {
+			CPPUNIT_ASSERT_MESSAGE(e, crossCheck_<Fs2a::Base64Lenient>(e, rng));
+			CPPUNIT_ASSERT_MESSAGE(e, crossCheck_<Fs2a::Base64Strict>(e, rng));
+			CPPUNIT_ASSERT_MESSAGE(e, crossCheck_<Fs2a::Base64Unpadded>(e, rng));
+			CPPUNIT_ASSERT_MESSAGE(e, crossCheck_<Fs2a::Base64Url>(e, rng));
+		}
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), fuzz_<Fs2a::Base64Lenient>(rng, 5000, 64));
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), fuzz_<Fs2a::Base64Strict>(rng, 5000, 64));
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), fuzz_<Fs2a::Base64Unpadded>(rng, 5000, 64));
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), fuzz_<Fs2a::Base64Url>(rng, 5000, 64));
+
+		// A few large inputs to also exercise the parallel decoder
+		const size_t large = 3 * Fs2a::base64ParallelMinimum;
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), fuzz_<Fs2a::Base64Lenient>(rng, 4, large));
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), fuzz_<Fs2a::Base64Url>(rng, 4, large));
+	}
+
+};
+
+#undef CHECKNAME
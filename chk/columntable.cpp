@@ -0,0 +1,254 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/ColumnTable.hpp>
+#include <fs2a/readCSV.hpp>
+
+#define CHECKNAME columntableCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(columns);
+	CPPUNIT_TEST(values);
+	CPPUNIT_TEST(conversion);
+	CPPUNIT_TEST(errors);
+	CPPUNIT_TEST(inference);
+	CPPUNIT_TEST(csv);
+	CPPUNIT_TEST(memory);
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+
+	void columns() {
+		Fs2a::ColumnTable t;
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(0), t.columns());
+		CPPUNIT_ASSERT_EQUAL(size_t(0), t.rows());
+
+		t.addColumn("id", Fs2a::ColumnTable::integer).append(1);
+		CPPUNIT_ASSERT_EQUAL(size_t(1), t.rows());
+		CPPUNIT_ASSERT_THROW(t.addColumn("id", Fs2a::ColumnTable::text), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(t.addColumn("", Fs2a::ColumnTable::text), std::invalid_argument);
+
+		// A late column gets missing values for existing rows
+		Fs2a::ColumnTable::Column & c = t.addColumn("name", Fs2a::ColumnTable::text);
+		CPPUNIT_ASSERT_EQUAL(size_t(1), c.size());
+		CPPUNIT_ASSERT(!c.valid(0));
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(2), t.columns());
+		CPPUNIT_ASSERT_EQUAL(std::string("name"), t.column(1).name());
+		CPPUNIT_ASSERT_THROW(t.column("nope"), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(t.column(2), std::out_of_range);
+	}
+
+	void values() {
+		using namespace std::string_literals;
+		Fs2a::ColumnTable t;
+
+		Fs2a::ColumnTable::Column & c = t.addColumn("currency", Fs2a::ColumnTable::text);
+		for (const char * v : { "EUR", "USD", "EUR", "", "EUR" }) c.append(v);
+		CPPUNIT_ASSERT_EQUAL(size_t(2), c.dictionary().size());
+		CPPUNIT_ASSERT_EQUAL(size_t(1), c.nulls());
+		CPPUNIT_ASSERT_EQUAL("USD"s, c.text(1));
+		CPPUNIT_ASSERT_EQUAL(""s, c.text(3));
+		CPPUNIT_ASSERT_EQUAL(0U, c.dict().code(4));
+		CPPUNIT_ASSERT_EQUAL(size_t(1), c.dict().width());
+		CPPUNIT_ASSERT_THROW(c.values<int64_t>(), std::logic_error);
+		CPPUNIT_ASSERT_THROW(c.append(1.5), std::logic_error);
+		CPPUNIT_ASSERT_THROW(c.text(5), std::out_of_range);
+
+		// Spread over more than one validity word
+		Fs2a::ColumnTable::Column & n = t.addColumn("amount", Fs2a::ColumnTable::integer);
+		for (int64_t i = 0; i < 200; i++) {
+			if (i % 3) n.append(i);
+			else n.appendNull();
+		}
+		CPPUNIT_ASSERT_EQUAL(size_t(205), n.size());
+		CPPUNIT_ASSERT_EQUAL(size_t(5 + 67), n.nulls());
+		CPPUNIT_ASSERT(n.valid(6));
+		CPPUNIT_ASSERT(!n.valid(5));
+		CPPUNIT_ASSERT(!n.valid(205));
+		auto v = n.values<int64_t>();
+		// Missing values are zero, so they don't disturb a sum
+		int64_t sum = std::accumulate(v.begin(), v.end(), int64_t(0));
+		int64_t expect = 0;
+		for (int64_t i = 0; i < 200; i++) if (i % 3) expect += i;
+		CPPUNIT_ASSERT_EQUAL(expect, sum);
+
+		Fs2a::ColumnTable::Column & d = t.addColumn("booked", Fs2a::ColumnTable::date);
+		d.append("2024-02-29");
+		CPPUNIT_ASSERT_EQUAL("2024-02-29"s, d.str(5));
+		CPPUNIT_ASSERT_THROW(d.append("2023-02-29"), std::invalid_argument);
+	}
+
+	void conversion() {
+		using namespace std::string_literals;
+		std::stringstream sss;
+
+		sss << "id;amount;booked;status\n1;12.5;2024-01-31;open\n2;;2024-02-01;closed\n3;-0.25;;open\n";
+		Fs2a::ColumnTable t = Fs2a::ColumnTable::fromTable(Fs2a::readCSV(sss, ';'), {
+			Fs2a::ColumnTable::integer, Fs2a::ColumnTable::decimal, Fs2a::ColumnTable::date, Fs2a::ColumnTable::text
+		});
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(4), t.columns());
+		CPPUNIT_ASSERT_EQUAL(size_t(3), t.rows());
+		CPPUNIT_ASSERT_EQUAL(int64_t(3), t.column("id").values<int64_t>()[2]);
+		CPPUNIT_ASSERT_EQUAL(-0.25, t.column("amount").values<double>()[2]);
+		CPPUNIT_ASSERT(!t.column("amount").valid(1));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(2), t.column("booked").values<Fs2a::NaiveDate>()[1].month());
+		CPPUNIT_ASSERT_EQUAL(size_t(2), t.column("status").dictionary().size());
+
+		// And back again
+		Fs2a::HeaderedTable h = t.toTable();
+		CPPUNIT_ASSERT_EQUAL(4U, h.rows());
+		CPPUNIT_ASSERT_EQUAL("12.5"s, h.cell("amount", 1));
+		CPPUNIT_ASSERT_EQUAL(""s, h.cell("amount", 2));
+		CPPUNIT_ASSERT_EQUAL("2024-02-01"s, h.cell("booked", 2));
+		CPPUNIT_ASSERT_EQUAL("closed"s, h.cell("status", 2));
+
+		// Repeated header names are made unique, like HeaderedTable does
+		std::stringstream dss("id;id;name\n1;2;x\n");
+		Fs2a::ColumnTable d = Fs2a::ColumnTable::fromTable(Fs2a::readCSV(dss, ';'), {
+			Fs2a::ColumnTable::integer, Fs2a::ColumnTable::integer, Fs2a::ColumnTable::text
+		});
+		CPPUNIT_ASSERT_EQUAL(int64_t(2), d.column("id_0").values<int64_t>()[0]);
+		CPPUNIT_ASSERT_EQUAL(int64_t(1), d.column("id").values<int64_t>()[0]);
+	}
+
+	void errors() {
+		std::stringstream sss;
+
+		sss << "id;amount\n1;2\nx;3\n";
+		Fs2a::Table<std::string> s = Fs2a::readCSV(sss, ';');
+		CPPUNIT_ASSERT_THROW(Fs2a::ColumnTable::fromTable(s, { Fs2a::ColumnTable::integer }), std::invalid_argument);
+		try {
+			Fs2a::ColumnTable::fromTable(s, { Fs2a::ColumnTable::integer, Fs2a::ColumnTable::integer });
+			CPPUNIT_ASSERT(false);
+		} catch (const std::invalid_argument & e) {
+			CPPUNIT_ASSERT(std::string(e.what()).find("Unable to convert \"x\" at row 2 to integer for column \"id\"") != std::string::npos);
+		}
+	}
+
+	void inference() {
+		using namespace std::string_literals;
+		using T = Fs2a::ColumnTable;
+		std::stringstream sss;
+
+		sss << "id;amount;booked;at;paid;status;empty;mixed\n"
+			<< "1;12.5;2024-01-31;9:05;true;open;;1\n"
+			<< "2;;2024-02-01;17:30;FALSE;closed;;2024-01-01\n"
+			<< "3;-1;;00:00;;open;;x\n";
+		Fs2a::Table<std::string> s = Fs2a::readCSV(sss, ';');
+		CPPUNIT_ASSERT(T::inferTypes(s) == std::vector<T::type_e>({ T::integer, T::decimal, T::date, T::time,
+			T::boolean, T::text, T::text, T::text }));
+
+		std::vector<T::conversionError_t> errors;
+		T t = T::infer(s, errors);
+		CPPUNIT_ASSERT(errors.empty());
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(17), t.column("at").values<Fs2a::NaiveTime>()[1].hour());
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(1), t.column("paid").values<uint8_t>()[0]);
+		CPPUNIT_ASSERT_EQUAL("09:05"s, t.column("at").str(0));
+		CPPUNIT_ASSERT_EQUAL("false"s, t.column("paid").str(1));
+		CPPUNIT_ASSERT(!t.column("paid").valid(2));
+
+		// Values beyond the sample that don't convert are reported and become missing
+		sss.clear();
+		sss.str("n;d\n1;2024-01-01\n2;2024-13-01\n3;2024-01-02\n4.5;2024-01-03\n");
+		s = Fs2a::readCSV(sss, ';');
+		t = T::infer(s, errors, 2);
+		CPPUNIT_ASSERT_EQUAL(size_t(2), errors.size());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(1), errors[0].column);
+		CPPUNIT_ASSERT_EQUAL(2U, errors[0].row);
+		CPPUNIT_ASSERT_EQUAL("4.5"s, errors[1].value);
+		CPPUNIT_ASSERT(!t.column("n").valid(3));
+		CPPUNIT_ASSERT_EQUAL(size_t(4), t.rows());
+		CPPUNIT_ASSERT(T::inferTypes(s, 0)[0] == T::decimal);
+
+		// Numbers with leading zeros, nan and inf stay text
+		sss.clear();
+		sss.str("zip;account;special;small;fraction\n0123;-007;nan;0;0.5\n0456;12;inf;-0;-0.25\n");
+		s = Fs2a::readCSV(sss, ';');
+		CPPUNIT_ASSERT(T::inferTypes(s) == std::vector<T::type_e>({ T::text, T::text, T::text, T::integer,
+			T::decimal }));
+		errors.clear();
+		t = T::infer(s, errors);
+		CPPUNIT_ASSERT(errors.empty());
+		CPPUNIT_ASSERT_EQUAL("0123"s, t.column("zip").str(0));
+	}
+
+	void csv() {
+		using namespace std::string_literals;
+		std::stringstream sss("cur;status;cur\nEUR;open;x\nUSD;;y\nEUR;closed\nEUR;open;z\n");
+		Fs2a::ColumnTable t;
+		Fs2a::readCSV(sss, t, ';');
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(3), t.columns());
+		CPPUNIT_ASSERT_EQUAL(size_t(4), t.rows());
+		CPPUNIT_ASSERT_EQUAL("cur_0"s, t.column(2).name());
+		CPPUNIT_ASSERT_EQUAL(size_t(2), t.column("cur").dictionary().size());
+		CPPUNIT_ASSERT_EQUAL(t.column("cur").dict().code(0), t.column("cur").dict().code(3));
+		CPPUNIT_ASSERT(!t.column("status").valid(1));
+		CPPUNIT_ASSERT_EQUAL("closed"s, t.column("status").text(2));
+
+		// A short row leaves missing values, which don't shift the rows after it
+		CPPUNIT_ASSERT(!t.column("cur_0").valid(2));
+		CPPUNIT_ASSERT_EQUAL("z"s, t.column("cur_0").text(3));
+
+		std::stringstream again("a\n1\n");
+		CPPUNIT_ASSERT_THROW(Fs2a::readCSV(again, t, ';'), std::invalid_argument);
+	}
+
+	void memory() {
+		Fs2a::HeaderedTable h;
+		h.columns(2);
+		h.emplaceRow("status", "note");
+		for (int i = 0; i < 1000; i++) h.emplaceRow(i % 3 ? "open and waiting for payment" : "closed", "");
+
+		// Dictionary encoding stores every distinct status once, with a byte per row
+		Fs2a::ColumnTable t = Fs2a::ColumnTable::encode(h);
+		CPPUNIT_ASSERT_EQUAL(Fs2a::ColumnTable::text, t.column("note").type());
+		CPPUNIT_ASSERT_EQUAL(size_t(1), t.column("status").dict().width());
+		CPPUNIT_ASSERT_EQUAL(size_t(1000), t.column("note").nulls());
+		const size_t used = t.memoryUsage();
+		CPPUNIT_ASSERT(used < h.memoryUsage() / 4);
+		CPPUNIT_ASSERT(t.compact() <= used);
+	}
+
+};
+
+#undef CHECKNAME
@@ -0,0 +1,119 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/CsvScan.hpp>
+
+#define CHECKNAME csvscanCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(classify);
+	CPPUNIT_TEST(kernels);
+	CPPUNIT_TEST(prefixXor);
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+
+	void classify() {
+		const std::string csv = "a;\"b;c\"\r\nd\n";
+		Fs2a::CsvScan::masks_t m;
+
+		Fs2a::CsvScan::classify(csv.data(), csv.size(), ';', &m, Fs2a::CsvScan::scalar);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0x44), m.quote);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0x12), m.separator);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0x80), m.cr);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0x500), m.lf);
+
+		// Padding of the last block doesn't match a NUL separator
+		Fs2a::CsvScan::classify(csv.data(), csv.size(), '\0', &m);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0), m.separator);
+		CPPUNIT_ASSERT_EQUAL(size_t(2), Fs2a::CsvScan::blocks(65));
+	}
+
+	void kernels() {
+		std::mt19937 rng(47);
+		const Fs2a::CsvScan::kernel_e ks[] = { Fs2a::CsvScan::scalar, Fs2a::CsvScan::sse2, Fs2a::CsvScan::avx2 };
+		const char chars[] = "ab;,\"\r\n\t";
+
+		// Every supported kernel should match the scalar one, also on partial blocks and with
+		// a quote or line ending as separator
+		for (size_t it = 0; it < 2000; it++) {
+			std::string data(rng() % 300, '\0');
+			for (auto & c : data) c = rng() % 4 ? chars[rng() % 8] : static_cast<char>(rng());
+			const char sep = chars[rng() % 8];
+			std::vector<Fs2a::CsvScan::masks_t> ref(Fs2a::CsvScan::blocks(data.size()));
+			Fs2a::CsvScan::classify(data.data(), data.size(), sep, ref.data(), Fs2a::CsvScan::scalar);
+
+			for (auto k : ks) {
+				if (!Fs2a::CsvScan::supported(k)) continue;
+				std::vector<Fs2a::CsvScan::masks_t> m(ref.size());
+				Fs2a::CsvScan::classify(data.data(), data.size(), sep, m.data(), k);
+				for (size_t b = 0; b < ref.size(); b++) {
+					CPPUNIT_ASSERT_EQUAL(ref[b].quote, m[b].quote);
+					CPPUNIT_ASSERT_EQUAL(ref[b].separator, m[b].separator);
+					CPPUNIT_ASSERT_EQUAL(ref[b].cr, m[b].cr);
+					CPPUNIT_ASSERT_EQUAL(ref[b].lf, m[b].lf);
+				}
+			}
+		}
+	}
+
+	void prefixXor() {
+		std::mt19937_64 rng(47);
+		const Fs2a::CsvScan::kernel_e ks[] = { Fs2a::CsvScan::scalar, Fs2a::CsvScan::sse2, Fs2a::CsvScan::avx2 };
+
+		// Quotes at 1 and 4 mark bytes 1 up to 3 as quoted
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0x0E), Fs2a::CsvScan::prefixXor(0x12));
+
+		for (size_t it = 0; it < 1000; it++) {
+			const uint64_t bits = rng();
+			uint64_t expect = 0, x = 0;
+			for (unsigned i = 0; i < 64; i++) {
+				x ^= (bits >> i) & 1;
+				expect |= x << i;
+			}
+			for (auto k : ks) {
+				if (Fs2a::CsvScan::supported(k)) CPPUNIT_ASSERT_EQUAL(expect, Fs2a::CsvScan::prefixXor(bits, k));
+			}
+		}
+	}
+
+};
+
+#undef CHECKNAME
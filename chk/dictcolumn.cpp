@@ -0,0 +1,104 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <sstream>
+#include <string>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/DictColumn.hpp>
+#include <fs2a/readCSV.hpp>
+
+#define CHECKNAME dictcolumnCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(encode);
+	CPPUNIT_TEST(widen);
+	CPPUNIT_TEST(table);
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+
+	void encode() {
+		Fs2a::DictColumn d;
+		CPPUNIT_ASSERT_EQUAL(0U, d.append("EUR"));
+		CPPUNIT_ASSERT_EQUAL(1U, d.append("USD"));
+		CPPUNIT_ASSERT_EQUAL(0U, d.append("EUR"));
+		CPPUNIT_ASSERT_EQUAL(2U, d.append(""));
+		CPPUNIT_ASSERT_EQUAL(size_t(4), d.size());
+		CPPUNIT_ASSERT_EQUAL(size_t(3), d.cardinality());
+		CPPUNIT_ASSERT_EQUAL(size_t(1), d.width());
+		CPPUNIT_ASSERT_EQUAL(std::string("USD"), d[1]);
+
+		uint32_t code = 9;
+		CPPUNIT_ASSERT(d.find("USD", code));
+		CPPUNIT_ASSERT_EQUAL(1U, code);
+		CPPUNIT_ASSERT(!d.find("GBP", code));
+
+		// A copy has its own lookup
+		Fs2a::DictColumn c(d);
+		d = Fs2a::DictColumn();
+		CPPUNIT_ASSERT_EQUAL(1U, c.append("USD"));
+		CPPUNIT_ASSERT_EQUAL(3U, c.append("GBP"));
+		CPPUNIT_ASSERT_EQUAL(size_t(0), d.size());
+	}
+
+	void widen() {
+		Fs2a::DictColumn d;
+		for (uint32_t i = 0; i < 256; i++) d.append(std::to_string(i));
+		CPPUNIT_ASSERT_EQUAL(size_t(1), d.width());
+		d.append("256");
+		CPPUNIT_ASSERT_EQUAL(size_t(2), d.width());
+		for (uint32_t i = 257; i < 65537; i++) d.append(std::to_string(i));
+		CPPUNIT_ASSERT_EQUAL(size_t(4), d.width());
+
+		// Codes survive widening
+		CPPUNIT_ASSERT_EQUAL(255U, d.code(255));
+		CPPUNIT_ASSERT_EQUAL(std::string("65536"), d[65536]);
+		CPPUNIT_ASSERT_EQUAL(size_t(65537), d.visit([](const auto & c_i) { return c_i.size(); }));
+	}
+
+	void table() {
+		std::stringstream sss("id;cur\n1;EUR\n2;USD\n3;EUR\n");
+		Fs2a::HeaderedTable t = Fs2a::readCSV(sss, ';');
+		Fs2a::DictColumn d(t, "cur");
+		CPPUNIT_ASSERT_EQUAL(size_t(3), d.size());
+		CPPUNIT_ASSERT_EQUAL(size_t(2), d.cardinality());
+		CPPUNIT_ASSERT_EQUAL(d.code(0), d.code(2));
+		CPPUNIT_ASSERT_THROW(Fs2a::DictColumn(t, "nope"), std::invalid_argument);
+	}
+
+};
+
+#undef CHECKNAME
@@ -0,0 +1,209 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/HeaderedTable.hpp>
+#include <fs2a/readCSV.hpp>
+
+#define CHECKNAME headeredtableCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(cells);
+	CPPUNIT_TEST(headers);
+	CPPUNIT_TEST(wide);
+	CPPUNIT_TEST(column);
+	CPPUNIT_TEST(index);
+	CPPUNIT_TEST(indexUpdates);
+	CPPUNIT_TEST(sort);
+	CPPUNIT_TEST(parallelSort);
+	CPPUNIT_TEST_SUITE_END();
+
+	Fs2a::HeaderedTable load_(const std::string & csv_i) {
+		std::stringstream sss(csv_i);
+		return Fs2a::readCSV(sss, ';');
+	}
+
+	public:
+
+	void cells() {
+		using namespace std::string_literals;
+		Fs2a::HeaderedTable t = load_("id;id;name\n1;2;x\n");
+
+		CPPUNIT_ASSERT_EQUAL("2"s, t.cell("id_0", 1));
+		CPPUNIT_ASSERT_THROW(t.cell("nope", 1), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(t.cell("", 1), std::invalid_argument);
+		t.cell("name", 3) = "y";
+		CPPUNIT_ASSERT_EQUAL(4U, t.rows());
+	}
+
+	void headers() {
+		std::vector<std::string> names = { "a", "a", "a_0", "", "b", "a", "", "a_0" };
+		Fs2a::HeaderedTable::uniqueHeaders(names);
+		CPPUNIT_ASSERT(names == std::vector<std::string>({ "a", "a_1", "a_0", "", "b", "a_2", "_0", "a_0_0" }));
+	}
+
+	void wide() {
+		// As wide as the column index type allows, nearly all names duplicates
+		const size_t cols = std::min<size_t>(Fs2a::maxColumns, 70000);
+		std::string csv;
+		for (size_t c = 0; c < cols; c++) csv += (c ? ";x" : "x") + std::to_string(c % 7);
+		Fs2a::HeaderedTable t = load_(csv + "\n");
+
+		CPPUNIT_ASSERT_EQUAL(cols, static_cast<size_t>(t.columns()));
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(3), t.columnIndex("x3"));
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(10), t.columnIndex("x3_0"));
+		const Fs2a::colidx_t last = static_cast<Fs2a::colidx_t>(cols - 1);
+		CPPUNIT_ASSERT_EQUAL(last, t.columnIndex(t(last, 0)));
+	}
+
+	void column() {
+		Fs2a::HeaderedTable t;
+		t.columns(2);
+		t.emplaceRow("name", "amount");
+		t.emplaceRow("b", "3");
+		t.emplaceRow("a", "12");
+		t.emplaceRow("c", "7");
+
+		// Without the header
+		Fs2a::StridedRange<std::string> c = t.column("amount");
+		CPPUNIT_ASSERT_EQUAL(size_t(3), c.size());
+		CPPUNIT_ASSERT_EQUAL(std::string("3"), c.front());
+		auto m = std::ranges::max_element(c, {}, [](const std::string & v_i) { return std::stoi(v_i); });
+		CPPUNIT_ASSERT_EQUAL(std::ptrdiff_t(1), m - c.begin());
+		std::ranges::sort(t.column("name"));
+		CPPUNIT_ASSERT_EQUAL(std::string("a"), t.cell("name", 1));
+		CPPUNIT_ASSERT_EQUAL(std::string("name"), t.cell(0, 0));
+		CPPUNIT_ASSERT_THROW(t.column("nope"), std::invalid_argument);
+	}
+
+	void index() {
+		using namespace std::string_literals;
+		Fs2a::HeaderedTable t = load_("id;cur;amount\na;EUR;1\nb;USD;2\nc;EUR;3\nd;EUR;4\n");
+
+		const std::vector<uint32_t> eur = { 1, 3, 4 };
+		CPPUNIT_ASSERT(t.find("cur", "EUR") == eur);
+		CPPUNIT_ASSERT(t.find("cur", "GBP").empty());
+		CPPUNIT_ASSERT(t.find("cur", "cur").empty());
+		const std::vector<std::string> cols = { "cur", "amount" }, rcols = { "amount", "cur" };
+		CPPUNIT_ASSERT(t.find(cols, {"EUR", "3"}) == std::vector<uint32_t>{ 3 });
+		CPPUNIT_ASSERT(t.find(rcols, {"EUR", "3"}).empty());
+		CPPUNIT_ASSERT_THROW(t.find(cols, {"EUR"}), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(t.find("nope", "EUR"), std::invalid_argument);
+
+		// Copies rebuild their own index
+		Fs2a::HeaderedTable c(t);
+		t.cell("cur", 1) = "GBP";
+		CPPUNIT_ASSERT(c.find("cur", "EUR") == eur);
+	}
+
+	void indexUpdates() {
+		Fs2a::HeaderedTable t = load_("id;cur\na;EUR\nb;USD\nc;EUR\n");
+		t.index({"cur"});
+
+		// Changes through cell() are picked up
+		t.cell("cur", 2) = "EUR";
+		t.cell(1, 1) = "GBP";
+		CPPUNIT_ASSERT(t.find("cur", "EUR") == std::vector<uint32_t>({ 2, 3 }));
+		CPPUNIT_ASSERT(t.find("cur", "GBP") == std::vector<uint32_t>{ 1 });
+		CPPUNIT_ASSERT(t.find("cur", "USD").empty());
+
+		// Reading doesn't change anything
+		for (uint32_t r = 1; r < 4; r++) CPPUNIT_ASSERT(!t.cell("cur", r).empty());
+		CPPUNIT_ASSERT(t.find("cur", "EUR") == std::vector<uint32_t>({ 2, 3 }));
+
+		// New rows are found as well
+		t.cell("cur", 4) = "EUR";
+		CPPUNIT_ASSERT(t.find("cur", "EUR") == std::vector<uint32_t>({ 2, 3, 4 }));
+		t.emplaceRow("e", "EUR");
+		CPPUNIT_ASSERT(t.find("cur", "EUR") == std::vector<uint32_t>({ 2, 3, 4, 5 }));
+		t.rows(3);
+		CPPUNIT_ASSERT(t.find("cur", "EUR") == std::vector<uint32_t>{ 2 });
+	}
+
+	void sort() {
+		using namespace std::string_literals;
+		Fs2a::HeaderedTable t = load_("name;amount\nb;10\na;9\nc;x\nb;100\na;9.5\n");
+
+		t.sortBy({"name"});
+		CPPUNIT_ASSERT_EQUAL("name"s, t.cell(0, 0));
+		std::vector<std::string> order;
+		for (uint32_t r = 1; r < t.rows(); r++) order.push_back(t.cell("name", r) + t.cell("amount", r));
+		CPPUNIT_ASSERT(order == std::vector<std::string>({ "a9", "a9.5", "b10", "b100", "cx" }));
+
+		// Numbers are compared as such, anything else sorts last
+		t.sortBy({{"amount", true, true}});
+		order.clear();
+		for (uint32_t r = 1; r < t.rows(); r++) order.push_back(t.cell("amount", r));
+		CPPUNIT_ASSERT(order == std::vector<std::string>({ "100", "10", "9.5", "9", "x" }));
+
+		// Indexes follow
+		CPPUNIT_ASSERT(t.find("name", "a") == std::vector<uint32_t>({ 3, 4 }));
+		t.sortBy({{"name", true}, "amount"});
+		CPPUNIT_ASSERT(t.find("name", "a") == std::vector<uint32_t>({ 4, 5 }));
+		CPPUNIT_ASSERT_EQUAL("10"s, t.cell("amount", 2));
+		CPPUNIT_ASSERT_THROW(t.sortBy({}), std::invalid_argument);
+	}
+
+	void parallelSort() {
+		std::mt19937 rng(35);
+		Fs2a::HeaderedTable t;
+		t.columns(2);
+		t.emplaceRow("key", "seq");
+		for (uint32_t i = 0; i < 200000; i++) t.emplaceRow(std::to_string(rng() % 1000), std::to_string(i));
+
+		Fs2a::HeaderedTable s(t);
+		s.sortBy({{"key", false, true}}, 1);
+		t.sortBy({{"key", false, true}}, 4);
+
+		// Same result and stable, so equal keys keep ascending sequence numbers
+		bool same = true, stable = true;
+		for (uint32_t r = 1; r < t.rows(); r++) {
+			same &= t.cell(1, r) == s.cell(1, r);
+			if (r > 1 && t.cell(0, r) == t.cell(0, r - 1)) stable &= std::stoul(t.cell(1, r)) > std::stoul(t.cell(1, r - 1));
+		}
+		CPPUNIT_ASSERT(same);
+		CPPUNIT_ASSERT(stable);
+		CPPUNIT_ASSERT_EQUAL(std::string("0"), t.cell(0, 1));
+	}
+
+};
+
+#undef CHECKNAME
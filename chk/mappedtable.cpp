@@ -0,0 +1,171 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/MappedTable.hpp>
+
+#define CHECKNAME mappedtableCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(roundtrip);
+	CPPUNIT_TEST(headers);
+	CPPUNIT_TEST(corrupt);
+	CPPUNIT_TEST(cache);
+	CPPUNIT_TEST_SUITE_END();
+
+	std::filesystem::path dir_;
+
+	void write_(const std::filesystem::path & path_i, const std::string & contents_i) {
+		std::ofstream out(path_i, std::ios::binary | std::ios::trunc);
+		out << contents_i;
+	}
+
+	public:
+
+	void setUp() {
+		dir_ = std::filesystem::temp_directory_path() / ("fs2a-mappedtable-" + std::to_string(getpid()));
+		std::filesystem::create_directories(dir_);
+	}
+
+	void tearDown() {
+		std::filesystem::remove_all(dir_);
+	}
+
+	void roundtrip() {
+		using namespace std::string_literals;
+		Fs2a::Table<std::string> t;
+		t.columns(3);
+		t.emplaceRow("a", "", "with\0zero"s);
+		t.emplaceRow("bc", "def", "");
+		const std::string path = dir_ / "plain.fs2t";
+		Fs2a::writeBinary(t, path);
+
+		Fs2a::MappedTable m(path);
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(3), m.columns());
+		CPPUNIT_ASSERT_EQUAL(2U, m.rows());
+		CPPUNIT_ASSERT(!m.isHeadered());
+		CPPUNIT_ASSERT_EQUAL(std::string_view("with\0zero", 9), m.cell(2, 0));
+		CPPUNIT_ASSERT_EQUAL(std::string_view("def"), m(1, 1));
+		CPPUNIT_ASSERT(m(1, 0).empty());
+		CPPUNIT_ASSERT_THROW(m.cell(3, 0), std::out_of_range);
+		CPPUNIT_ASSERT_THROW(m.cell(0, 2), std::out_of_range);
+		CPPUNIT_ASSERT_THROW(m.cell("a", 1), std::logic_error);
+
+		// Views stay valid when moved
+		std::string_view v = m(0, 1);
+		Fs2a::MappedTable n(std::move(m));
+		CPPUNIT_ASSERT_EQUAL(std::string_view("bc"), v);
+		Fs2a::Table<std::string> c = n.toTable();
+		CPPUNIT_ASSERT_EQUAL(t.cell(2, 0), c.cell(2, 0));
+		CPPUNIT_ASSERT_EQUAL(t.rows(), c.rows());
+	}
+
+	void headers() {
+		Fs2a::HeaderedTable t;
+		t.columns(2);
+		t.emplaceRow("id", "id");
+		t.emplaceRow("1", "2");
+		const std::string path = dir_ / "headered.fs2t";
+		Fs2a::writeBinary(t, path);
+
+		Fs2a::MappedTable m(path);
+		CPPUNIT_ASSERT(m.isHeadered());
+		CPPUNIT_ASSERT_EQUAL(std::string_view("2"), m.cell("id_0", 1));
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(0), m.columnIndex("id"));
+		CPPUNIT_ASSERT_THROW(m.cell("nope", 1), std::invalid_argument);
+	}
+
+	void corrupt() {
+		Fs2a::Table<std::string> t;
+		t.columns(1);
+		t.emplaceRow("value");
+		std::stringstream sss;
+		Fs2a::writeBinary(t, sss);
+		const std::string good = sss.str(), path = dir_ / "corrupt.fs2t";
+
+		write_(path, "");
+		CPPUNIT_ASSERT_THROW(Fs2a::MappedTable m(path), std::runtime_error);
+		write_(path, "not a binary table, but long enough for a header");
+		CPPUNIT_ASSERT_THROW(Fs2a::MappedTable m(path), std::runtime_error);
+		write_(path, good.substr(0, good.size() - 8));
+		CPPUNIT_ASSERT_THROW(Fs2a::MappedTable m(path), std::runtime_error);
+		CPPUNIT_ASSERT_THROW(Fs2a::MappedTable m(dir_ / "missing.fs2t"), std::runtime_error);
+		write_(path, good);
+		Fs2a::MappedTable m(path);
+		CPPUNIT_ASSERT_EQUAL(std::string_view("value"), m.cell(0, 0));
+	}
+
+	void cache() {
+		const std::filesystem::path csv = dir_ / "data.csv", bin = dir_ / "data.csv.fs2t";
+		write_(csv, "name;amount\na;1\nb;2\n");
+
+		{
+			Fs2a::MappedTable m = Fs2a::cacheCSV(csv);
+			CPPUNIT_ASSERT_EQUAL(std::string_view("2"), m.cell("amount", 2));
+		}
+		CPPUNIT_ASSERT(std::filesystem::exists(bin));
+		const auto written = std::filesystem::last_write_time(bin);
+
+		// Reused while up to date
+		CPPUNIT_ASSERT_EQUAL(std::string("b"), std::string(Fs2a::cacheCSV(csv).cell("name", 2)));
+		CPPUNIT_ASSERT(written == std::filesystem::last_write_time(bin));
+
+		// Refreshed when the CSV changes or the copy is damaged
+		write_(csv, "name;amount\nc;3\n");
+		std::filesystem::last_write_time(csv, written + std::chrono::seconds(2));
+		CPPUNIT_ASSERT_EQUAL(std::string("c"), std::string(Fs2a::cacheCSV(csv).cell("name", 1)));
+		write_(bin, "damaged");
+		std::filesystem::last_write_time(bin, written + std::chrono::seconds(4));
+		CPPUNIT_ASSERT_EQUAL(std::string("3"), std::string(Fs2a::cacheCSV(csv).cell("amount", 1)));
+		CPPUNIT_ASSERT_EQUAL(2U, Fs2a::cacheCSV(csv, ';', false).rows());
+
+		// Refreshed when read with another separator
+		Fs2a::MappedTable c = Fs2a::cacheCSV(csv, ',', false);
+		CPPUNIT_ASSERT_EQUAL(',', c.separator());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(1), c.columns());
+		CPPUNIT_ASSERT_EQUAL(std::string_view("c;3"), c.cell(0, 1));
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(2), Fs2a::cacheCSV(csv, ';', false).columns());
+	}
+
+};
+
+#undef CHECKNAME
@@ -40,6 +40,7 @@ CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
 class CHECKNAME : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(CHECKNAME);
 		CPPUNIT_TEST(weekday);
+		CPPUNIT_TEST(parse);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -57,4 +58,18 @@ class CHECKNAME : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(Fs2a::NaiveDate::Sun, nd.weekday());
 		}
 
+		void parse()
+		{
+			Fs2a::NaiveDate nd;
+
+			CPPUNIT_ASSERT(nd.parse("2024-02-29"));
+			CPPUNIT_ASSERT_EQUAL(std::string("2024-02-29"), nd.iso8601());
+			CPPUNIT_ASSERT(!nd.parse("2023-02-29"));
+			CPPUNIT_ASSERT(!nd.parse("2024-2-29"));
+			CPPUNIT_ASSERT(!nd.parse("2024/02/28"));
+			CPPUNIT_ASSERT(!nd.parse("+024-02-28"));
+			CPPUNIT_ASSERT(!nd.parse("1899-12-31"));
+			CPPUNIT_ASSERT_EQUAL(std::string("2024-02-29"), nd.iso8601());
+		}
+
 };
@@ -40,6 +40,7 @@ CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
 class CHECKNAME : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(CHECKNAME);
 		CPPUNIT_TEST(addmins);
+		CPPUNIT_TEST(parse);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -68,4 +69,21 @@ class CHECKNAME : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(std::string("07:50"), std::string(nt));;
 		}
 
+		void parse()
+		{
+			Fs2a::NaiveTime nt;
+
+			CPPUNIT_ASSERT(!nt.valid());
+			CPPUNIT_ASSERT(nt.parse("9:5"));
+			CPPUNIT_ASSERT_EQUAL(std::string("09:05"), std::string(nt));
+			CPPUNIT_ASSERT(nt.parse("23:59"));
+			CPPUNIT_ASSERT(!nt.parse("24:00"));
+			CPPUNIT_ASSERT(!nt.parse("12:60"));
+			CPPUNIT_ASSERT(!nt.parse("123:00"));
+			CPPUNIT_ASSERT(!nt.parse(":00"));
+			CPPUNIT_ASSERT(!nt.parse("12:"));
+			CPPUNIT_ASSERT(!nt.parse("1200"));
+			CPPUNIT_ASSERT_EQUAL(std::string("23:59"), std::string(nt));
+		}
+
 };
@@ -0,0 +1,59 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <stdexcept>
+#include <cppunit/extensions/HelperMacros.h>
+
+/// Table cell whose constructor throws on negative values
+struct pickyCell {
+	int v = 0;
+	pickyCell() = default;
+	pickyCell(const int v_i) : v(v_i) { if (v_i < 0) throw std::invalid_argument("Negative"); }
+};
+
+/** Check that emplaceRow() leaves no partial row behind when a cell constructor throws.
+ * @param table_io Empty table of pickyCell with two columns
+ * @param afterThrow_i Further checks on the table right after the failed row */
+template <typename T, typename F>
+void checkEmplaceRollback(T & table_io, F afterThrow_i)
+{
+	table_io.emplaceRow(1, 2);
+	table_io.emplaceRow(3, 4);
+	CPPUNIT_ASSERT_THROW(table_io.emplaceRow(5, -6), std::invalid_argument);
+	CPPUNIT_ASSERT(table_io.rows() == 2);
+	afterThrow_i();
+	CPPUNIT_ASSERT(table_io.emplaceRow(7, 8) == 2);
+	CPPUNIT_ASSERT_EQUAL(8, table_io(1, 2).v);
+}
+
+template <typename T>
+void checkEmplaceRollback(T & table_io) { checkEmplaceRollback(table_io, [] {}); }
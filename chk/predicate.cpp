@@ -0,0 +1,170 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/Predicate.hpp>
+#include <fs2a/readCSV.hpp>
+
+#define CHECKNAME predicateCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(selection);
+	CPPUNIT_TEST(strings);
+	CPPUNIT_TEST(typed);
+	CPPUNIT_TEST(view);
+	CPPUNIT_TEST(large);
+	CPPUNIT_TEST_SUITE_END();
+
+	Fs2a::HeaderedTable load_() {
+		std::stringstream sss("id;cur;amount;booked;paid\n"
+			"1;EUR;10;2024-01-31;true\n"
+			"2;USD;9.5;2024-02-01;false\n"
+			"3;EUR;100;;true\n"
+			"4;GBP;x;2024-03-15;\n"
+			"5;EURO;-2;2023-12-31;false\n");
+		return Fs2a::readCSV(sss, ';');
+	}
+
+	public:
+
+	void selection() {
+		Fs2a::Selection s(70), a(70, true);
+		CPPUNIT_ASSERT_EQUAL(size_t(0), s.count());
+		CPPUNIT_ASSERT_EQUAL(size_t(70), a.count());
+		s.set(3);
+		s.set(69);
+		CPPUNIT_ASSERT(s.test(69));
+		CPPUNIT_ASSERT(!s.test(70));
+		CPPUNIT_ASSERT(s.indices() == std::vector<uint32_t>({ 3, 69 }));
+		a.set(3, false);
+		a &= s;
+		CPPUNIT_ASSERT(a.indices() == std::vector<uint32_t>{ 69 });
+		CPPUNIT_ASSERT_EQUAL(size_t(68), s.flip().count());
+		CPPUNIT_ASSERT_THROW(a |= Fs2a::Selection(3), std::invalid_argument);
+	}
+
+	void strings() {
+		using P = Fs2a::Predicate;
+		Fs2a::HeaderedTable t = load_();
+
+		CPPUNIT_ASSERT(P::equal("cur", "EUR").evaluate(t).indices() == std::vector<uint32_t>({ 0, 2 }));
+		CPPUNIT_ASSERT(P::startsWith("cur", "EUR").evaluate(t).indices() == std::vector<uint32_t>({ 0, 2, 4 }));
+		CPPUNIT_ASSERT(P::in("cur", { "USD", "GBP", "USD" }).evaluate(t).indices() == std::vector<uint32_t>({ 1, 3 }));
+		CPPUNIT_ASSERT_EQUAL(size_t(0), P::in("cur", {}).evaluate(t).count());
+
+		// Numerically when comparing with numbers, so "x" never matches
+		CPPUNIT_ASSERT(P::greater("amount", "9.5").evaluate(t).indices() == std::vector<uint32_t>({ 0, 2 }));
+		CPPUNIT_ASSERT(P::lessEqual("amount", "9.5").evaluate(t).indices() == std::vector<uint32_t>({ 1, 4 }));
+		CPPUNIT_ASSERT(P::between("booked", "2024-01-01", "2024-02-28").evaluate(t).indices() ==
+			std::vector<uint32_t>({ 0, 1 }));
+
+		P p = (P::equal("cur", "EUR") && P::greater("amount", "50")) || P::equal("id", "4");
+		CPPUNIT_ASSERT(p.evaluate(t).indices() == std::vector<uint32_t>({ 2, 3 }));
+		CPPUNIT_ASSERT_THROW(P::equal("nope", "1").evaluate(t), std::invalid_argument);
+	}
+
+	void typed() {
+		using P = Fs2a::Predicate;
+		using T = Fs2a::ColumnTable;
+		std::vector<T::conversionError_t> errors;
+		T t = T::fromTable(load_(), { T::integer, T::text, T::decimal, T::date, T::boolean }, errors);
+		CPPUNIT_ASSERT_EQUAL(size_t(1), errors.size());
+
+		CPPUNIT_ASSERT(P::greaterEqual("amount", "10").evaluate(t).indices() == std::vector<uint32_t>({ 0, 2 }));
+		CPPUNIT_ASSERT(P::in("id", { "5", "1", "9" }).evaluate(t).indices() == std::vector<uint32_t>({ 0, 4 }));
+		CPPUNIT_ASSERT(P::less("id", "2.5").evaluate(t).indices() == std::vector<uint32_t>({ 0, 1 }));
+		CPPUNIT_ASSERT(P::less("booked", "2024-02-01").evaluate(t).indices() == std::vector<uint32_t>({ 0, 4 }));
+		CPPUNIT_ASSERT(P::equal("paid", "TRUE").evaluate(t).indices() == std::vector<uint32_t>({ 0, 2 }));
+		CPPUNIT_ASSERT(P::startsWith("cur", "EUR").evaluate(t).indices() == std::vector<uint32_t>({ 0, 2, 4 }));
+		CPPUNIT_ASSERT(P::equal("cur", "EUR").evaluate(t).indices() == std::vector<uint32_t>({ 0, 2 }));
+		CPPUNIT_ASSERT(P::notEqual("cur", "EUR").evaluate(t).indices() == std::vector<uint32_t>({ 1, 3, 4 }));
+		CPPUNIT_ASSERT_EQUAL(size_t(0), P::equal("cur", "CHF").evaluate(t).count());
+		CPPUNIT_ASSERT_EQUAL(size_t(5), P::notEqual("cur", "CHF").evaluate(t).count());
+
+		// Missing values never match, not even when not equal
+		CPPUNIT_ASSERT(P::notEqual("paid", "true").evaluate(t).indices() == std::vector<uint32_t>({ 1, 4 }));
+		CPPUNIT_ASSERT(P::notEqual("amount", "10").evaluate(t).indices() == std::vector<uint32_t>({ 1, 2, 4 }));
+
+		CPPUNIT_ASSERT_THROW(P::equal("booked", "yesterday").evaluate(t), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(P::startsWith("id", "1").evaluate(t), std::invalid_argument);
+	}
+
+	void view() {
+		using P = Fs2a::Predicate;
+		Fs2a::HeaderedTable t = load_();
+
+		Fs2a::TableView v = Fs2a::filter(t, P::equal("cur", "EUR") || P::equal("cur", "GBP"));
+		CPPUNIT_ASSERT_EQUAL(4U, v.rows());
+		CPPUNIT_ASSERT_EQUAL(std::string("cur"), v.cell(1, 0));
+		CPPUNIT_ASSERT_EQUAL(std::string("4"), v.cell("id", 3));
+		CPPUNIT_ASSERT_EQUAL(3U, v.sourceRow(2));
+		CPPUNIT_ASSERT_THROW(v.cell(0, 4), std::out_of_range);
+
+		// Views refer to the table
+		t.cell("amount", 3) = "101";
+		CPPUNIT_ASSERT_EQUAL(std::string("101"), v(2, 2));
+
+		Fs2a::HeaderedTable c = v.toTable();
+		CPPUNIT_ASSERT_EQUAL(4U, c.rows());
+		CPPUNIT_ASSERT_EQUAL(std::string("GBP"), c.cell("cur", 3));
+	}
+
+	void large() {
+		using P = Fs2a::Predicate;
+		std::mt19937 rng(40);
+		Fs2a::HeaderedTable t;
+		t.columns(2);
+		t.emplaceRow("a", "b");
+		for (uint32_t i = 0; i < 1000; i++) t.emplaceRow(std::to_string(rng() % 100), std::to_string(rng() % 100));
+
+		// Skipped blocks don't change the outcome of and-combinations
+		Fs2a::Selection s = (P::less("a", "2") && P::greater("b", "50")).evaluate(t);
+		size_t expect = 0;
+		for (uint32_t r = 1; r < t.rows(); r++) {
+			const bool match = std::stoi(t(0, r)) < 2 && std::stoi(t(1, r)) > 50;
+			expect += match;
+			CPPUNIT_ASSERT_EQUAL(match, s.test(r - 1));
+		}
+		CPPUNIT_ASSERT_EQUAL(expect, s.count());
+	}
+
+};
+
+#undef CHECKNAME
@@ -28,8 +28,11 @@
  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <unistd.h>
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <fs2a/readCSV.hpp>
@@ -43,6 +46,12 @@ CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
 class CHECKNAME : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE(CHECKNAME);
 	CPPUNIT_TEST(validcsv);
+	CPPUNIT_TEST(blocks);
+	CPPUNIT_TEST(errors);
+	CPPUNIT_TEST(strayQuotes);
+	CPPUNIT_TEST(mapped);
+	CPPUNIT_TEST(parallel);
+	CPPUNIT_TEST(reader);
 	CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -54,7 +63,7 @@ class CHECKNAME : public CppUnit::TestFixture {
 		sss << "First;Second;Third\nUnquoted;\"QUOTED\";\"ESC\"\"QUOT\"\n";
 		Fs2a::Table<std::string> t;
 		CPPUNIT_ASSERT_NO_THROW(t = Fs2a::readCSV(sss, ';'));
-		CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(3), t.columns());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(3), t.columns());
 		CPPUNIT_ASSERT_EQUAL(2U, t.rows());
 		CPPUNIT_ASSERT_EQUAL("First"s, t.cell(0, 0));
 		CPPUNIT_ASSERT_EQUAL("Second"s, t.cell(1, 0));
@@ -64,6 +73,210 @@ class CHECKNAME : public CppUnit::TestFixture {
 		CPPUNIT_ASSERT_EQUAL("ESC\"QUOT"s, t.cell(2, 1));
 	}
 
+	void blocks() {
+		using namespace std::string_literals;
+		std::stringstream sss;
+
+		// Enough rows to span several read blocks, with fields crossing block boundaries
+		sss << "id;text\r\n";
+		for (uint32_t i = 1; i <= 40000; i++) {
+			sss << i << ";";
+			if (i % 3 == 0) sss << "\"line\r\nwith \"\"quotes\"\" and ;\"\r\n";
+			else sss << "plain text " << i << "\r\n";
+		}
+		// A quoted field at the very end is kept too
+		sss << "40001;\"last\"";
+
+		Fs2a::Table<std::string> t = Fs2a::readCSV(sss, ';');
+		CPPUNIT_ASSERT_EQUAL(40002U, t.rows());
+		for (uint32_t i = 1; i <= 40000; i++) {
+			CPPUNIT_ASSERT_EQUAL(std::to_string(i), t(0, i));
+			CPPUNIT_ASSERT_EQUAL(i % 3 == 0 ? "line\r\nwith \"quotes\" and ;"s : "plain text "s + std::to_string(i), t(1, i));
+		}
+		CPPUNIT_ASSERT_EQUAL("last"s, t(1, 40001));
+	}
+
+	void errors() {
+		auto message = [](const std::string & csv_i) {
+			std::stringstream sss(csv_i);
+			try {
+				Fs2a::readCSV(sss, ';');
+			} catch (const std::exception & e) {
+				return std::string(e.what());
+			}
+			return std::string();
+		};
+
+		CPPUNIT_ASSERT_EQUAL(std::string("Error at line 3, character 4: Field count 2 would exceed column count 2"),
+			message("a;b\n1;2\n3;4;5\n"));
+		CPPUNIT_ASSERT_EQUAL(std::string("Error at line 3, character 1: Found empty line"), message("a;b\n1;2\n\n3;4\n"));
+		CPPUNIT_ASSERT_EQUAL(std::string("Error at line 3, character 0: Encountered EOF while reading quoted field"),
+			message("a;b\n1;\"2\n"));
+	}
+
+	void strayQuotes() {
+		using namespace std::string_literals;
+		std::stringstream sss;
+
+		// A quote inside an unquoted field is data, so the separators after it still count
+		const std::string pad(70, 'p');
+		sss << "a;b;c\n" << pad << "x\"y;\"q;\n\"\"r\";z\"w\n" << pad << ";\"\";\"\"\"\"\n";
+		Fs2a::Table<std::string> t = Fs2a::readCSV(sss, ';');
+		CPPUNIT_ASSERT_EQUAL(3U, t.rows());
+		CPPUNIT_ASSERT_EQUAL(pad + "x\"y", t(0, 1));
+		CPPUNIT_ASSERT_EQUAL("q;\n\"r"s, t(1, 1));
+		CPPUNIT_ASSERT_EQUAL("z\"w"s, t(2, 1));
+		CPPUNIT_ASSERT_EQUAL(""s, t(1, 2));
+		CPPUNIT_ASSERT_EQUAL("\""s, t(2, 2));
+	}
+
+	void mapped() {
+		using namespace std::string_literals;
+		const std::filesystem::path path = std::filesystem::temp_directory_path() /
+			("fs2a-readcsv-" + std::to_string(getpid()) + ".csv");
+		std::string csv = "id;text\r\n1;plain\r\n2;\"quoted;\r\ntext\"\r\n3;\"ESC\"\"QUOT\"\r\n";
+		for (uint32_t i = 4; i < 30000; i++) csv += std::to_string(i) + ";\"row " + std::to_string(i) + "\"\n";
+		{
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << csv;
+		}
+
+		Fs2a::HeaderedArenaTable t;
+		Fs2a::readCSV(path, t, ';');
+		std::filesystem::remove(path);
+
+		// Same as reading from a stream
+		std::stringstream sss(csv);
+		Fs2a::Table<std::string> ref = Fs2a::readCSV(sss, ';');
+		CPPUNIT_ASSERT_EQUAL(ref.rows(), t.rows());
+		for (uint32_t r = 0; r < ref.rows(); r++) {
+			for (Fs2a::colidx_t c = 0; c < ref.columns(); c++) CPPUNIT_ASSERT_EQUAL(ref(c, r), std::string(t(c, r)));
+		}
+
+		// Fields view into the mapping, except the one with an escaped quote
+		Fs2a::HeaderedArenaTable m = std::move(t);
+		const char * begin = m.retained()->data(), * end = begin + m.retained()->size();
+		auto inMapping = [&](std::string_view v_i) { return v_i.data() >= begin && v_i.data() + v_i.size() <= end; };
+		CPPUNIT_ASSERT(inMapping(m.cell("text", 1)) && inMapping(m.cell("text", 2)) && inMapping(m(1, 29999)));
+		CPPUNIT_ASSERT(!inMapping(m.cell("text", 3)));
+		CPPUNIT_ASSERT_EQUAL("quoted;\r\ntext"s, std::string(m.cell("text", 2)));
+		CPPUNIT_ASSERT_EQUAL("ESC\"QUOT"s, std::string(m.cell("text", 3)));
+
+		// Compacting copies everything into the arena, and lets go of the mapping
+		m.compact();
+		CPPUNIT_ASSERT(m.retained() == nullptr);
+		CPPUNIT_ASSERT_EQUAL("row 29999"s, std::string(m(1, 29999)));
+
+		CPPUNIT_ASSERT_THROW(Fs2a::readCSV(path, ';'), std::runtime_error);
+	}
+
+	void parallel() {
+		const std::filesystem::path path = std::filesystem::temp_directory_path() /
+			("fs2a-readcsv-parallel-" + std::to_string(getpid()) + ".csv");
+		auto write = [&](const std::string & csv_i) {
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << csv_i;
+		};
+
+		// Mostly quoted lines, so parts are likely to start inside a quoted field
+		std::string csv = "id;text;more\n";
+		std::string text;
+		for (size_t i = 0; i < 40; i++) text += "line " + std::to_string(i) + ";\r\n";
+		for (uint32_t i = 1; i <= 60000; i++) {
+			csv += std::to_string(i) + ";\"" + text + "\";" + (i % 7 ? "plain" : "\"esc\"\"aped\"") + "\n";
+		}
+		write(csv);
+
+		Fs2a::ArenaTable s = Fs2a::readCSV(path, ';', 1), p = Fs2a::readCSV(path, ';', 4);
+		CPPUNIT_ASSERT_EQUAL(60001U, p.rows());
+		for (uint32_t r = 0; r < s.rows(); r++) {
+			for (Fs2a::colidx_t c = 0; c < s.columns(); c++) CPPUNIT_ASSERT(s(c, r) == p(c, r));
+		}
+		CPPUNIT_ASSERT(p(2, 7) == "esc\"aped");
+
+		// Errors have the same line numbers
+		csv.insert(csv.size() - 1, ";x");
+		write(csv);
+		std::string serial, threaded;
+		try { Fs2a::readCSV(path, ';', 1); } catch (const std::runtime_error & e) { serial = e.what(); }
+		try { Fs2a::readCSV(path, ';', 4); } catch (const std::runtime_error & e) { threaded = e.what(); }
+		CPPUNIT_ASSERT(serial.find("Error at line 2460001, ") == 0);
+		CPPUNIT_ASSERT_EQUAL(serial, threaded);
+
+		// Threaded and serial reading agree when the input ends without a line ending
+		auto same = [&](const std::string & csv_i) {
+			write(csv_i);
+			Fs2a::ArenaTable st, pt;
+			std::string se, pe;
+			try { st = Fs2a::readCSV(path, ';', 1); } catch (const std::runtime_error & e) { se = e.what(); }
+			try { pt = Fs2a::readCSV(path, ';', 4); } catch (const std::runtime_error & e) { pe = e.what(); }
+			CPPUNIT_ASSERT_EQUAL(se, pe);
+			CPPUNIT_ASSERT_EQUAL(st.rows(), pt.rows());
+			CPPUNIT_ASSERT_EQUAL(st.columns(), pt.columns());
+			for (uint32_t r = 0; r < st.rows(); r++) {
+				for (Fs2a::colidx_t c = 0; c < st.columns(); c++) CPPUNIT_ASSERT(st(c, r) == pt(c, r));
+			}
+			return st.rows();
+		};
+		csv.erase(csv.size() - 3);
+		CPPUNIT_ASSERT_EQUAL(60001U, same(csv));
+		// The last record is a quoted field that the later parts start in
+		std::string tail = "id;text\n1;x\n2;\"";
+		for (size_t i = 0; i < 800000; i++) tail += "line " + std::to_string(i) + "\n";
+		CPPUNIT_ASSERT_EQUAL(3U, same(tail + "\""));
+		CPPUNIT_ASSERT_EQUAL(0U, same(tail));
+		// Only a header
+		const std::string header(9 << 20, 'h');
+		CPPUNIT_ASSERT_EQUAL(1U, same(header));
+		CPPUNIT_ASSERT_EQUAL(1U, same(header + "\n"));
+		std::filesystem::remove(path);
+	}
+
+	void reader() {
+		using namespace std::string_literals;
+
+		// Rows spanning blocks, a quoted field over several lines and a short row
+		std::string csv = "\xef\xbb\xbfid;text;more\r\n1;\"quoted;\r\n\"\"text\"\"\";x\r\n2;short\r\n";
+		for (uint32_t i = 3; i < 20000; i++) csv += std::to_string(i) + ";" + std::string(i % 97, 'v') + ";end\n";
+		std::stringstream ref(csv), sss(csv);
+		Fs2a::Table<std::string> t = Fs2a::readCSV(ref, ';');
+
+		Fs2a::CsvReader rd(sss, ';');
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(3), rd.columns());
+		CPPUNIT_ASSERT("id"s == rd.header()[0] && "more"s == rd.header()[2]);
+		uint32_t r = 1;
+		while (rd.next()) {
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), rd.row().size());
+			for (Fs2a::colidx_t c = 0; c < 3; c++) CPPUNIT_ASSERT_EQUAL(t(c, r), std::string(rd.row()[c]));
+			r++;
+		}
+		CPPUNIT_ASSERT_EQUAL(t.rows(), r);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(t.rows() - 1), rd.rows());
+		CPPUNIT_ASSERT(!rd.next());
+		CPPUNIT_ASSERT_EQUAL("id"s, std::string(rd.header()[0]));
+
+		// Errors have the same line numbers as when reading into a table
+		std::stringstream bad("a;b\n1;2\n\"3\n\";4;5\n");
+		Fs2a::CsvReader rb(bad, ';');
+		CPPUNIT_ASSERT(rb.next());
+		std::string message;
+		try { rb.next(); } catch (const std::runtime_error & e) { message = e.what(); }
+		CPPUNIT_ASSERT(message.find("Error at line 4, character 4: ") == 0);
+
+		// A bad header keeps failing, instead of looking like empty input
+		std::stringstream badHeader("a;\"b\n1;2\n");
+		Fs2a::CsvReader rh(badHeader, ';');
+		CPPUNIT_ASSERT_THROW(rh.header(), std::runtime_error);
+		CPPUNIT_ASSERT_THROW(rh.columns(), std::runtime_error);
+		CPPUNIT_ASSERT_THROW(rh.next(), std::runtime_error);
+
+		// Nothing to read
+		std::stringstream empty;
+		Fs2a::CsvReader re(empty, ';');
+		CPPUNIT_ASSERT(!re.next());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(0), re.columns());
+	}
+
 };
 
 #undef CHECKNAME
@@ -0,0 +1,156 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/RowGroupTable.hpp>
+#include "pickycell.hpp"
+
+#define CHECKNAME rowgrouptableCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(construction);
+	CPPUNIT_TEST(rows);
+	CPPUNIT_TEST(stability);
+	CPPUNIT_TEST(groups);
+	CPPUNIT_TEST(conversion);
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+
+	void construction() {
+		CPPUNIT_ASSERT_THROW(Fs2a::RowGroupTable<int>(0), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::RowGroupTable<int>(100), std::invalid_argument);
+
+		Fs2a::RowGroupTable<int> t(4);
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(0), t.columns());
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0), t.rows());
+		CPPUNIT_ASSERT_THROW(t.rows(3), std::logic_error);
+		CPPUNIT_ASSERT_THROW(t.cell(0, 0), std::logic_error);
+		CPPUNIT_ASSERT_THROW(t.emplaceRow(1), std::logic_error);
+		CPPUNIT_ASSERT_THROW(t.columns(0), std::invalid_argument);
+		t.columns(2);
+		CPPUNIT_ASSERT_THROW(t.columns(3), std::logic_error);
+		CPPUNIT_ASSERT_THROW(t.cell(2, 0), std::out_of_range);
+		CPPUNIT_ASSERT_THROW(t.emplaceRow(1), std::invalid_argument);
+	}
+
+	void rows() {
+		Fs2a::RowGroupTable<int> t(4);
+		t.columns(2);
+
+		// Grow and shrink across group boundaries
+		for (uint64_t n : { 3, 4, 5, 11, 8, 1, 0, 9 }) {
+			t.rows(n);
+			CPPUNIT_ASSERT_EQUAL(n, t.rows());
+			CPPUNIT_ASSERT_EQUAL(size_t((n + 3) / 4), t.groups());
+		}
+
+		for (int i = 0; i < 9; i++) t(0, i) = i;
+		t.cell(1, 12) = 42;
+		CPPUNIT_ASSERT_EQUAL(uint64_t(13), t.rows());
+		CPPUNIT_ASSERT_EQUAL(8, t(0, 8));
+		CPPUNIT_ASSERT_EQUAL(0, t(0, 9));
+		CPPUNIT_ASSERT_EQUAL(42, t.row(12)[1]);
+		CPPUNIT_ASSERT_THROW(t.row(13), std::out_of_range);
+
+		// A failing cell constructor leaves no partial row or empty group behind
+		Fs2a::RowGroupTable<pickyCell> p(2);
+		p.columns(2);
+		checkEmplaceRollback(p, [&] { CPPUNIT_ASSERT_EQUAL(size_t(1), p.groups()); });
+	}
+
+	void stability() {
+		Fs2a::RowGroupTable<std::string> t(8);
+		t.columns(1);
+		t.emplaceRow("first");
+		std::string * p = &t(0, 0);
+
+		// Growing never moves existing cells
+		for (int i = 0; i < 1000; i++) t.emplaceRow(std::to_string(i));
+		CPPUNIT_ASSERT_EQUAL(p, &t(0, 0));
+		CPPUNIT_ASSERT_EQUAL(std::string("999"), t(0, 1000));
+
+		Fs2a::RowGroupTable<std::string> c(t);
+		std::string * q = &c(0, 1000);
+		c.emplaceRow("more");
+		CPPUNIT_ASSERT_EQUAL(q, &c(0, 1000));
+	}
+
+	void groups() {
+		Fs2a::RowGroupTable<uint64_t> t(16);
+		t.columns(2);
+		for (uint64_t i = 0; i < 1000; i++) t.emplaceRow(i, i * 2);
+
+		CPPUNIT_ASSERT_EQUAL(size_t(63), t.groups());
+		CPPUNIT_ASSERT_EQUAL(size_t(32), t.group(0).size());
+		CPPUNIT_ASSERT_EQUAL(size_t(16), t.group(62).size());
+		CPPUNIT_ASSERT_THROW(t.group(63), std::out_of_range);
+
+		for (unsigned threads : { 1U, 4U, 0U }) {
+			std::atomic<uint64_t> sum = 0;
+			std::atomic<size_t> bad = 0;
+			t.forEachGroup([&](std::span<uint64_t> cells_i, const uint64_t first_i) {
+				if (cells_i[0] != first_i) bad++;
+				uint64_t s = 0;
+				for (size_t i = 1; i < cells_i.size(); i += 2) s += cells_i[i];
+				sum += s;
+			}, threads);
+			CPPUNIT_ASSERT_EQUAL(size_t(0), bad.load());
+			CPPUNIT_ASSERT_EQUAL(uint64_t(999 * 1000), sum.load());
+		}
+	}
+
+	void conversion() {
+		Fs2a::Table<std::string> s;
+		s.columns(2);
+		s.emplaceRow("a", "b");
+		s.emplaceRow("c", "d");
+
+		Fs2a::RowGroupTable<std::string> t(s, 1);
+		CPPUNIT_ASSERT_EQUAL(size_t(2), t.groups());
+		CPPUNIT_ASSERT_EQUAL(std::string("d"), t(1, 1));
+
+		Fs2a::Table<std::string> b = t.toTable();
+		CPPUNIT_ASSERT_EQUAL(2U, b.rows());
+		CPPUNIT_ASSERT_EQUAL(std::string("c"), b.cell(0, 1));
+	}
+
+};
+
+#undef CHECKNAME
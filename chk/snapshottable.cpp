@@ -0,0 +1,197 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/SnapshotTable.hpp>
+#include "pickycell.hpp"
+
+#define CHECKNAME snapshottableCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(build);
+	CPPUNIT_TEST(sharing);
+	CPPUNIT_TEST(reclaim);
+	CPPUNIT_TEST(readers);
+	CPPUNIT_TEST_SUITE_END();
+
+	typedef Fs2a::SnapshotTable<std::string> snap_t;
+
+	public:
+
+	void build() {
+		CPPUNIT_ASSERT_THROW(snap_t::Builder(0), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(snap_t::Builder(2, 100), std::invalid_argument);
+
+		Fs2a::Table<std::string> t;
+		t.columns(2);
+		t.emplaceRow("id", "name");
+		t.emplaceRow("1", "a");
+		t.emplaceRow("2", "b");
+		snap_t::Builder b(t, 2);
+		CPPUNIT_ASSERT_THROW(b.emplaceRow("3"), std::invalid_argument);
+		b.cell(1, 4) = "e";
+
+		auto s = b.build();
+		CPPUNIT_ASSERT_EQUAL(uint64_t(5), s->rows());
+		CPPUNIT_ASSERT_EQUAL(size_t(3), s->groups());
+		CPPUNIT_ASSERT_EQUAL(std::string("b"), s->cell(1, 2));
+		CPPUNIT_ASSERT_EQUAL(std::string(), (*s)(0, 3));
+		CPPUNIT_ASSERT_EQUAL(std::string("e"), s->row(4)[1]);
+		CPPUNIT_ASSERT_THROW(s->cell(2, 0), std::out_of_range);
+		CPPUNIT_ASSERT_THROW(s->row(5), std::out_of_range);
+
+		Fs2a::Table<std::string> c = s->toTable();
+		CPPUNIT_ASSERT_EQUAL(5U, c.rows());
+		CPPUNIT_ASSERT_EQUAL(std::string("name"), c(1, 0));
+
+		// A failing cell constructor leaves no partial row or empty group behind
+		Fs2a::SnapshotTable<pickyCell>::Builder p(2, 2);
+		checkEmplaceRollback(p, [&] { CPPUNIT_ASSERT_EQUAL(size_t(1), p.owned()); });
+		CPPUNIT_ASSERT_EQUAL(uint64_t(3), p.build()->rows());
+	}
+
+	void sharing() {
+		snap_t::Builder b(1, 4);
+		for (int i = 0; i < 16; i++) b.emplaceRow(std::to_string(i));
+		auto first = b.build();
+		CPPUNIT_ASSERT_EQUAL(size_t(0), b.owned());
+
+		// Only the written group is copied, the old snapshot is left alone
+		snap_t::Builder n(*first);
+		n.cell(0, 5) = "five";
+		n.cell(0, 6) = "six";
+		CPPUNIT_ASSERT_EQUAL(size_t(1), n.owned());
+		auto second = n.build();
+		CPPUNIT_ASSERT_EQUAL(std::string("5"), first->cell(0, 5));
+		CPPUNIT_ASSERT_EQUAL(std::string("six"), second->cell(0, 6));
+		CPPUNIT_ASSERT(second->shares(*first, 0));
+		CPPUNIT_ASSERT(!second->shares(*first, 1));
+		CPPUNIT_ASSERT(second->shares(*first, 3));
+
+		// Writing after a build copies again, appending copies only the last group
+		n.cell(0, 5) = "again";
+		n.emplaceRow("16");
+		auto third = n.build();
+		CPPUNIT_ASSERT_EQUAL(std::string("five"), second->cell(0, 5));
+		CPPUNIT_ASSERT(!third->shares(*second, 1));
+		CPPUNIT_ASSERT(third->shares(*second, 3));
+		CPPUNIT_ASSERT_EQUAL(size_t(5), third->groups());
+
+		// Shrinking within a group copies only that group
+		snap_t::Builder s(*third);
+		s.rows(10);
+		auto fourth = s.build();
+		CPPUNIT_ASSERT_EQUAL(size_t(3), fourth->groups());
+		CPPUNIT_ASSERT(fourth->shares(*third, 1));
+		CPPUNIT_ASSERT(!fourth->shares(*third, 2));
+		CPPUNIT_ASSERT_EQUAL(uint64_t(17), third->rows());
+
+		// Builders can only be moved, so published groups are never written in place
+		static_assert(!std::is_copy_constructible_v<snap_t::Builder>);
+		static_assert(!std::is_copy_assignable_v<snap_t::Builder>);
+		snap_t::Builder m(std::move(s));
+		m.cell(0, 9) = "nine";
+		auto fifth = m.build();
+		snap_t::Builder o(*fifth);
+		m.cell(0, 9) = "moved";
+		o.cell(0, 9) = "other";
+		CPPUNIT_ASSERT_EQUAL(std::string("nine"), fifth->cell(0, 9));
+		CPPUNIT_ASSERT_EQUAL(std::string("moved"), m(0, 9));
+		CPPUNIT_ASSERT_EQUAL(std::string("other"), o(0, 9));
+	}
+
+	void reclaim() {
+		Fs2a::SnapshotPublisher<int> p;
+		CPPUNIT_ASSERT(!p.snapshot());
+		CPPUNIT_ASSERT_THROW(p.edit(), std::logic_error);
+
+		Fs2a::SnapshotTable<int>::Builder b(1);
+		b.emplaceRow(1);
+		p.publish(b);
+		std::weak_ptr<const Fs2a::SnapshotTable<int>> old = p.snapshot();
+		auto reader = p.snapshot();
+
+		auto e = p.edit();
+		e.cell(0, 0) = 2;
+		p.publish(e);
+		CPPUNIT_ASSERT_EQUAL(2, p.snapshot()->cell(0, 0));
+
+		// The old version lives until its last reader leaves
+		CPPUNIT_ASSERT(!old.expired());
+		CPPUNIT_ASSERT_EQUAL(1, reader->cell(0, 0));
+		reader.reset();
+		CPPUNIT_ASSERT(old.expired());
+	}
+
+	void readers() {
+		Fs2a::SnapshotPublisher<uint64_t> p;
+		Fs2a::SnapshotTable<uint64_t>::Builder b(2, 64);
+		for (uint64_t i = 0; i < 1000; i++) b.emplaceRow(0, i);
+		p.publish(b);
+
+		// Every version has the same value in all rows of column 0, readers never see a mix
+		std::atomic<bool> done = false;
+		std::atomic<size_t> torn = 0;
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 3; t++) {
+			threads.emplace_back([&]() {
+				while (!done) {
+					auto s = p.snapshot();
+					const uint64_t v = (*s)(0, 0);
+					for (uint64_t r = 1; r < s->rows(); r++) torn += (*s)(0, r) != v;
+				}
+			});
+		}
+		for (uint64_t v = 1; v <= 50; v++) {
+			auto e = p.edit();
+			for (uint64_t r = 0; r < e.rows(); r++) e.cell(0, r) = v;
+			p.publish(e);
+		}
+		done = true;
+		for (auto & t : threads) t.join();
+		CPPUNIT_ASSERT_EQUAL(size_t(0), torn.load());
+		CPPUNIT_ASSERT_EQUAL(uint64_t(50), p.snapshot()->cell(0, 999));
+	}
+
+};
+
+#undef CHECKNAME
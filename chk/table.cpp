@@ -28,9 +28,15 @@
  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <fs2a/Table.hpp>
+#include "pickycell.hpp"
 
 #define CHECKNAME tableCheck
 
@@ -44,6 +50,9 @@ class CHECKNAME : public CppUnit::TestFixture {
 	CPPUNIT_TEST(columns);
 	CPPUNIT_TEST(rows);
 	CPPUNIT_TEST(cells);
+	CPPUNIT_TEST(bulk);
+	CPPUNIT_TEST(ranges);
+	CPPUNIT_TEST(memory);
 	CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -52,7 +61,7 @@ class CHECKNAME : public CppUnit::TestFixture {
 		Fs2a::Table<int> t;
 
 		// Check that column count is zero
-		CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(0), t.columns());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(0), t.columns());
 
 		// Check that row count is zero
 		CPPUNIT_ASSERT_EQUAL(0U, t.rows());
@@ -73,25 +82,25 @@ class CHECKNAME : public CppUnit::TestFixture {
 		CPPUNIT_ASSERT_THROW(t.columns(0), std::invalid_argument);
 
 		// Column count remains zero after throw
-		CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(0), t.columns());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(0), t.columns());
 
 		// Regular column set
 		CPPUNIT_ASSERT_NO_THROW(t.columns(2));
 
 		// Check that column count was set
-		CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(2), t.columns());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(2), t.columns());
 
 		// Not allowed to change columns
 		CPPUNIT_ASSERT_THROW(t.columns(3), std::logic_error);
 
 		// Column count should not have changed
-		CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(2), t.columns());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(2), t.columns());
 
 		// Can re-set to same number of columns
 		CPPUNIT_ASSERT_NO_THROW(t.columns(2));
 
 		// Column count should not have changed
-		CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(2), t.columns());
+		CPPUNIT_ASSERT_EQUAL(static_cast<Fs2a::colidx_t>(2), t.columns());
 	}
 
 	void rows() {
@@ -156,6 +165,141 @@ class CHECKNAME : public CppUnit::TestFixture {
 		CPPUNIT_ASSERT_EQUAL(7U, t.rows());
 	}
 
+	void bulk()
+	{
+		Fs2a::Table<std::string> t;
+		std::vector<std::string> r = { "a", "b", "c" };
+
+		// Everything needs the number of columns
+		CPPUNIT_ASSERT_THROW(t.reserve(10), std::logic_error);
+		CPPUNIT_ASSERT_THROW(t.appendRow(r), std::logic_error);
+		CPPUNIT_ASSERT_THROW(t.emplaceRow("x"), std::logic_error);
+
+		CPPUNIT_ASSERT_NO_THROW(t.columns(3));
+		CPPUNIT_ASSERT_NO_THROW(t.reserve(10));
+		CPPUNIT_ASSERT_EQUAL(0U, t.rows());
+
+		// Rows should be complete
+		CPPUNIT_ASSERT_EQUAL(0U, t.appendRow(r));
+		CPPUNIT_ASSERT_EQUAL(1U, t.emplaceRow("d", std::string("e"), std::string(3, 'f')));
+		CPPUNIT_ASSERT_THROW(t.appendRow(std::span(r).first(2)), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(t.emplaceRow("x", "y"), std::invalid_argument);
+		CPPUNIT_ASSERT_EQUAL(2U, t.rows());
+
+		// A failing cell constructor leaves no partial row behind
+		Fs2a::Table<pickyCell> p;
+		p.columns(2);
+		checkEmplaceRollback(p);
+
+		// Unchecked access
+		CPPUNIT_ASSERT_EQUAL(std::string("c"), t(2, 0));
+		CPPUNIT_ASSERT_EQUAL(std::string("fff"), t(2, 1));
+		t(0, 1) = "g";
+		CPPUNIT_ASSERT_EQUAL(std::string("g"), t.cell(0, 1));
+
+		// Row spans
+		std::span<std::string> s = t.row(1);
+		CPPUNIT_ASSERT_EQUAL(size_t(3), s.size());
+		CPPUNIT_ASSERT_EQUAL(std::string("e"), s[1]);
+		s[1] = "h";
+		CPPUNIT_ASSERT_EQUAL(std::string("h"), t.cell(1, 1));
+		CPPUNIT_ASSERT_THROW(t.row(2), std::out_of_range);
+		const Fs2a::Table<std::string> & c = t;
+		CPPUNIT_ASSERT_EQUAL(std::string("a"), c.row(0)[0]);
+
+		// Rows and cells of the table itself survive it growing
+		Fs2a::Table<std::string> g;
+		const std::string l(40, 'l'), m(40, 'm');
+		g.columns(2);
+		g.emplaceRow(l, m);
+		for (uint32_t r = 1; r < 9; r++) {
+			CPPUNIT_ASSERT_EQUAL(r, (r % 2) ? g.appendRow(g.row(r - 1)) : g.emplaceRow(g(1, r - 1), g(0, r - 1)));
+		}
+		CPPUNIT_ASSERT_EQUAL(l, g(0, 8));
+		CPPUNIT_ASSERT_EQUAL(m, g(1, 8));
+		CPPUNIT_ASSERT_EQUAL(m, g(0, 7));
+	}
+
+	void ranges()
+	{
+		static_assert(std::ranges::random_access_range<Fs2a::StridedRange<int>>);
+		static_assert(std::ranges::sized_range<Fs2a::StridedRange<const int>>);
+		static_assert(std::ranges::view<Fs2a::StridedRange<int>>);
+		static_assert(std::ranges::random_access_range<Fs2a::RowRange<int>>);
+
+		Fs2a::Table<int> t;
+		CPPUNIT_ASSERT(t.rowRange().empty());
+		CPPUNIT_ASSERT_THROW(t.columnRange(0), std::out_of_range);
+		t.columns(3);
+		for (int i = 0; i < 5; i++) t.emplaceRow(i, 10 - i, i * i);
+
+		// Columns are random access, so they can be sorted in place
+		Fs2a::StridedRange<int> c = t.columnRange(1);
+		CPPUNIT_ASSERT_EQUAL(size_t(5), c.size());
+		CPPUNIT_ASSERT_EQUAL(8, c[2]);
+		std::ranges::sort(c);
+		CPPUNIT_ASSERT_EQUAL(6, t(1, 0));
+		CPPUNIT_ASSERT_EQUAL(10, t(1, 4));
+		CPPUNIT_ASSERT_EQUAL(0, t(0, 0));
+		CPPUNIT_ASSERT_EQUAL(30, std::accumulate(t.columnRange(2).begin(), t.columnRange(2).end(), 0));
+		CPPUNIT_ASSERT_EQUAL(size_t(2), t.columnRange(0, 3).size());
+		CPPUNIT_ASSERT(t.columnRange(0, 5).empty());
+		CPPUNIT_ASSERT(t.columnRange(2, t.rows()).empty());
+		CPPUNIT_ASSERT_EQUAL(0, std::accumulate(t.columnRange(2, 5).begin(), t.columnRange(2, 5).end(), 0));
+		CPPUNIT_ASSERT_THROW(t.columnRange(0, 6), std::out_of_range);
+		CPPUNIT_ASSERT_THROW(t.columnRange(3), std::out_of_range);
+
+		const Fs2a::Table<int> & ct = t;
+		auto it = std::ranges::find(ct.columnRange(2), 9);
+		CPPUNIT_ASSERT_EQUAL(std::ptrdiff_t(3), it - ct.columnRange(2).begin());
+
+		// Rows come as spans
+		int sum = 0;
+		for (std::span<const int> r : ct.rowRange()) sum += r[0] + r[2];
+		CPPUNIT_ASSERT_EQUAL(40, sum);
+		CPPUNIT_ASSERT_EQUAL(size_t(5), t.rowRange().size());
+		t.rowRange()[4][0] = 42;
+		CPPUNIT_ASSERT_EQUAL(42, t(0, 4));
+		auto big = std::ranges::count_if(t.rowRange(), [](std::span<int> r_i) { return r_i[2] > 3; });
+		CPPUNIT_ASSERT_EQUAL(std::ptrdiff_t(3), big);
+	}
+
+	void memory()
+	{
+		const int64_t before = Fs2a::MemoryTally::live();
+		Fs2a::MemoryTally::resetPeak();
+		{
+			Fs2a::Table<std::string> t;
+			t.columns(2);
+			t.reserve(100);
+			const int64_t cells = 200 * sizeof(std::string);
+			CPPUNIT_ASSERT(Fs2a::MemoryTally::live() - before >= cells);
+
+			// Long strings are only found by measuring
+			t.emplaceRow(std::string(100, 'x'), "short");
+			const int64_t unmeasured = Fs2a::MemoryTally::live() - before;
+			const size_t used = t.memoryUsage();
+			CPPUNIT_ASSERT(used >= size_t(cells) + 101);
+			CPPUNIT_ASSERT_EQUAL(unmeasured, Fs2a::MemoryTally::live() - before);
+			CPPUNIT_ASSERT_EQUAL(used, t.updateAccount());
+			CPPUNIT_ASSERT_EQUAL(int64_t(used), Fs2a::MemoryTally::live() - before);
+
+			// Shrinking doesn't free anything until compacting
+			t.rows(1);
+			t(0, 0) = "short";
+			CPPUNIT_ASSERT_EQUAL(used, t.memoryUsage());
+			const size_t compacted = t.compact();
+			CPPUNIT_ASSERT(compacted < used);
+			CPPUNIT_ASSERT_EQUAL(int64_t(compacted), Fs2a::MemoryTally::live() - before);
+
+			// Copies account for themselves, moves take the account along
+			Fs2a::Table<std::string> c(t), m(std::move(c));
+			CPPUNIT_ASSERT_EQUAL(int64_t(2 * compacted), Fs2a::MemoryTally::live() - before);
+			CPPUNIT_ASSERT(Fs2a::MemoryTally::peak() - before >= int64_t(used));
+		}
+		CPPUNIT_ASSERT_EQUAL(before, Fs2a::MemoryTally::live());
+	}
+
 };
 
 #undef CHECKNAME
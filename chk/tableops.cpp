@@ -0,0 +1,221 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <fs2a/TableOps.hpp>
+#include <fs2a/readCSV.hpp>
+
+#define CHECKNAME tableopsCheck
+
+class CHECKNAME;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CHECKNAME);
+
+class CHECKNAME : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CHECKNAME);
+	CPPUNIT_TEST(join);
+	CPPUNIT_TEST(joinKeys);
+	CPPUNIT_TEST(aggregate);
+	CPPUNIT_TEST(parallel);
+	CPPUNIT_TEST(columns);
+	CPPUNIT_TEST(diff);
+	CPPUNIT_TEST(diffParallel);
+	CPPUNIT_TEST_SUITE_END();
+
+	Fs2a::HeaderedTable load_(const std::string & csv_i) {
+		std::stringstream sss(csv_i);
+		return Fs2a::readCSV(sss, ';');
+	}
+
+	std::vector<std::string> rows_(Fs2a::HeaderedTable & table_i) {
+		std::vector<std::string> res;
+		for (uint32_t r = 0; r < table_i.rows(); r++) {
+			std::string row;
+			for (Fs2a::colidx_t c = 0; c < table_i.columns(); c++) row += (c ? "," : "") + table_i.cell(c, r);
+			res.push_back(row);
+		}
+		return res;
+	}
+
+	public:
+
+	void join() {
+		Fs2a::HeaderedTable l = load_("id;name\n1;a\n2;b\n3;c\n2;d\n");
+		Fs2a::HeaderedTable r = load_("id;name;amount\n2;x;10\n1;y;20\n2;z;30\n");
+		const std::vector<std::string> keys = { "id" };
+
+		Fs2a::HeaderedTable i = Fs2a::hashJoin(l, r, keys);
+		CPPUNIT_ASSERT(rows_(i) == std::vector<std::string>({ "id,name,name_0,amount", "1,a,y,20", "2,b,x,10",
+			"2,b,z,30", "2,d,x,10", "2,d,z,30" }));
+
+		Fs2a::HeaderedTable j = Fs2a::hashJoin(l, r, keys, Fs2a::leftJoin);
+		CPPUNIT_ASSERT(rows_(j) == std::vector<std::string>({ "id,name,name_0,amount", "1,a,y,20", "2,b,x,10",
+			"2,b,z,30", "3,c,,", "2,d,x,10", "2,d,z,30" }));
+
+		Fs2a::HeaderedTable a = Fs2a::hashJoin(l, r, keys, Fs2a::antiJoin);
+		CPPUNIT_ASSERT(rows_(a) == std::vector<std::string>({ "id,name", "3,c" }));
+
+		CPPUNIT_ASSERT_THROW(Fs2a::hashJoin(l, r, {}), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::hashJoin(l, r, std::vector<std::string>{ "amount" }), std::invalid_argument);
+	}
+
+	void joinKeys() {
+		// Composite keys can't be fooled by separators in values
+		Fs2a::HeaderedTable l = load_("a;b;v\nx;yz;1\nxy;z;2\n");
+		Fs2a::HeaderedTable r = load_("b;a;w\nz;xy;3\nyz;x;4\n");
+		Fs2a::HeaderedTable i = Fs2a::hashJoin(l, r, std::vector<std::string>{ "a", "b" });
+		CPPUNIT_ASSERT(rows_(i) == std::vector<std::string>({ "a,b,v,w", "x,yz,1,4", "xy,z,2,3" }));
+	}
+
+	void aggregate() {
+		using Fs2a::GroupBy;
+		Fs2a::HeaderedTable t = load_("cur;amount\nUSD;2\nEUR;1\nEUR;x\nUSD;\nEUR;9007199254740993\nGBP;1.5\nGBP;-2\n");
+
+		Fs2a::HeaderedTable g = Fs2a::groupBy(t, std::vector<std::string>{ "cur" }).agg({
+			{ GroupBy::count, "", "" },
+			{ GroupBy::count, "amount", "values" },
+			{ GroupBy::sum, "amount", "" },
+			{ GroupBy::min, "amount", "" },
+			{ GroupBy::max, "amount", "" },
+		});
+		CPPUNIT_ASSERT(rows_(g) == std::vector<std::string>({ "cur,count,values,sum_amount,min_amount,max_amount",
+			"USD,2,1,2,2,2", "EUR,3,3,9007199254740994,1,9007199254740993", "GBP,2,2,-0.5,-2,1.5" }));
+
+		CPPUNIT_ASSERT_THROW(Fs2a::groupBy(t, std::vector<std::string>{ "nope" }), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::groupBy(t, std::vector<std::string>{ "cur" }).agg({{ GroupBy::sum, "", "" }}),
+			std::invalid_argument);
+	}
+
+	void parallel() {
+		std::mt19937 rng(36);
+		Fs2a::HeaderedTable t, k;
+		t.columns(3);
+		t.emplaceRow("key", "sub", "amount");
+		for (uint32_t i = 0; i < 100000; i++) {
+			t.emplaceRow(std::to_string(rng() % 500), std::to_string(rng() % 3), std::to_string(rng() % 1000));
+		}
+		k.columns(2);
+		k.emplaceRow("key", "label");
+		for (uint32_t i = 0; i < 500; i += 2) k.emplaceRow(std::to_string(i), "l" + std::to_string(i));
+
+		// The number of threads doesn't change the results or their order
+		const std::vector<std::string> keys = { "key" }, groups = { "key", "sub" };
+		for (const Fs2a::join_e kind : { Fs2a::innerJoin, Fs2a::leftJoin, Fs2a::antiJoin }) {
+			Fs2a::HeaderedTable s = Fs2a::hashJoin(t, k, keys, kind, 1), p = Fs2a::hashJoin(t, k, keys, kind, 4);
+			CPPUNIT_ASSERT(rows_(s) == rows_(p));
+		}
+		const std::vector<Fs2a::GroupBy::aggregate_t> aggs = {
+			{ Fs2a::GroupBy::count, "", "" }, { Fs2a::GroupBy::sum, "amount", "" }, { Fs2a::GroupBy::max, "amount", "" } };
+		Fs2a::HeaderedTable s = Fs2a::groupBy(t, groups).agg(aggs, 1), p = Fs2a::groupBy(t, groups).agg(aggs, 4);
+		CPPUNIT_ASSERT(rows_(s) == rows_(p));
+		CPPUNIT_ASSERT_EQUAL(1501U, s.rows());
+		CPPUNIT_ASSERT_EQUAL(t.cell(0, 1), s.cell(0, 1));
+	}
+
+	void columns() {
+		using Fs2a::GroupBy;
+		using T = Fs2a::ColumnTable;
+		const std::string csv = "cur;status;amount\nUSD;open;2\nEUR;open;1\nEUR;;3\nUSD;open;\nEUR;open;9007199254740993\n"
+			"GBP;closed;1\n";
+		Fs2a::HeaderedTable h = load_(csv);
+		T t = T::fromTable(h, { T::text, T::text, T::integer });
+
+		// Grouping on codes gives the same groups as grouping on strings
+		const std::vector<GroupBy::aggregate_t> aggs = {
+			{ GroupBy::count, "", "" }, { GroupBy::count, "amount", "values" }, { GroupBy::sum, "amount", "" },
+			{ GroupBy::max, "amount", "" } };
+		for (const std::vector<std::string> & keys : std::vector<std::vector<std::string>>{ { "cur" }, { "cur", "status" } }) {
+			Fs2a::HeaderedTable s = Fs2a::groupBy(h, keys).agg(aggs), c = Fs2a::groupBy(t, keys).agg(aggs, 1);
+			CPPUNIT_ASSERT(rows_(s) == rows_(c));
+		}
+		Fs2a::HeaderedTable g = Fs2a::groupBy(t, std::vector<std::string>{ "status" }).agg(aggs);
+		CPPUNIT_ASSERT(rows_(g) == std::vector<std::string>({ "status,count,values,sum_amount,max_amount",
+			"open,4,3,9007199254740996,9007199254740993", ",1,1,3,3", "closed,1,1,1,1" }));
+
+		CPPUNIT_ASSERT_THROW(Fs2a::groupBy(t, std::vector<std::string>{ "nope" }), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::groupBy(t, std::vector<std::string>{ "cur" }).agg({{ GroupBy::max, "nope", "" }}),
+			std::invalid_argument);
+	}
+
+	void diff() {
+		Fs2a::HeaderedTable o = load_("id;name;amount\n1;a;10\n2;b;20\n3;c;30\n4;d;40\n");
+		Fs2a::HeaderedTable n = load_("amount;id;name\n10;1;a\n25;2;b\n50;5;e\n40;4;D\n");
+		const std::vector<std::string> keys = { "id" };
+
+		// Columns follow the new table, the order of the old one doesn't matter
+		Fs2a::HeaderedTable d = Fs2a::diff(o, n, keys);
+		CPPUNIT_ASSERT(rows_(d) == std::vector<std::string>({ "change,changed,amount,id,name", "changed,amount,25,2,b",
+			"inserted,,50,5,e", "changed,name,40,4,D", "deleted,,30,3,c" }));
+
+		Fs2a::HeaderedTable same = Fs2a::diff(o, o, keys);
+		CPPUNIT_ASSERT_EQUAL(1U, same.rows());
+
+		Fs2a::HeaderedTable dup = load_("id;name;amount\n1;a;10\n1;b;20\n");
+		Fs2a::HeaderedTable other = load_("id;name;value\n1;a;10\n");
+		CPPUNIT_ASSERT_THROW(Fs2a::diff(dup, n, keys), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::diff(o, dup, keys), std::invalid_argument);
+		Fs2a::HeaderedTable dupNew = load_("id;name;amount\n1;a;10\n6;b;20\n6;c;30\n");
+		CPPUNIT_ASSERT_THROW(Fs2a::diff(o, dupNew, keys), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::diff(o, dupNew, keys, 2), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::diff(o, other, keys), std::invalid_argument);
+		CPPUNIT_ASSERT_THROW(Fs2a::diff(o, n, {}), std::invalid_argument);
+	}
+
+	void diffParallel() {
+		std::mt19937 rng(45);
+		Fs2a::HeaderedTable o, n;
+		o.columns(3);
+		n.columns(3);
+		o.emplaceRow("a", "b", "v");
+		n.emplaceRow("a", "b", "v");
+		size_t expect = 0;
+		for (uint32_t i = 0; i < 60000; i++) {
+			const std::string a = std::to_string(i % 1000), b = std::to_string(i / 1000), v = std::to_string(rng() % 100);
+			const uint32_t dice = rng() % 10;
+			if (dice != 0) o.emplaceRow(a, b, v);
+			if (dice != 1) n.emplaceRow(a, b, dice == 2 ? v + "x" : v);
+			expect += dice < 3;
+		}
+
+		// The number of threads doesn't change the results or their order
+		const std::vector<std::string> keys = { "a", "b" };
+		Fs2a::HeaderedTable s = Fs2a::diff(o, n, keys, 1), p = Fs2a::diff(o, n, keys, 4);
+		CPPUNIT_ASSERT(rows_(s) == rows_(p));
+		CPPUNIT_ASSERT_EQUAL(uint32_t(expect + 1), s.rows());
+	}
+
+};
+
+#undef CHECKNAME
@@ -0,0 +1,177 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <fs2a/MappedFile.hpp>
+#include <fs2a/StringArena.hpp>
+#include <fs2a/Table.hpp>
+
+namespace Fs2a {
+
+	/** Table of strings whose cells are views into an arena owned by the table.
+	 * Compared to Table<std::string>, storing a cell doesn't need a heap allocation, and
+	 * destroying the table frees all cells at once per arena chunk. Use set() or store() to
+	 * put strings in the table. Assigning a view to cell() directly is allowed, but then the
+	 * viewed string should outlive the table, e.g. because it is in a file retained by it. */
+	class ArenaTable : public Table<std::string_view>
+	{
+		protected:
+		/// Storage for all cell contents
+		StringArena arena_;
+
+		/// Mapped file that cells may view into, see retain()
+		std::shared_ptr<const MappedFile> file_;
+
+		/** Memory of the arena.
+		 * @see Table::ownedBytes_() */
+		virtual size_t ownedBytes_() const override
+		{
+			return arena_.capacity() + arena_.chunks() * sizeof(std::unique_ptr<char[]>);
+		}
+
+		public:
+		/// Constructor
+		ArenaTable() = default;
+
+		/// Copy constructor, copies all cells into the arena of the new table
+		ArenaTable(const ArenaTable & obj_i);
+
+		/// Move constructor, cells keep pointing into the moved arena
+		ArenaTable(ArenaTable && obj_io) = default;
+
+		/// Conversion from a table of strings
+		explicit ArenaTable(const Table<std::string> & obj_i);
+
+		/// Destructor
+		virtual ~ArenaTable() = default;
+
+		/// Copy assignment, copies all cells into the arena of this table
+		ArenaTable & operator=(const ArenaTable & obj_i);
+
+		/// Move assignment
+		ArenaTable & operator=(ArenaTable && obj_io) = default;
+
+		/// Read access to the arena, e.g. for its capacity
+		inline const StringArena & arena() const { return arena_; }
+
+		/** Keep a mapped file alive for as long as cells may view into it.
+		 * Copies of the table and compact() copy all cells into an arena, and don't keep the
+		 * file. Mapped memory is not part of memoryUsage().
+		 * @param file_i Mapped file */
+		inline void retain(std::shared_ptr<const MappedFile> file_i) { file_ = std::move(file_i); }
+
+		/// Mapped file retained by the table, nullptr if none
+		inline const std::shared_ptr<const MappedFile> & retained() const { return file_; }
+
+		/** Set a cell to a copy of a string, increasing the number of rows if necessary.
+		 * @param column_i Column of field to set, zero based
+		 * @param row_i Row of field to set, zero based
+		 * @param value_i String to copy into the arena
+		 * @throws std::out_of_range if requested column is outside of column range. */
+		inline void set(const colidx_t column_i, const uint32_t row_i, std::string_view value_i)
+		{
+			cell(column_i, row_i) = store(value_i);
+		}
+
+		/** Copy a string into the arena of this table.
+		 * @param value_i String to copy
+		 * @returns View of the copy, valid for the lifetime of this table */
+		inline std::string_view store(std::string_view value_i)
+		{
+			const size_t capacity = arena_.capacity();
+			std::string_view v = arena_.store(value_i);
+			if (arena_.capacity() != capacity) updateAccount_();
+			return v;
+		}
+
+		/** Release unused memory and store every distinct string only once, in a new arena.
+		 * Cells that viewed strings outside the arena are copied into it, and a retained file
+		 * is let go of.
+		 * @see Table::compact() */
+		virtual size_t compact() override;
+
+		/** Convert to a table of strings.
+		 * @returns Table with a copy of every cell */
+		Table<std::string> toTable() const;
+	};
+
+	/** ArenaTable with the first row as column names, like HeaderedTable. */
+	class HeaderedArenaTable : public ArenaTable
+	{
+		protected:
+		/// Map of strings to column indices to mimic associative columns.
+		std::unordered_map<std::string, colidx_t> hdrs_;
+
+		/** Read the column headers for associative column addressing, making them unique. */
+		void readHeaders_();
+
+		/** Heap memory of the header map.
+		 * @see Table::measureBytes_() */
+		virtual size_t measureBytes_() const override;
+
+		public:
+		/// Constructor
+		HeaderedArenaTable() = default;
+
+		/// Copy constructor from superclass
+		HeaderedArenaTable(const ArenaTable & obj_i)
+		: ArenaTable(obj_i)
+		{}
+
+		/// Move constructor from superclass
+		HeaderedArenaTable(ArenaTable && obj_io)
+		: ArenaTable(std::move(obj_io))
+		{}
+
+		/// @{ Copying and moving, made explicit because of the virtual destructor
+		HeaderedArenaTable(const HeaderedArenaTable &) = default;
+		HeaderedArenaTable(HeaderedArenaTable &&) = default;
+		HeaderedArenaTable & operator=(const HeaderedArenaTable &) = default;
+		HeaderedArenaTable & operator=(HeaderedArenaTable &&) = default;
+		/// @}
+
+		/// Destructor
+		virtual ~HeaderedArenaTable() = default;
+
+		/// Explicitly inherit the Table::cell() method, otherwise it is hidden.
+		using ArenaTable::cell;
+
+		/** Reference a cell by row number and column name.
+		 * @param colname_i Column name to reference.
+		 * @param row_i Row number to reference, header is row 0. */
+		virtual std::string_view & cell(const std::string & colname_i, const uint32_t row_i);
+	};
+
+} // Fs2a namespace
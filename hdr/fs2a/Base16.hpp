@@ -0,0 +1,246 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+namespace Fs2a {
+
+	/** Hexadecimal (Base16) encoding and decoding kernels.
+	 * Next to a plain table lookup kernel, vectorized kernels are available
+	 * on x86 that translate nibbles to digits with PSHUFB lookups. The
+	 * fastest kernel supported by the CPU is selected at runtime. Decoding
+	 * accepts both upper and lower case digits. */
+	class Base16
+	{
+		public:
+		/// Available kernels
+		enum kernel_e : uint8_t {
+			scalar, ///< Table lookups, available everywhere
+			ssse3,  ///< 16 bytes per step with SSSE3
+			avx2,   ///< 32 bytes per step with AVX2
+			best    ///< Fastest kernel supported by this CPU
+		};
+
+		/** Number of characters encoding a given number of bytes.
+		 * @param len_i Number of bytes
+		 * @returns Number of hexadecimal digits */
+		static constexpr size_t encodedLength(const size_t len_i) { return len_i * 2; }
+
+		/** Number of bytes a given number of digits decode to.
+		 * @param len_i Number of hexadecimal digits
+		 * @returns Number of bytes */
+		static constexpr size_t decodedLength(const size_t len_i) { return len_i / 2; }
+
+		/** Check whether a kernel can run on this CPU.
+		 * @param kernel_i Kernel to check
+		 * @returns True if supported, always true for scalar and best. */
+		static bool supported(const kernel_e kernel_i);
+
+		/** Encode bytes to hexadecimal digits.
+		 * @param in_i Input bytes
+		 * @param len_i Number of input bytes
+		 * @param out_o Output, room for encodedLength(len_i) characters needed
+		 * @param upper_i Use upper case digits A-F instead of a-f
+		 * @param kernel_i Kernel to use, default best
+		 * @throws std::invalid_argument when the kernel isn't supported. */
+		static void encode(const uint8_t * in_i, const size_t len_i, char * out_o,
+			const bool upper_i = false, const kernel_e kernel_i = best);
+
+		/** Decode hexadecimal digits to bytes, stopping at the first pair
+		 * with an invalid digit.
+		 * @param in_i Hexadecimal digits
+		 * @param len_i Number of digits, a trailing odd digit is ignored
+		 * @param out_o Output, room for decodedLength(len_i) bytes needed
+		 * @param kernel_i Kernel to use, default best
+		 * @returns Number of digits decoded, which is @p len_i rounded down to
+		 * an even number when all digits were valid.
+		 * @throws std::invalid_argument when the kernel isn't supported. */
+		static size_t decode(const char * in_i, const size_t len_i, uint8_t * out_o,
+			const kernel_e kernel_i = best);
+	};
+
+	/** Encode data as hexadecimal digits into a caller supplied buffer,
+	 * without allocating.
+	 * @param data_i Data to encode
+	 * @param out_o Output buffer, at least twice the size of @p data_i
+	 * @param upper_i Use upper case digits, default false
+	 * @returns Number of characters written
+	 * @throws std::length_error when @p out_o is too small. */
+	size_t base16encode(std::span<const std::byte> data_i, std::span<char> out_o, const bool upper_i = false);
+
+	/** Decode hexadecimal digits into a caller supplied buffer, without
+	 * allocating.
+	 * @param hex_i Digits to decode, upper or lower case
+	 * @param out_o Output buffer, at least half the size of @p hex_i
+	 * @returns Number of bytes written
+	 * @throws std::length_error when @p out_o is too small.
+	 * @throws std::runtime_error on an odd number of digits or an invalid
+	 * digit. */
+	size_t base16decode(std::string_view hex_i, std::span<std::byte> out_o);
+
+	/** Encode data to a hexadecimal std::string.
+	 * @param T Choose either char, unsigned char or std::byte
+	 * @param data_i Pointer to data
+	 * @param len_i Length in bytes of data
+	 * @param upper_i Use upper case digits, default false
+	 * @returns The data as hexadecimal string. */
+	template <typename T>
+	std::string base16encode(const T * data_i, const size_t len_i, const bool upper_i = false)
+	{
+		static_assert(sizeof(T) == 1, "Base16 encodes single bytes");
+
+		std::string out(Base16::encodedLength(len_i), '\0');
+		Base16::encode(reinterpret_cast<const uint8_t *>(data_i), len_i, out.data(), upper_i);
+		return out;
+	}
+
+	/** Decode a hexadecimal string back to its original.
+	 * @param T the vector data type to return, can be either std::byte,
+	 * unsigned char or char.
+	 * @param hex_i Hexadecimal digits to decode
+	 * @returns Vector with the decoded bytes
+	 * @throws std::runtime_error on an odd number of digits or an invalid
+	 * digit. */
+	template <typename T>
+	std::vector<T> base16decode(const std::string & hex_i)
+	{
+		static_assert(sizeof(T) == 1, "Base16 decodes to a vector of single bytes");
+
+		std::vector<T> data(Base16::decodedLength(hex_i.size()));
+		base16decode(hex_i, std::as_writable_bytes(std::span<T>(data)));
+		return data;
+	}
+
+	/** Data to be formatted as hexadecimal digits, without creating a
+	 * temporary string. Usable with libFmt, and thereby the logging macros,
+	 * with std::ostream and with CsvWriter::field(). The data is not copied,
+	 * so it should outlive the view. */
+	class Base16View
+	{
+		protected:
+		/// Data to format
+		std::span<const std::byte> data_;
+
+		/// Whether to use upper case digits
+		bool upper_;
+
+		public:
+		/** Constructor.
+		 * @param data_i Data to format
+		 * @param upper_i Use upper case digits, default false */
+		Base16View(std::span<const std::byte> data_i, const bool upper_i = false)
+		: data_(data_i), upper_(upper_i)
+		{}
+
+		/// Data to format
+		inline std::span<const std::byte> data() const { return data_; }
+
+		/// Whether upper case digits are used
+		inline bool upper() const { return upper_; }
+
+		/** Write the digits to an output iterator in blocks, via a small
+		 * buffer on the stack.
+		 * @param out_i Output iterator
+		 * @param upper_i Use upper case digits
+		 * @returns Output iterator after the last digit */
+		template <typename OutputIt>
+		OutputIt write(OutputIt out_i, const bool upper_i) const
+		{
+			char buf[512];
+			const uint8_t * d = reinterpret_cast<const uint8_t *>(data_.data());
+
+			for (size_t i = 0; i < data_.size(); i += sizeof(buf) / 2) {
+				size_t n = std::min(sizeof(buf) / 2, data_.size() - i);
+				Base16::encode(d + i, n, buf, upper_i);
+				out_i = std::copy(buf, buf + n * 2, out_i);
+			}
+			return out_i;
+		}
+	};
+
+	/** Create a view to format data as hexadecimal digits, for example
+	 * FI("Hash {}", Fs2a::hex(digest, sizeof(digest))).
+	 * @param data_i Pointer to the data
+	 * @param len_i Length of the data in bytes
+	 * @param upper_i Use upper case digits, default false
+	 * @returns View on the data */
+	inline Base16View hex(const void * data_i, const size_t len_i, const bool upper_i = false)
+	{
+		return Base16View(std::span<const std::byte>(static_cast<const std::byte *>(data_i), len_i), upper_i);
+	}
+
+	/** Create a view to format a string or other contiguous range of single
+	 * bytes as hexadecimal digits. Use {:X} to format with upper case digits.
+	 * @param range_i Data to format
+	 * @returns View on the data */
+	template <std::ranges::contiguous_range R>
+	Base16View hex(const R & range_i)
+	{
+		static_assert(sizeof(*std::ranges::data(range_i)) == 1, "Only ranges of single bytes can be formatted as hex");
+		return hex(std::ranges::data(range_i), std::ranges::size(range_i));
+	}
+
+	/** Write data as hexadecimal digits to an output stream.
+	 * @param os_i Stream to write to
+	 * @param view_i Data to write
+	 * @returns The stream */
+	std::ostream & operator<<(std::ostream & os_i, const Base16View & view_i);
+
+} // Fs2a namespace
+
+/** Formatter for hexadecimal views, use {:X} for upper and {:x} for lower
+ * case digits. Without a type, the case of the view is used. */
+template <> struct fmt::formatter<Fs2a::Base16View> {
+	/// Requested case: 0 for the view's own, 'x' or 'X'
+	char type = 0;
+
+	constexpr auto parse(format_parse_context & ctx) {
+		auto it = ctx.begin();
+		if (it != ctx.end() && (*it == 'x' || *it == 'X')) type = *it++;
+		if (it != ctx.end() && *it != '}') throw format_error("invalid format for hex view");
+		return it;
+	}
+
+	template <typename FormatContext>
+	auto format(const Fs2a::Base16View & view_i, FormatContext & ctx) const {
+		return view_i.write(ctx.out(), type ? type == 'X' : view_i.upper());
+	}
+};
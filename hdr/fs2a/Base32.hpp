@@ -0,0 +1,270 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Fs2a {
+
+	/** Base32 policy, see RFC 4648. A policy is any type with these static
+	 * constexpr members:
+	 * - alphabet: 32 distinct upper case characters or digits
+	 * - padding: whether encoding pads to a multiple of 8 characters with
+	 *   '=' and decoding requires that
+	 * @param Hex Use the extended hex alphabet instead of the standard one */
+	template <bool Hex, bool Padding>
+	struct Base32Policy
+	{
+		static constexpr const char * alphabet = Hex ?
+			"0123456789ABCDEFGHIJKLMNOPQRSTUV" : "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+		static constexpr bool padding = Padding;
+	};
+
+	/// RFC 4648 section 6 Base32
+	typedef Base32Policy<false, true> Base32Std;
+
+	/// RFC 4648 section 7 Base32 with the extended hex alphabet, which keeps the sort order
+	typedef Base32Policy<true, true> Base32Hex;
+
+	/// RFC 4648 section 6 alphabet without padding, as used for TOTP secrets
+	typedef Base32Policy<false, false> Base32Unpadded;
+
+	/** Base32 encoding and decoding kernels for a given policy.
+	 * Five bytes are handled at once as a 40-bit word. Lookup tables are
+	 * generated at compile time, decoding accepts lower case letters too.
+	 * @param P Base32 policy, see Base32Policy. */
+	template <typename P>
+	class Base32Codec
+	{
+		public:
+		/// Decode table value for invalid characters
+		static constexpr uint8_t invalid = 0xFF;
+
+		/// Encoding table
+		static constexpr std::array<char, 32> enc = [] {
+			std::array<char, 32> t{};
+			for (uint8_t i = 0; i < 32; i++) t[i] = P::alphabet[i];
+			return t;
+		}();
+
+		/// Decoding table, alphabet characters map to 0-31
+		static constexpr std::array<uint8_t, 256> dec = [] {
+			std::array<uint8_t, 256> t{};
+			for (auto & v : t) v = invalid;
+			for (uint8_t i = 0; i < 32; i++) {
+				char c = P::alphabet[i];
+				t[static_cast<uint8_t>(c)] = i;
+				if (c >= 'A' && c <= 'Z') t[static_cast<uint8_t>(c - 'A' + 'a')] = i;
+			}
+			return t;
+		}();
+
+		/** Number of characters encoding a given number of bytes.
+		 * @param len_i Number of bytes to encode
+		 * @returns Exact number of Base32 characters */
+		static constexpr size_t encodedLength(const size_t len_i)
+		{
+			if (P::padding) return (len_i + 4) / 5 * 8;
+			return len_i / 5 * 8 + (len_i % 5 * 8 + 4) / 5;
+		}
+
+		/** Maximum number of bytes a number of Base32 characters decode to.
+		 * @param len_i Number of Base32 characters
+		 * @returns Upper limit of decoded bytes */
+		static constexpr size_t decodedLength(const size_t len_i)
+		{
+			return len_i / 8 * 5 + len_i % 8 * 5 / 8;
+		}
+
+		/** Encode data.
+		 * @param in_i Input bytes
+		 * @param len_i Number of input bytes
+		 * @param out_o Output, room for encodedLength(len_i) characters needed
+		 * @returns Number of characters written */
+		static size_t encode(const uint8_t * in_i, const size_t len_i, char * out_o)
+		{
+			size_t i = 0, o = 0;
+
+			for (; i + 5 <= len_i; i += 5, o += 8) {
+				uint64_t v = (uint64_t(in_i[i]) << 32) | (uint64_t(in_i[i+1]) << 24) |
+					(uint64_t(in_i[i+2]) << 16) | (uint64_t(in_i[i+3]) << 8) | in_i[i+4];
+				for (int c = 0; c < 8; c++) out_o[o+c] = enc[(v >> (35 - 5*c)) & 0x1F];
+			}
+
+			if (i < len_i) {
+				// Left align the remaining bytes in a 40-bit word
+				uint64_t v = 0;
+				size_t rem = len_i - i, chars = (rem * 8 + 4) / 5;
+				for (size_t b = 0; b < rem; b++) v |= uint64_t(in_i[i+b]) << (32 - 8*b);
+				for (size_t c = 0; c < chars; c++) out_o[o++] = enc[(v >> (35 - 5*c)) & 0x1F];
+				if (P::padding) for (size_t c = chars; c < 8; c++) out_o[o++] = '=';
+			}
+			return o;
+		}
+
+		/** Decode Base32 characters.
+		 * @param in_i Base32 characters
+		 * @param len_i Number of characters
+		 * @param out_o Output, room for decodedLength(len_i) bytes needed
+		 * @returns Number of bytes written
+		 * @throws std::runtime_error on invalid characters, length or padding. */
+		static size_t decode(const char * in_i, const size_t len_i, uint8_t * out_o)
+		{
+			const uint8_t * in = reinterpret_cast<const uint8_t *>(in_i);
+			size_t sig = len_i, i = 0, o = 0;
+
+			if (P::padding) {
+				if (len_i % 8) throw std::runtime_error("Base32 data is not padded to a multiple of 8 characters");
+				while (sig && in_i[sig-1] == '=' && len_i - sig < 6) sig--;
+			}
+			// Valid numbers of characters in the last group
+			switch (sig % 8) {
+				case 1:
+				case 3:
+				case 6:
+					throw std::runtime_error("Base32 data has an invalid length of " + std::to_string(sig));
+
+				default:
+					break;
+			}
+
+			for (; i + 8 <= sig; i += 8, o += 5) {
+				uint64_t v = 0;
+				uint8_t chk = 0;
+				for (int c = 0; c < 8; c++) {
+					chk |= dec[in[i+c]];
+					v = (v << 5) | (dec[in[i+c]] & 0x1F);
+				}
+				if (chk & 0xE0) unknown_(in_i, i);
+				for (int b = 0; b < 5; b++) out_o[o+b] = static_cast<uint8_t>(v >> (32 - 8*b));
+			}
+
+			if (i < sig) {
+				uint64_t v = 0;
+				size_t rem = sig - i;
+				for (size_t c = 0; c < 8; c++) {
+					uint8_t d = c < rem ? dec[in[i+c]] : 0;
+					if (d & 0xE0) unknown_(in_i, i);
+					v = (v << 5) | d;
+				}
+				for (size_t b = 0; b < rem * 5 / 8; b++) out_o[o++] = static_cast<uint8_t>(v >> (32 - 8*b));
+			}
+			return o;
+		}
+
+		protected:
+		/** Throw the error for the first invalid character in a group.
+		 * @param in_i Input characters
+		 * @param from_i Start of the group containing the character */
+		[[noreturn]] static void unknown_(const char * in_i, size_t from_i)
+		{
+			while (dec[static_cast<uint8_t>(in_i[from_i])] != invalid) from_i++;
+			std::ostringstream oss;
+			oss << "Unknown Base32 character \"" << in_i[from_i] << "\" encountered at position " << from_i;
+			throw std::runtime_error(oss.str());
+		}
+	};
+
+	/** Encode data into a caller supplied buffer, without allocating.
+	 * @param P Base32 policy, default Base32Std
+	 * @param data_i Data to encode
+	 * @param out_o Output buffer, at least Base32Codec<P>::encodedLength()
+	 * characters long
+	 * @returns Number of characters written
+	 * @throws std::length_error when @p out_o is too small. */
+	template <typename P = Base32Std>
+	size_t base32encode(std::span<const std::byte> data_i, std::span<char> out_o)
+	{
+		if (out_o.size() < Base32Codec<P>::encodedLength(data_i.size())) {
+			throw std::length_error("Output buffer too small for Base32 encoding");
+		}
+		return Base32Codec<P>::encode(reinterpret_cast<const uint8_t *>(data_i.data()), data_i.size(), out_o.data());
+	}
+
+	/** Decode Base32 into a caller supplied buffer, without allocating.
+	 * @param P Base32 policy, default Base32Std
+	 * @param b32_i Base32 characters to decode
+	 * @param out_o Output buffer, at least Base32Codec<P>::decodedLength()
+	 * bytes long
+	 * @returns Number of bytes written
+	 * @throws std::length_error when @p out_o is too small.
+	 * @throws std::runtime_error on invalid input. */
+	template <typename P = Base32Std>
+	size_t base32decode(std::string_view b32_i, std::span<std::byte> out_o)
+	{
+		if (out_o.size() < Base32Codec<P>::decodedLength(b32_i.size())) {
+			throw std::length_error("Output buffer too small for Base32 decoding");
+		}
+		return Base32Codec<P>::decode(b32_i.data(), b32_i.size(), reinterpret_cast<uint8_t *>(out_o.data()));
+	}
+
+	/** Encode data to a Base32 std::string.
+	 * @param T Choose either char, unsigned char or std::byte
+	 * @param P Base32 policy, default Base32Std
+	 * @param data_i Pointer to data
+	 * @param len_i Length in bytes of data
+	 * @returns The data encoded as Base32 string. */
+	template <typename T, typename P = Base32Std>
+	std::string base32encode(const T * data_i, const size_t len_i)
+	{
+		static_assert(sizeof(T) == 1, "Base32 encodes single bytes");
+
+		std::string out(Base32Codec<P>::encodedLength(len_i), '\0');
+		Base32Codec<P>::encode(reinterpret_cast<const uint8_t *>(data_i), len_i, out.data());
+		return out;
+	}
+
+	/** Decode Base32 data back to its original.
+	 * @param T the vector data type to return, can be either std::byte,
+	 * unsigned char or char.
+	 * @param P Base32 policy, default Base32Std
+	 * @param b32_i The Base32-encoded data to be decoded.
+	 * @returns Vector with the decoded bytes
+	 * @throws std::runtime_error on invalid input. */
+	template <typename T, typename P = Base32Std>
+	std::vector<T> base32decode(const std::string & b32_i)
+	{
+		static_assert(sizeof(T) == 1, "Base32 decodes to a vector of single bytes");
+
+		std::vector<T> data(Base32Codec<P>::decodedLength(b32_i.size()));
+		data.resize(Base32Codec<P>::decode(b32_i.data(), b32_i.size(), reinterpret_cast<uint8_t *>(data.data())));
+		return data;
+	}
+
+} // Fs2a namespace
@@ -29,171 +29,808 @@ vim:set ts=4 sw=4 noexpandtab: */
 
 #pragma once
 
-#include <cmath>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
-#include <memory>
-#include <vector>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <fs2a/Parallel.hpp>
 
 namespace Fs2a {
 
-	/** Decode base64-encoded data back to its original.
-	 * @param T the vector data type to return, can be either std::byte
-	 * (C++17), unsigned char or char.
-	 * @param b64_i The Base64-encoded data to be decoded.
-	 * @returns Vector of std::byte's. Access the bytes directly via the
-	 * data() member and the length via the size() member. */
-	template <typename T>
-	std::vector<T> base64decode(const std::string & b64_i) {
-		static const char b64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-		std::vector<T> data;
-		uint8_t offset=0; // Offset in base64 decoding, either 0, 1, 2 or 3
-		size_t i=0;
-		T b = 0x00; // Byte to build up
-		const char *p = nullptr;  // Pointer to found char in Base64 dictionary
-		T v = 0x00; // Value from Base64 data
-		std::ostringstream oss;
-
-		while (i < b64_i.size()) {
-			p = index(b64, b64_i[i]);
-			if (p == nullptr) {
-				switch (b64_i[i]) {
-					case '\r':
-					case '\n':
-						i++; continue;
-
-					case '\\':
-						/** When receiving data from PHP-generated HTTP
-						 * responses, PHP "automagically" adds backslashes to
-						 * any slash in the output. This is quite annoying,
-						 * but not many web developers seem to be aware of
-						 * this. So skip this character gracefully. */
-						i++; continue;
-
-					case '=':
-						switch (offset) {
-							case 0:
-							case 1:
-								throw std::runtime_error(
-									"Equal sign encountered while decoding first or second character "
-									"in base64 quad"
-								);
-
-							default:
-								// No further bytes available
-								break;
-						}
-						return data;
-
-					default:
-						break;
-				}
-				oss << "Unknown Base64 character \"" << b64_i[i];
-				oss << "\" encountered at position " << i;
-				throw std::runtime_error(oss.str());
+	/** Base64 policy as used by all codecs in this file.
+	 * A policy is any type with these static constexpr members, so custom
+	 * variants can be defined without using this template:
+	 * - alphabet: 64 distinct characters plus terminating NUL
+	 * - padding: whether encoding adds '=' and decoding accepts it
+	 * - strict: whether decoding rejects missing padding, data after
+	 *   padding and a dangling single character in the last quad
+	 * - skipNewlines: whether decoding skips \\r and \\n
+	 * - skipBackslash: whether decoding skips backslashes
+	 * @param C62 Character for index 62
+	 * @param C63 Character for index 63 */
+	template <char C62, char C63, bool Padding, bool Strict, bool SkipNewlines, bool SkipBackslash>
+	struct Base64Policy
+	{
+		static constexpr char alphabet[65] = {
+			'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
+			'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
+			'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
+			'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
+			'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', C62, C63, '\0'
+		};
+		static constexpr bool padding = Padding;
+		static constexpr bool strict = Strict;
+		static constexpr bool skipNewlines = SkipNewlines;
+		static constexpr bool skipBackslash = SkipBackslash;
+	};
+
+	/** The original behaviour of this file and the default everywhere:
+	 * padded output, while decoding skips newlines and the backslashes that
+	 * PHP "automagically" adds to any slash in HTTP responses. Everything
+	 * after padding is ignored. */
+	typedef Base64Policy<'+', '/', true, false, true, true> Base64Lenient;
+
+	/// RFC 4648 section 4 Base64, padding mandatory and nothing skipped.
+	typedef Base64Policy<'+', '/', true, true, false, false> Base64Strict;
+
+	/// RFC 4648 section 4 alphabet without padding.
+	typedef Base64Policy<'+', '/', false, true, false, false> Base64Unpadded;
+
+	/// RFC 4648 section 5 URL and filename safe alphabet without padding, as used by JWTs.
+	typedef Base64Policy<'-', '_', false, true, false, false> Base64Url;
+
+	/** Base64 encoding and decoding kernels for a given policy.
+	 * The lookup tables are generated at compile time per policy. Special
+	 * characters map to decode values with the upper two bits set, so the
+	 * inner loop needs only a single check per quad to stay on the fast path.
+	 * @param P Base64 policy, see Base64Policy. */
+	template <typename P>
+	class Base64Codec
+	{
+		public:
+		/// @{ Decode table values for non-alphabet characters
+		static constexpr uint8_t invalid = 0xFF;
+		static constexpr uint8_t skip = 0xFE;
+		static constexpr uint8_t pad = 0xFD;
+		/// @}
+
+		/// Decoding state to carry over between calls on chunked input
+		typedef struct state_s {
+			uint32_t quad = 0;    ///< Sextets of the current quad, most recent lowest
+			uint8_t offset = 0;   ///< Offset in the current quad, 0-3
+			uint8_t pads = 0;     ///< Padding characters still expected
+			bool padded = false;  ///< Whether padding was encountered
+			size_t pos = 0;       ///< Characters consumed so far, for errors
+		} state_t;
+
+		protected:
+		/// Build the decode table from the policy.
+		static constexpr std::array<uint8_t, 256> mkdec_()
+		{
+			std::array<uint8_t, 256> t{};
+
+			for (auto & v : t) v = invalid;
+			for (uint8_t i = 0; i < 64; i++) t[static_cast<uint8_t>(P::alphabet[i])] = i;
+			if (P::skipNewlines) t['\r'] = t['\n'] = skip;
+			if (P::skipBackslash) t['\\'] = skip;
+			if (P::padding) t['='] = pad;
+			return t;
+		}
+
+		/// Check the policy's alphabet for 64 distinct characters.
+		static constexpr bool valid_()
+		{
+			bool seen[256] = {};
+
+			for (uint8_t i = 0; i < 64; i++) {
+				uint8_t c = static_cast<uint8_t>(P::alphabet[i]);
+				if (seen[c] || c == '=' || c == '\0') return false;
+				seen[c] = true;
 			}
-			v = p - b64;
+			return P::alphabet[64] == '\0';
+		}
 
-			if (v & 0xC0) throw std::logic_error("Base64 character has index value larger than 64?");
+		static_assert(valid_(), "Base64 alphabet should consist of 64 distinct characters, excluding '='");
+
+		/** Throw the error for an unusable character.
+		 * @param c_i Offending character
+		 * @param pos_i Position in the input */
+		[[noreturn]] static void unknown_(const char c_i, const size_t pos_i)
+		{
+			std::ostringstream oss;
+			oss << "Unknown Base64 character \"" << c_i;
+			oss << "\" encountered at position " << pos_i;
+			throw std::runtime_error(oss.str());
+		}
 
-			/* Here the actual Base64 decoding starts. We are building up new
-			 * data bytes as Base64 comes in. Once a data byte is finished,
-			 * push it onto the vector. This assures we always have the latest
-			 * and complete data vector available for returning it. */
-			switch (offset) {
-				case 3:
-					b |= (v & 0x3F);
-					data.push_back(b);
-					b = 0x00;
-					break;
+		/** Write the bytes of an incomplete quad. A single sextet doesn't
+		 * make up a byte, so nothing is written for that.
+		 * @returns Number of bytes written */
+		static size_t partial_(state_t & st_io, uint8_t * out_o)
+		{
+			size_t o = 0;
+
+			if (st_io.offset == 2) {
+				out_o[o++] = static_cast<uint8_t>(st_io.quad >> 4);
+			} else if (st_io.offset == 3) {
+				out_o[o++] = static_cast<uint8_t>(st_io.quad >> 10);
+				out_o[o++] = static_cast<uint8_t>(st_io.quad >> 2);
+			}
+			st_io.quad = 0;
+			st_io.offset = 0;
+			return o;
+		}
 
-				case 2:
-					b |= ((v >> 2) & 0x0F);
-					data.push_back(b);
-					b = (v << 6) & 0xC0;
-					break;
+		public:
+		/// Encoding table
+		static constexpr std::array<char, 64> enc = [] {
+			std::array<char, 64> t{};
+			for (uint8_t i = 0; i < 64; i++) t[i] = P::alphabet[i];
+			return t;
+		}();
+
+		/// Decoding table, alphabet characters map to 0-63
+		static constexpr std::array<uint8_t, 256> dec = mkdec_();
+
+		/** Number of characters encoding a given number of bytes.
+		 * @param len_i Number of bytes to encode
+		 * @returns Exact number of Base64 characters */
+		static constexpr size_t encodedLength(const size_t len_i)
+		{
+			if (P::padding) return (len_i + 2) / 3 * 4;
+			return len_i / 3 * 4 + (len_i % 3 ? len_i % 3 + 1 : 0);
+		}
 
-				case 1:
-					b |= ((v >> 4) & 0x03);
-					data.push_back(b);
-					b = (v << 4) & 0xF0;
-					break;
+		/** Maximum number of bytes a number of Base64 characters decode to.
+		 * @param len_i Number of Base64 characters
+		 * @returns Upper limit of decoded bytes */
+		static constexpr size_t decodedLength(const size_t len_i)
+		{
+			return (len_i + 3) / 4 * 3;
+		}
+
+		/** Encode whole triples.
+		 * @param in_i Input bytes
+		 * @param len_i Number of input bytes, only whole triples are encoded
+		 * @param out_o Output, room for 4 characters per triple needed
+		 * @returns Number of characters written */
+		static size_t encodeTriples(const uint8_t * in_i, const size_t len_i, char * out_o)
+		{
+			const uint8_t * end = in_i + len_i - len_i % 3;
+			char * o = out_o;
+
+			for (; in_i != end; in_i += 3, o += 4) {
+				uint32_t v = (uint32_t(in_i[0]) << 16) | (uint32_t(in_i[1]) << 8) | in_i[2];
+				o[0] = enc[v >> 18];
+				o[1] = enc[(v >> 12) & 0x3F];
+				o[2] = enc[(v >> 6) & 0x3F];
+				o[3] = enc[v & 0x3F];
+			}
+			return static_cast<size_t>(o - out_o);
+		}
 
+		/** Encode the last one or two bytes that don't form a triple.
+		 * @param in_i Input bytes
+		 * @param len_i Number of input bytes, 0, 1 or 2
+		 * @param out_o Output, room for 4 characters needed
+		 * @returns Number of characters written */
+		static size_t encodeTail(const uint8_t * in_i, const size_t len_i, char * out_o)
+		{
+			switch (len_i) {
 				case 0:
-					b = (v << 2) & 0xFC;
-					break;
+					return 0;
+
+				case 1:
+					out_o[0] = enc[in_i[0] >> 2];
+					out_o[1] = enc[(in_i[0] & 0x03) << 4];
+					if (!P::padding) return 2;
+					out_o[2] = '=';
+					out_o[3] = '=';
+					return 4;
+
+				case 2:
+					out_o[0] = enc[in_i[0] >> 2];
+					out_o[1] = enc[((in_i[0] & 0x03) << 4) | (in_i[1] >> 4)];
+					out_o[2] = enc[(in_i[1] & 0x0F) << 2];
+					if (!P::padding) return 3;
+					out_o[3] = '=';
+					return 4;
 
 				default:
-					throw std::logic_error("Internal Base64 quad offset is not 0, 1, 2 or 3");
+					throw std::logic_error("Base64 tail should be shorter than 3 bytes");
+			}
+		}
+
+		/** Decode a block of Base64 characters, which may end anywhere in a
+		 * quad. Call decodeFinish() after the last block.
+		 * @param st_io Decoding state, carried over between calls
+		 * @param in_i Base64 characters
+		 * @param len_i Number of characters
+		 * @param out_o Output, room for decodedLength(len_i) bytes needed, plus
+		 * 3 more when @p st_io carries a partial quad
+		 * @returns Number of bytes written
+		 * @throws std::runtime_error on invalid input. */
+		static size_t decode(state_t & st_io, const char * in_i, const size_t len_i, uint8_t * out_o)
+		{
+			const uint8_t * in = reinterpret_cast<const uint8_t *>(in_i);
+			size_t i = 0, o = 0;
+
+			while (i < len_i) {
+				if (st_io.padded) {
+					if (!P::strict) {
+						// Everything after padding is ignored
+						i = len_i;
+						break;
+					}
+					uint8_t v = dec[in[i]];
+					if (v == pad && st_io.pads) st_io.pads--;
+					else if (v != skip) {
+						throw std::runtime_error("Base64 data continues after padding at position " +
+							std::to_string(st_io.pos + i));
+					}
+					i++;
+					continue;
+				}
+
+				if (st_io.offset == 0) {
+					// Fast path over whole quads without special characters
+					while (i + 4 <= len_i) {
+						uint32_t a = dec[in[i]], b = dec[in[i+1]], c = dec[in[i+2]], d = dec[in[i+3]];
+						if ((a | b | c | d) & 0xC0) break;
+						uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+						out_o[o] = static_cast<uint8_t>(v >> 16);
+						out_o[o+1] = static_cast<uint8_t>(v >> 8);
+						out_o[o+2] = static_cast<uint8_t>(v);
+						o += 3;
+						i += 4;
+					}
+					if (i == len_i) break;
+				}
+
+				uint8_t v = dec[in[i]];
+				if (v < 64) {
+					st_io.quad = (st_io.quad << 6) | v;
+					if (++st_io.offset == 4) {
+						out_o[o++] = static_cast<uint8_t>(st_io.quad >> 16);
+						out_o[o++] = static_cast<uint8_t>(st_io.quad >> 8);
+						out_o[o++] = static_cast<uint8_t>(st_io.quad);
+						st_io.quad = 0;
+						st_io.offset = 0;
+					}
+				} else if (v == pad) {
+					if (st_io.offset < 2) {
+						throw std::runtime_error(
+							"Equal sign encountered while decoding first or second character "
+							"in base64 quad at position " + std::to_string(st_io.pos + i)
+						);
+					}
+					st_io.pads = static_cast<uint8_t>(3 - st_io.offset);
+					st_io.padded = true;
+					o += partial_(st_io, out_o + o);
+				} else if (v != skip) {
+					unknown_(in_i[i], st_io.pos + i);
+				}
+				i++;
 			}
 
-			offset = (offset + 1) % 4;
-			i++;
+			st_io.pos += len_i;
+			return o;
 		}
 
-		return data;
+		/** Finish decoding by writing the bytes of an unpadded last quad.
+		 * @param st_io Decoding state
+		 * @param out_o Output, room for 2 bytes needed
+		 * @returns Number of bytes written
+		 * @throws std::runtime_error when a strict policy finds the input
+		 * incomplete. */
+		static size_t decodeFinish(state_t & st_io, uint8_t * out_o)
+		{
+			if (P::strict) {
+				if (st_io.pads) throw std::runtime_error("Base64 padding is incomplete");
+				if (P::padding && st_io.offset) {
+					throw std::runtime_error("Base64 data is not padded to a multiple of 4 characters");
+				}
+				if (st_io.offset == 1) throw std::runtime_error("Base64 data ends with a dangling character");
+			}
+			return partial_(st_io, out_o);
+		}
+	};
+
+	/** Encode data into a caller supplied buffer, without allocating.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param data_i Data to encode
+	 * @param out_o Output buffer, at least Base64Codec<P>::encodedLength()
+	 * characters long
+	 * @returns Number of characters written
+	 * @throws std::length_error when @p out_o is too small. */
+	template <typename P = Base64Lenient>
+	size_t base64encode(std::span<const std::byte> data_i, std::span<char> out_o)
+	{
+		typedef Base64Codec<P> C;
+
+		if (out_o.size() < C::encodedLength(data_i.size())) {
+			throw std::length_error("Output buffer too small for Base64 encoding");
+		}
+		const uint8_t * d = reinterpret_cast<const uint8_t *>(data_i.data());
+		size_t o = C::encodeTriples(d, data_i.size(), out_o.data());
+		size_t t = data_i.size() - data_i.size() % 3;
+		return o + C::encodeTail(d + t, data_i.size() - t, out_o.data() + o);
 	}
 
-	/** Encode a regular C string to a base64 std::string.
-	 * @param T Choose either char or unsigned char, whatever suits you.
-	 * @param string_i pointer to C string
-	 * @returns The data encoded as Base64 string. */
-	template <typename T>
-	std::string base64encode(const T *string_i) {
-		return Fs2a::base64encode<T>(string_i, strlen(string_i));
+	/** Decode Base64 into a caller supplied buffer, without allocating.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param b64_i Base64 characters to decode
+	 * @param out_o Output buffer, at least Base64Codec<P>::decodedLength()
+	 * bytes long
+	 * @returns Number of bytes written
+	 * @throws std::length_error when @p out_o is too small.
+	 * @throws std::runtime_error on invalid input. */
+	template <typename P = Base64Lenient>
+	size_t base64decode(std::string_view b64_i, std::span<std::byte> out_o)
+	{
+		typedef Base64Codec<P> C;
+		typename C::state_t st;
+
+		if (out_o.size() < C::decodedLength(b64_i.size())) {
+			throw std::length_error("Output buffer too small for Base64 decoding");
+		}
+		uint8_t * o = reinterpret_cast<uint8_t *>(out_o.data());
+		size_t len = C::decode(st, b64_i.data(), b64_i.size(), o);
+		return len + C::decodeFinish(st, o + len);
+	}
+
+	/** Decode base64-encoded data back to its original.
+	 * @param T the vector data type to return, can be either std::byte
+	 * (C++17), unsigned char or char.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param b64_i The Base64-encoded data to be decoded.
+	 * @returns Vector of std::byte's. Access the bytes directly via the
+	 * data() member and the length via the size() member. */
+	template <typename T, typename P = Base64Lenient>
+	std::vector<T> base64decode(const std::string & b64_i) {
+		static_assert(sizeof(T) == 1, "Base64 decodes to a vector of single bytes");
+
+		std::vector<T> data(Base64Codec<P>::decodedLength(b64_i.size()));
+		data.resize(base64decode<P>(b64_i, std::as_writable_bytes(std::span<T>(data))));
+		return data;
 	}
 
 	/** Encode data to a base64 std::string.
 	 * @param T Choose either char or unsigned char, whatever suits you.
+	 * @param P Base64 policy, default Base64Lenient
 	 * @param data_i pointer to data
 	 * @param len_i Length in bytes of data
 	 * @returns The data encoded as Base64 string. */
-	template <typename T>
+	template <typename T, typename P = Base64Lenient>
 	std::string base64encode(const T *data_i, const size_t len_i) {
-		static const T b64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		static_assert(sizeof(T) == 1, "Base64 encodes single bytes");
+
+		std::string out(Base64Codec<P>::encodedLength(len_i), '\0');
+		base64encode<P>(std::as_bytes(std::span<const T>(data_i, len_i)), std::span<char>(out));
+		return out;
+	}
+
+	/** Encode a regular C string to a base64 std::string.
+	 * @param T Choose either char or unsigned char, whatever suits you.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param string_i pointer to C string
+	 * @returns The data encoded as Base64 string. */
+	template <typename T, typename P = Base64Lenient>
+	std::string base64encode(const T *string_i) {
+		return Fs2a::base64encode<T, P>(string_i, strlen(reinterpret_cast<const char *>(string_i)));
+	}
+
+	/// Minimum number of input bytes per thread for the parallel Base64 codecs
+	constexpr size_t base64ParallelMinimum = 1 << 20;
+
+	/** Determine the number of threads for a parallel codec.
+	 * @param len_i Input length
+	 * @param threads_i Requested number of threads, 0 for all cores
+	 * @returns Number of threads to use, at least 1 */
+	inline size_t base64threads_(const size_t len_i, const unsigned threads_i)
+	{
+		if (len_i < 2 * base64ParallelMinimum) return 1;
+		return std::max<size_t>(1, std::min(threads_i ? threads_i : hardwareThreads(), len_i / base64ParallelMinimum));
+	}
+
+	/** Encode large data on multiple threads into a caller supplied buffer.
+	 * The input is split on triple boundaries, so every thread writes its
+	 * characters straight to their final offset. Inputs smaller than
+	 * base64ParallelMinimum per thread are encoded with fewer threads or
+	 * just the calling one.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param data_i Data to encode
+	 * @param out_o Output buffer, at least Base64Codec<P>::encodedLength()
+	 * characters long
+	 * @param threads_i Number of threads to use, default 0 for all cores
+	 * @returns Number of characters written
+	 * @throws std::length_error when @p out_o is too small. */
+	template <typename P = Base64Lenient>
+	size_t base64encodeParallel(std::span<const std::byte> data_i, std::span<char> out_o, const unsigned threads_i = 0)
+	{
+		typedef Base64Codec<P> C;
+
+		const size_t parts = base64threads_(data_i.size(), threads_i);
+		if (parts == 1) return base64encode<P>(data_i, out_o);
+		if (out_o.size() < C::encodedLength(data_i.size())) {
+			throw std::length_error("Output buffer too small for Base64 encoding");
+		}
+
+		const uint8_t * d = reinterpret_cast<const uint8_t *>(data_i.data());
+		const size_t triples = data_i.size() / 3;
+		const size_t per = (triples + parts - 1) / parts; // Triples per part
+
+		parallelParts(parts, [&](const size_t part_i) {
+			size_t first = std::min(triples, part_i * per), last = std::min(triples, first + per);
+			C::encodeTriples(d + first * 3, (last - first) * 3, out_o.data() + first * 4);
+		});
+		return triples * 4 + C::encodeTail(d + triples * 3, data_i.size() % 3, out_o.data() + triples * 4);
+	}
 
-		std::string out="";
-		size_t i=0;
+	/** Decode large Base64 input on multiple threads into a caller supplied
+	 * buffer.
+	 * A first parallel pass counts the alphabet characters per part and
+	 * finds the first padding or invalid character. A prefix sum over those
+	 * counts gives every part the quad it starts with, so skipped characters
+	 * don't disturb the output offsets. The second parallel pass decodes
+	 * whole quads straight to their final offset. Whatever follows the last
+	 * whole quad before padding or an invalid character is decoded in the
+	 * calling thread, which also reports errors with their exact position.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param b64_i Base64 characters to decode
+	 * @param out_o Output buffer, at least Base64Codec<P>::decodedLength()
+	 * bytes long
+	 * @param threads_i Number of threads to use, default 0 for all cores
+	 * @returns Number of bytes written
+	 * @throws std::length_error when @p out_o is too small.
+	 * @throws std::runtime_error on invalid input. */
+	template <typename P = Base64Lenient>
+	size_t base64decodeParallel(std::string_view b64_i, std::span<std::byte> out_o, const unsigned threads_i = 0)
+	{
+		typedef Base64Codec<P> C;
+
+		const size_t parts = base64threads_(b64_i.size(), threads_i);
+		if (parts == 1) return base64decode<P>(b64_i, out_o);
+		if (out_o.size() < C::decodedLength(b64_i.size())) {
+			throw std::length_error("Output buffer too small for Base64 decoding");
+		}
 
-		if (len_i == 0) return out;
+		const uint8_t * in = reinterpret_cast<const uint8_t *>(b64_i.data());
+		uint8_t * out = reinterpret_cast<uint8_t *>(out_o.data());
+		const size_t per = (b64_i.size() + parts - 1) / parts; // Characters per part
+		std::vector<size_t> sig(parts + 1, 0);  // Alphabet characters per part, prefix sum later
+		std::vector<size_t> stop(parts, b64_i.size()); // First padding or invalid character
+
+		parallelParts(parts, [&](const size_t part_i) {
+			size_t i = part_i * per, end = std::min(b64_i.size(), i + per), n = 0;
+			for (; i < end; i++) {
+				uint8_t v = C::dec[in[i]];
+				if (v < 64) n++;
+				else if (v != C::skip) break;
+			}
+			sig[part_i + 1] = n;
+			if (i < end) stop[part_i] = i;
+		});
+
+		// Parts after the first stop don't take part in the parallel decode
+		size_t used = 0, regionEnd = b64_i.size();
+		while (used < parts && regionEnd == b64_i.size()) regionEnd = stop[used++];
+		for (size_t p = 1; p <= used; p++) sig[p] += sig[p-1];
+		const size_t quads = sig[used] / 4;
+
+		// Character positions where whole quads start, per part and at the end
+		auto quadStart = [&](size_t pos_i, size_t skip_i) {
+			while (skip_i) {
+				if (C::dec[in[pos_i++]] < 64) skip_i--;
+			}
+			return pos_i;
+		};
+		size_t tail = regionEnd;
+		for (size_t extra = sig[used] % 4; extra; ) {
+			if (C::dec[in[--tail]] < 64) extra--;
+		}
+		std::vector<size_t> starts(used + 1, tail);
+		for (size_t p = 0; p < used; p++) {
+			size_t first = (sig[p] + 3) / 4; // First quad starting in this part
+			if (first < quads) starts[p] = quadStart(p * per, first * 4 - sig[p]);
+		}
 
-		out.reserve((size_t) (ceil(len_i / 3.0) * 4));
+		parallelParts(used, [&](const size_t part_i) {
+			typename C::state_t st;
+			size_t first = std::min(quads, (sig[part_i] + 3) / 4);
+			size_t len = starts[part_i + 1] - starts[part_i];
+			if (starts[part_i] < starts[part_i + 1]) {
+				C::decode(st, b64_i.data() + starts[part_i], len, out + first * 3);
+			}
+		});
+
+		// Remaining characters, padding and errors
+		typename C::state_t st;
+		st.pos = tail;
+		size_t o = quads * 3;
+		o += C::decode(st, b64_i.data() + tail, b64_i.size() - tail, out + o);
+		return o + C::decodeFinish(st, out + o);
+	}
 
-		while (i+2 < len_i) {
-			out += b64[(data_i[i] >> 2) & 0x3F];
-			out += b64[((data_i[i] & 0x03) << 4) | ((data_i[i+1] >> 4) & 0x0F)];
-			out += b64[((data_i[i+1] & 0x0F) << 2) | ((data_i[i+2] >> 6) & 0x03)];
-			out += b64[data_i[i+2] & 0x3F];
+	/** Incremental Base64 encoder for data that doesn't fit in memory at once.
+	 * Data is fed in arbitrarily sized chunks via update(). Bytes that don't
+	 * complete a triple are carried over to the next call, so the output is
+	 * identical to encoding the concatenation of all chunks at once. Encoded
+	 * characters are collected in a fixed-size buffer and passed to the sink
+	 * whenever it is full, so memory use doesn't depend on the payload size.
+	 * @param P Base64 policy, default Base64Lenient */
+	template <typename P = Base64Lenient>
+	class Base64Encoder
+	{
+		public:
+		/// Sink receiving encoded characters
+		typedef std::function<void(const char *, const size_t)> sink_t;
+
+		protected:
+		/// Size of the internal output buffer, a multiple of 4
+		static constexpr size_t bufsize_ = 4096;
+
+		/// Output buffer with encoded characters not yet passed to the sink
+		char buf_[bufsize_];
+
+		/// Number of characters used in the output buffer
+		size_t used_;
+
+		/// Bytes carried over from a previous update() call
+		uint8_t carry_[3];
+
+		/// Number of bytes carried over, 0, 1 or 2
+		uint8_t carried_;
+
+		/// Whether finish() was called already
+		bool finished_;
+
+		/// Sink to pass encoded characters to
+		sink_t sink_;
+
+		/// Pass all buffered characters to the sink.
+		void flush_()
+		{
+			if (used_) sink_(buf_, used_);
+			used_ = 0;
+		}
 
-			i+=3;
+		public:
+		/** Constructor with a callback sink.
+		 * @param sink_i Function that receives the encoded characters.
+		 * @throws std::invalid_argument when @p sink_i is empty. */
+		Base64Encoder(sink_t sink_i)
+		: used_(0), carry_{0, 0, 0}, carried_(0), finished_(false), sink_(std::move(sink_i))
+		{
+			if (!sink_) throw std::invalid_argument("Base64 encoder needs a valid sink");
 		}
 
-		switch (len_i - i) {
-			case 0:
-				break;
+		/** Constructor writing to an output stream.
+		 * @param out_i Output stream to write encoded characters to, should
+		 * outlive this object. */
+		Base64Encoder(std::ostream & out_i)
+		: Base64Encoder([&out_i](const char * data_i, const size_t len_i) {
+			out_i.write(data_i, static_cast<std::streamsize>(len_i));
+		})
+		{}
+
+		/// Copy construction not allowed
+		Base64Encoder(const Base64Encoder & obj_i) = delete;
+
+		/// Assignment not allowed
+		Base64Encoder & operator=(const Base64Encoder & obj_i) = delete;
+
+		/** Destructor. Doesn't call finish(), because the sink might throw.
+		 * Unfinished output is silently discarded. */
+		~Base64Encoder() = default;
+
+		/** Feed the next chunk of data to the encoder.
+		 * @param data_i Pointer to the data
+		 * @param len_i Length of the data in bytes
+		 * @throws std::logic_error when finish() was already called. */
+		void update(const void * data_i, size_t len_i)
+		{
+			if (finished_) throw std::logic_error("Base64 encoder already finished");
+
+			const uint8_t * d = static_cast<const uint8_t *>(data_i);
+
+			// Complete a triple carried over from a previous call first
+			if (carried_) {
+				while (carried_ < 3 && len_i) {
+					carry_[carried_++] = *d++;
+					len_i--;
+				}
+				if (carried_ < 3) return;
+				if (used_ == bufsize_) flush_();
+				used_ += Base64Codec<P>::encodeTriples(carry_, 3, buf_ + used_);
+				carried_ = 0;
+			}
 
-			case 1:
-				out += b64[(data_i[i] >> 2) & 0x3F];
-				out += b64[((data_i[i] & 0x03) << 4)];
-				out += '=';
-				out += '=';
-				break;
+			while (len_i >= 3) {
+				if (used_ == bufsize_) flush_();
+				size_t n = std::min(len_i - len_i % 3, (bufsize_ - used_) / 4 * 3);
+				used_ += Base64Codec<P>::encodeTriples(d, n, buf_ + used_);
+				d += n;
+				len_i -= n;
+			}
 
-			case 2:
-				out += b64[(data_i[i] >> 2) & 0x3F];
-				out += b64[((data_i[i] & 0x03) << 4) | ((data_i[i+1] >> 4) & 0x0F)];
-				out += b64[((data_i[i+1] & 0x0F) << 2)];
-				out += '=';
-				break;
+			while (len_i--) carry_[carried_++] = *d++;
+		}
 
-			default:
-				throw std::logic_error("Failure in length calculation, please contact author with input string");
+		/** Finish encoding by writing the last, possibly padded, quad and
+		 * flushing the internal buffer to the sink. The encoder can't be used
+		 * afterwards.
+		 * @throws std::logic_error when finish() was already called. */
+		void finish()
+		{
+			if (finished_) throw std::logic_error("Base64 encoder already finished");
+			finished_ = true;
+
+			if (used_ == bufsize_) flush_();
+			used_ += Base64Codec<P>::encodeTail(carry_, carried_, buf_ + used_);
+			carried_ = 0;
+			flush_();
 		}
+	};
+
+	/** Incremental Base64 decoder, the counterpart of Base64Encoder.
+	 * Encoded characters are fed in arbitrarily sized chunks via update(). A
+	 * partial quad is carried over to the next call, so chunk boundaries may
+	 * fall anywhere. The decoding rules are those of the policy, just like
+	 * for base64decode(). Decoded bytes are passed to the sink in blocks of
+	 * at most 3 KiB.
+	 * @param P Base64 policy, default Base64Lenient */
+	template <typename P = Base64Lenient>
+	class Base64Decoder
+	{
+		public:
+		/// Sink receiving decoded bytes
+		typedef std::function<void(const char *, const size_t)> sink_t;
+
+		protected:
+		/// Size of the internal output buffer, a multiple of 3
+		static constexpr size_t bufsize_ = 3072;
+
+		/// Output buffer with decoded bytes not yet passed to the sink
+		uint8_t buf_[bufsize_];
+
+		/// Number of bytes used in the output buffer
+		size_t used_;
+
+		/// Decoding state carried over between update() calls
+		typename Base64Codec<P>::state_t state_;
+
+		/// Whether finish() was called already
+		bool finished_;
+
+		/// Sink to pass decoded bytes to
+		sink_t sink_;
+
+		/// Pass all buffered bytes to the sink.
+		void flush_()
+		{
+			if (used_) sink_(reinterpret_cast<const char *>(buf_), used_);
+			used_ = 0;
+		}
+
+		public:
+		/** Constructor with a callback sink.
+		 * @param sink_i Function that receives the decoded bytes.
+		 * @throws std::invalid_argument when @p sink_i is empty. */
+		Base64Decoder(sink_t sink_i)
+		: used_(0), state_(), finished_(false), sink_(std::move(sink_i))
+		{
+			if (!sink_) throw std::invalid_argument("Base64 decoder needs a valid sink");
+		}
+
+		/** Constructor writing to an output stream.
+		 * @param out_i Output stream to write decoded bytes to, should
+		 * outlive this object. */
+		Base64Decoder(std::ostream & out_i)
+		: Base64Decoder([&out_i](const char * data_i, const size_t len_i) {
+			out_i.write(data_i, static_cast<std::streamsize>(len_i));
+		})
+		{}
+
+		/// Copy construction not allowed
+		Base64Decoder(const Base64Decoder & obj_i) = delete;
+
+		/// Assignment not allowed
+		Base64Decoder & operator=(const Base64Decoder & obj_i) = delete;
+
+		/// Destructor, doesn't call finish() either.
+		~Base64Decoder() = default;
+
+		/** Feed the next chunk of Base64-encoded characters to the decoder.
+		 * @param b64_i Pointer to the characters
+		 * @param len_i Number of characters
+		 * @throws std::runtime_error on invalid input, reporting the position
+		 * counted over all chunks so far.
+		 * @throws std::logic_error when finish() was already called. */
+		void update(const char * b64_i, size_t len_i)
+		{
+			if (finished_) throw std::logic_error("Base64 decoder already finished");
+
+			while (len_i) {
+				// Largest slice of which the output is sure to fit
+				size_t n = bufsize_ - used_ < 6 ? 0 : (bufsize_ - used_ - 3) / 3 * 4;
+				if (n == 0) {
+					flush_();
+					continue;
+				}
+				n = std::min(len_i, n);
+				used_ += Base64Codec<P>::decode(state_, b64_i, n, buf_ + used_);
+				b64_i += n;
+				len_i -= n;
+			}
+		}
+
+		/** Finish decoding by writing the bytes of an unpadded last quad and
+		 * flushing the internal buffer to the sink.
+		 * @throws std::logic_error when finish() was already called.
+		 * @throws std::runtime_error when a strict policy finds the input
+		 * incomplete. */
+		void finish()
+		{
+			if (finished_) throw std::logic_error("Base64 decoder already finished");
+			finished_ = true;
+			if (used_ + 2 > bufsize_) flush_();
+			used_ += Base64Codec<P>::decodeFinish(state_, buf_ + used_);
+			flush_();
+		}
+	};
+
+	/** Base64-encode everything from an input stream to an output stream,
+	 * using a constant amount of memory.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param in_i Stream to read raw data from until EOF
+	 * @param out_i Stream to write the Base64 characters to
+	 * @returns Number of bytes read from @p in_i */
+	template <typename P = Base64Lenient>
+	size_t base64encode(std::istream & in_i, std::ostream & out_i)
+	{
+		char blk[12288]; // Block of input data
+		size_t total = 0;
+		Base64Encoder<P> enc(out_i);
+
+		while (in_i.read(blk, sizeof(blk)) || in_i.gcount()) {
+			enc.update(blk, static_cast<size_t>(in_i.gcount()));
+			total += static_cast<size_t>(in_i.gcount());
+		}
+		enc.finish();
+		return total;
+	}
 
-		return std::move(out);
+	/** Decode Base64 characters from an input stream to an output stream,
+	 * using a constant amount of memory.
+	 * @param P Base64 policy, default Base64Lenient
+	 * @param in_i Stream to read Base64 characters from until EOF
+	 * @param out_i Stream to write the decoded data to
+	 * @returns Number of characters read from @p in_i
+	 * @throws std::runtime_error on invalid Base64 input. */
+	template <typename P = Base64Lenient>
+	size_t base64decode(std::istream & in_i, std::ostream & out_i)
+	{
+		char blk[16384]; // Block of input characters
+		size_t total = 0;
+		Base64Decoder<P> dec(out_i);
+
+		while (in_i.read(blk, sizeof(blk)) || in_i.gcount()) {
+			dec.update(blk, static_cast<size_t>(in_i.gcount()));
+			total += static_cast<size_t>(in_i.gcount());
+		}
+		dec.finish();
+		return total;
 	}
 
 } // Fs2a namespace
@@ -0,0 +1,348 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+#include <fs2a/DictColumn.hpp>
+#include <fs2a/HeaderedTable.hpp>
+#include <fs2a/NaiveDate.hpp>
+#include <fs2a/NaiveTime.hpp>
+
+namespace Fs2a {
+
+	/** Class that models a table stored column by column, where every column has its own type.
+	 * Contrary to Table<std::string>, which stores every cell as a string in row-major order,
+	 * the values of a column are stored contiguously in their native type. Scanning a column
+	 * touches only that column's memory and can be vectorized by the compiler. Text columns are
+	 * dictionary encoded, see DictColumn, so repeating values are stored only once. Every column has a validity
+	 * bitmap to mark missing values, which is what an empty CSV field converts to.
+	 * Rows are appended by appending a value to every column. */
+	class ColumnTable
+	{
+		public:
+		/// Column types
+		enum type_e : uint8_t {
+			text,    ///< Dictionary encoded strings
+			integer, ///< 64-bit signed integers
+			decimal, ///< Double precision floating point numbers
+			date,    ///< NaiveDate objects, parsed from ISO8601
+			time,    ///< NaiveTime objects, parsed from HH:MM
+			boolean  ///< Booleans stored as bytes, parsed from true or false in any case
+		};
+
+		/// Value that couldn't be converted to the type of its column
+		typedef struct conversionError_s {
+			colidx_t column;   ///< Column index
+			uint32_t row;      ///< Row in the source table, header is row 0
+			std::string value; ///< Value as found
+		} conversionError_t;
+
+		/** Return the name of a column type.
+		 * @param type_i Type to name
+		 * @returns Type name, like "integer". */
+		static const char * typeName(const type_e type_i);
+
+		/// A single named and typed column with a validity bitmap
+		class Column
+		{
+			friend class ColumnTable;
+
+			protected:
+			/// Name of the column
+			std::string name_;
+
+			/// Type of the values in this column
+			type_e type_;
+
+			/// Number of values in this column, including missing ones
+			size_t rows_;
+
+			/// Validity bitmap, bit r % 64 of word r / 64 is set when row r has a value
+			std::vector<uint64_t> valid_;
+
+			/** Values of this column. Missing values are stored as zero, so scans don't have to
+			 * branch on them. Text columns keep their values in dict_ instead. */
+			std::variant<std::monostate, std::vector<int64_t>, std::vector<double>,
+				std::vector<NaiveDate>, std::vector<NaiveTime>, std::vector<uint8_t>> values_;
+
+			/// Dictionary encoded strings of a text column, missing values have code 0
+			DictColumn dict_;
+
+			/** Append a validity bit for a new row.
+			 * @param valid_i True when the new row has a value */
+			void pushValid_(const bool valid_i);
+
+			/** Append a value from its string representation, without throwing on conversion errors.
+			 * @param value_i String to append, empty for a missing value
+			 * @returns False when the string can't be converted, nothing is appended then. */
+			bool parse_(std::string_view value_i);
+
+			/** Get the values vector of a type, checking the column type.
+			 * @returns Reference to the vector
+			 * @throws std::logic_error when the column holds values of another type. */
+			template <typename V>
+			std::vector<V> & vec_()
+			{
+				auto v = std::get_if<std::vector<V>>(&values_);
+				if (v == nullptr) throw std::logic_error("Column \"" + name_ + "\" holds " + typeName(type_) + " values");
+				return *v;
+			}
+
+			/// @see vec_()
+			template <typename V>
+			const std::vector<V> & vec_() const
+			{
+				return const_cast<Column *>(this)->vec_<V>();
+			}
+
+			public:
+			/** Constructor.
+			 * @param name_i Name of the column
+			 * @param type_i Type of the column */
+			Column(const std::string & name_i, const type_e type_i);
+
+			/// Name of this column
+			inline const std::string & name() const { return name_; }
+
+			/// Type of this column
+			inline type_e type() const { return type_; }
+
+			/// Number of rows in this column
+			inline size_t size() const { return rows_; }
+
+			/** Check whether a row has a value.
+			 * @param row_i Row to check, zero based
+			 * @returns False when the value is missing or the row doesn't exist. */
+			inline bool valid(const size_t row_i) const {
+				return row_i < rows_ && (valid_[row_i >> 6] >> (row_i & 63) & 1);
+			}
+
+			/// Validity bitmap words, see valid()
+			inline std::span<const uint64_t> validity() const { return valid_; }
+
+			/// @returns Number of missing values in this column
+			size_t nulls() const;
+
+			/** Access the raw values of this column. Use uint8_t for booleans, text columns have
+			 * their codes in dict() instead. Check valid() for rows that could be missing,
+			 * these hold zero or an unset date or time.
+			 * @returns Span over all values
+			 * @throws std::logic_error when the column holds values of another type. */
+			template <typename V>
+			std::span<const V> values() const { return vec_<V>(); }
+
+			/// @see values() const
+			template <typename V>
+			std::span<V> values() { return vec_<V>(); }
+
+			/** Dictionary encoded strings of a text column.
+			 * @returns Dictionary and codes, where missing values have code 0
+			 * @throws std::logic_error when this is not a text column. */
+			const DictColumn & dict() const;
+
+			/** Dictionary of a text column.
+			 * @returns Distinct strings, indexed by the codes of dict()
+			 * @throws std::logic_error when this is not a text column. */
+			inline const std::deque<std::string> & dictionary() const { return dict().dictionary(); }
+
+			/** Fetch the string of a text column.
+			 * @param row_i Row to fetch, zero based
+			 * @returns String value, empty when missing
+			 * @throws std::logic_error when this is not a text column
+			 * @throws std::out_of_range when the row doesn't exist. */
+			const std::string & text(const size_t row_i) const;
+
+			/** Convert a value of any type to its string representation.
+			 * @param row_i Row to convert, zero based
+			 * @returns String value, empty when missing
+			 * @throws std::out_of_range when the row doesn't exist. */
+			std::string str(const size_t row_i) const;
+
+			/** @{ Append a value in the native type of the column.
+			 * @throws std::logic_error when the column is of another type. */
+			template <std::integral I> requires (!std::same_as<I, bool>)
+			void append(const I value_i) { vec_<int64_t>().push_back(static_cast<int64_t>(value_i)); pushValid_(true); }
+			template <std::same_as<bool> B> // Template, so pointers don't convert to it
+			void append(const B value_i) { vec_<uint8_t>().push_back(value_i); pushValid_(true); }
+			void append(const double value_i);
+			void append(const NaiveDate & value_i);
+			void append(const NaiveTime & value_i);
+			/** @} */
+
+			/** Append a value from its string representation. Text columns store the string as-is,
+			 * other columns parse it. An empty string is appended as a missing value.
+			 * @param value_i String to append
+			 * @throws std::invalid_argument when the string can't be converted to the column type. */
+			void append(std::string_view value_i);
+
+			/// Append a missing value
+			void appendNull();
+
+			/** Reserve storage for a number of rows.
+			 * @param rows_i Number of rows to reserve room for */
+			void reserve(const size_t rows_i);
+
+			/// Release unused capacity
+			void compact();
+
+			/// @returns Bytes of heap memory used by the values, validity and dictionary
+			size_t memoryUsage() const;
+		};
+
+		protected:
+		/// All columns of this table, in order
+		std::vector<Column> cols_;
+
+		/// Map of column names to column indices
+		std::unordered_map<std::string, colidx_t> hdrs_;
+
+		/// Share of this table in the MemoryTally, updated by updateAccount()
+		MemoryTally::Account account_;
+
+		public:
+		/// Constructor
+		ColumnTable() = default;
+
+		/// Destructor
+		virtual ~ColumnTable() = default;
+
+		/** Add a column. Existing rows get a missing value in the new column.
+		 * @param name_i Unique name of the new column
+		 * @param type_i Type of the new column
+		 * @returns Reference to the new column, valid until the next column is added
+		 * @throws std::invalid_argument when the name is empty or already in use
+		 * @throws std::out_of_range when the maximum number of columns is reached. */
+		Column & addColumn(const std::string & name_i, const type_e type_i);
+
+		/// Number of columns in this table
+		inline colidx_t columns() const { return static_cast<colidx_t>(cols_.size()); }
+
+		/// Number of rows in this table, excluding the header
+		inline size_t rows() const { return cols_.empty() ? 0 : cols_.front().size(); }
+
+		/** @{ Reference a column by its index.
+		 * @param column_i Column index, zero based
+		 * @throws std::out_of_range when the column doesn't exist. */
+		Column & column(const colidx_t column_i) { return cols_.at(column_i); }
+		const Column & column(const colidx_t column_i) const { return cols_.at(column_i); }
+		/** @} */
+
+		/** Find a column by its name.
+		 * @param name_i Name of the column
+		 * @returns Column index
+		 * @throws std::invalid_argument when there is no column with that name. */
+		colidx_t columnIndex(const std::string & name_i) const;
+
+		/** @{ Reference a column by its name.
+		 * @param name_i Name of the column
+		 * @throws std::invalid_argument when there is no column with that name. */
+		Column & column(const std::string & name_i);
+		const Column & column(const std::string & name_i) const;
+		/** @} */
+
+		/** Convert a table of strings, like the result of readCSV(), to a column table.
+		 * The first row of @p table_i holds the column names, like in HeaderedTable.
+		 * @param table_i Table to convert
+		 * @param types_i Type of every column
+		 * @returns New column table
+		 * @throws std::invalid_argument when the number of types doesn't match the number of
+		 * columns, or when a value can't be converted. */
+		static ColumnTable fromTable(const Table<std::string> & table_i, const std::vector<type_e> & types_i);
+
+		/** Convert a table of strings like fromTable(), but keep going when values can't be
+		 * converted. Such values become missing values and are reported instead.
+		 * Columns are converted in parallel.
+		 * @param table_i Table to convert, with the column names as first row
+		 * @param types_i Type of every column
+		 * @param errors_o Values that couldn't be converted are appended to this, ordered by row
+		 * @returns New column table
+		 * @throws std::invalid_argument when the number of types doesn't match the number of
+		 * columns. */
+		static ColumnTable fromTable(const Table<std::string> & table_i, const std::vector<type_e> & types_i,
+			std::vector<conversionError_t> & errors_o);
+
+		/** Infer the type of every column of a table of strings from a sample of its rows.
+		 * The narrowest type that all non-empty sampled values convert to is chosen, trying
+		 * integer, decimal, boolean, date and time. Numbers with leading zeros, like zip codes,
+		 * and nan or inf don't count as numbers, as the zeros would get lost and the words are
+		 * more likely text. Anything else, and columns without any sampled value, are text.
+		 * Text is dictionary encoded, so enumeration-like columns with few distinct values are
+		 * stored compactly as codes.
+		 * @param table_i Table to inspect, with the column names as first row
+		 * @param sample_i Maximum number of rows to inspect, spread evenly over the table.
+		 * 0 inspects all rows.
+		 * @returns Type of every column */
+		static std::vector<type_e> inferTypes(const Table<std::string> & table_i, const uint32_t sample_i = 1024);
+
+		/** Convert a table of strings with inferred column types, see inferTypes() and
+		 * the lenient fromTable().
+		 * @param table_i Table to convert, with the column names as first row
+		 * @param errors_o Values that didn't convert to the inferred type are appended to this
+		 * @param sample_i Maximum number of rows to infer types from, 0 for all
+		 * @returns New column table */
+		static ColumnTable infer(const Table<std::string> & table_i, std::vector<conversionError_t> & errors_o,
+			const uint32_t sample_i = 1024);
+
+		/** Convert a table of strings to a column table with only text columns, which
+		 * dictionary encodes every column. Like fromTable() with all types text.
+		 * @param table_i Table to convert, with the column names as first row
+		 * @returns New column table */
+		static ColumnTable encode(const Table<std::string> & table_i);
+
+		/** Release unused capacity of all columns, and update the account of this table in
+		 * the MemoryTally.
+		 * @returns memoryUsage() after compacting */
+		size_t compact();
+
+		/** Determine the memory used by this table, without changing anything.
+		 * This doesn't take a pass over the rows, only over the dictionaries.
+		 * @returns Bytes of heap memory in use, not counting the table object itself */
+		size_t memoryUsage() const;
+
+		/** Determine the memory used by this table like memoryUsage(), and update its
+		 * account in the MemoryTally with it.
+		 * @returns Bytes of heap memory in use, not counting the table object itself */
+		size_t updateAccount();
+
+		/** Convert this table to a table of strings, with the column names as first row.
+		 * @returns Table with a header row and all values as strings, missing values are empty. */
+		HeaderedTable toTable() const;
+	};
+
+} // Fs2a namespace
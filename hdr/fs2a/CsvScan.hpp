@@ -0,0 +1,97 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Fs2a {
+
+	/** Structural character scanning for CSV parsing.
+	 * Input is classified 64 bytes at a time into bitmasks of quotes, separators and
+	 * line endings, like simdcsv does. Vectorized kernels are available on x86 that
+	 * compare 16 or 32 bytes per step, and the fastest kernel supported by the CPU is
+	 * selected at runtime. Quoted regions follow from the quote mask with a prefix XOR,
+	 * done with a carry-less multiply where the CPU has one. */
+	class CsvScan
+	{
+		public:
+		/// Available kernels
+		enum kernel_e : uint8_t {
+			scalar, ///< Byte by byte, available everywhere
+			sse2,   ///< 16 bytes per step with SSE2 and PCLMULQDQ
+			avx2,   ///< 32 bytes per step with AVX2 and PCLMULQDQ
+			best    ///< Fastest kernel supported by this CPU
+		};
+
+		/// Bitmasks of a block of 64 bytes, bit i is set for byte i of the block
+		typedef struct masks_s {
+			uint64_t quote;     ///< Double quotes
+			uint64_t separator; ///< Field separators
+			uint64_t cr;        ///< Carriage returns
+			uint64_t lf;        ///< Line feeds
+		} masks_t;
+
+		/// Number of bytes covered by one masks_t
+		static constexpr size_t blockBytes = 64;
+
+		/** Number of masks_t needed to classify a given number of bytes.
+		 * @param len_i Number of bytes
+		 * @returns Number of blocks */
+		static constexpr size_t blocks(const size_t len_i) { return (len_i + blockBytes - 1) / blockBytes; }
+
+		/** Check whether a kernel can run on this CPU.
+		 * @param kernel_i Kernel to check
+		 * @returns True if supported, always true for scalar and best. */
+		static bool supported(const kernel_e kernel_i);
+
+		/** Classify bytes into bitmasks per block of 64 bytes.
+		 * @param in_i Input bytes
+		 * @param len_i Number of input bytes
+		 * @param separator_i Field separator
+		 * @param out_o Output, room for blocks(len_i) masks needed. Bits past the end of
+		 * the input in the last block are cleared.
+		 * @param kernel_i Kernel to use, default best
+		 * @throws std::invalid_argument when the kernel isn't supported. */
+		static void classify(const char * in_i, const size_t len_i, const char separator_i, masks_t * out_o,
+			const kernel_e kernel_i = best);
+
+		/** Prefix XOR of a bitmask: bit i of the result is the XOR of bits 0 up to and
+		 * including i. For a quote mask this sets the bits of opening quotes and the data
+		 * they quote, and clears those of closing quotes and unquoted data.
+		 * @param bits_i Bitmask
+		 * @param kernel_i Kernel to use, default best
+		 * @returns Prefix XOR of @p bits_i
+		 * @throws std::invalid_argument when the kernel isn't supported. */
+		static uint64_t prefixXor(const uint64_t bits_i, const kernel_e kernel_i = best);
+	};
+
+} // Fs2a namespace
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <fs2a/Base16.hpp>
 #include <fs2a/Logger.hpp>
 
 namespace Fs2a
@@ -111,6 +112,13 @@ namespace Fs2a
 		 * @throws std::runtime_error when quoting was disabled but necessary */
 		size_t field(const std::string & field_i);
 
+		/** Write a single field with data as hexadecimal digits, straight to
+		 * the output without a temporary string.
+		 * @param hex_i Data to write, for example Fs2a::hex(digest)
+		 * @returns Column number the field was written as (1-based)
+		 * @throws std::logic_error when headers were forced and not written */
+		size_t field(const Base16View & hex_i);
+
 		/** Write multiple fields.
 		 * @param fields_i fields to write
 		 * @returns Last column number that was written (1-based)
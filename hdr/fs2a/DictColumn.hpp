@@ -0,0 +1,161 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+#include <fs2a/HeaderedTable.hpp>
+
+namespace Fs2a {
+
+	/** Dictionary encoded column of strings.
+	 * Every distinct string is stored once in a dictionary, and every row only stores the
+	 * code of its string in that dictionary. Codes are 8 bits wide as long as there are at
+	 * most 256 distinct strings, and are widened to 16 and then 32 bits when the dictionary
+	 * outgrows that. A column like a currency or a status over millions of rows thus costs a
+	 * byte per row, and comparing or grouping its values only compares integers. */
+	class DictColumn
+	{
+		public:
+		/// Code vectors for every code width
+		typedef std::variant<std::vector<uint8_t>, std::vector<uint16_t>, std::vector<uint32_t>> codes_t;
+
+		protected:
+		/// Distinct strings, indexed by code. A deque, so the lookup can reference them.
+		std::deque<std::string> dict_;
+
+		/// Lookup from string to code
+		std::unordered_map<std::string_view, uint32_t> lookup_;
+
+		/// Code of every row
+		codes_t codes_;
+
+		/// Switch to the next wider code type, when the dictionary outgrew the current one
+		void widen_();
+
+		public:
+		/// Constructor
+		DictColumn() = default;
+
+		/** Encode a column of a table.
+		 * @param table_i Table to read from, with a header row
+		 * @param colname_i Name of the column to encode, its rows after the header are appended
+		 * @throws std::invalid_argument when the column doesn't exist. */
+		DictColumn(HeaderedTable & table_i, const std::string & colname_i);
+
+		/// Copy constructor, which rebuilds the lookup for the copied dictionary
+		DictColumn(const DictColumn & obj_i);
+
+		/// Move constructor, a moved deque keeps its strings in place
+		DictColumn(DictColumn && obj_io) = default;
+
+		/// @see DictColumn(const DictColumn &)
+		DictColumn & operator=(const DictColumn & obj_i);
+
+		/// @see DictColumn(DictColumn &&)
+		DictColumn & operator=(DictColumn && obj_io) = default;
+
+		/// Destructor
+		~DictColumn() = default;
+
+		/** Append a string, adding it to the dictionary when it is new.
+		 * @param value_i String to append
+		 * @returns Code of the string */
+		uint32_t append(std::string_view value_i);
+
+		/** Append an existing code, which is not checked.
+		 * @param code_i Code to append */
+		void appendCode(const uint32_t code_i);
+
+		/// @returns Number of distinct strings
+		inline size_t cardinality() const { return dict_.size(); }
+
+		/** Fetch the code of a row, which is not checked.
+		 * @param row_i Row, zero based
+		 * @returns Code of the string of that row */
+		inline uint32_t code(const size_t row_i) const
+		{
+			return std::visit([&](const auto & c_i) { return static_cast<uint32_t>(c_i[row_i]); }, codes_);
+		}
+
+		/// @returns The codes of all rows, in their current width
+		inline const codes_t & codes() const { return codes_; }
+
+		/// @returns The dictionary, indexed by code
+		inline const std::deque<std::string> & dictionary() const { return dict_; }
+
+		/** Look up the code of a string.
+		 * @param value_i String to look for
+		 * @param code_o Set to the code when found
+		 * @returns False when the string is not in the dictionary */
+		bool find(std::string_view value_i, uint32_t & code_o) const;
+
+		/// Release unused capacity of the codes
+		void compact();
+
+		/// @returns Bytes of heap memory used by the dictionary, its lookup and the codes
+		size_t memoryUsage() const;
+
+		/** Reserve room for codes.
+		 * @param rows_i Number of rows to reserve room for */
+		void reserve(const size_t rows_i);
+
+		/// @returns Number of rows
+		inline size_t size() const
+		{
+			return std::visit([](const auto & c_i) { return c_i.size(); }, codes_);
+		}
+
+		/** Fetch the string of a row, which is not checked.
+		 * @param row_i Row, zero based
+		 * @returns String of that row */
+		inline const std::string & operator[](const size_t row_i) const { return dict_[code(row_i)]; }
+
+		/** Call a function with the codes vector in its native width, so loops over the codes
+		 * don't dispatch on the width for every row.
+		 * @param func_i Function taking a const std::vector<uint8_t>, uint16_t or uint32_t reference
+		 * @returns Whatever @p func_i returns */
+		template <typename F>
+		inline decltype(auto) visit(F && func_i) const { return std::visit(std::forward<F>(func_i), codes_); }
+
+		/// @returns Width of the codes in bytes, 1, 2 or 4
+		inline size_t width() const
+		{
+			return std::visit([](const auto & c_i) { return sizeof(c_i[0]); }, codes_);
+		}
+	};
+
+} // Fs2a namespace
@@ -32,15 +32,74 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <fs2a/Table.hpp>
 
 namespace Fs2a {
 
 	class HeaderedTable : public Table<std::string>
 	{
+		public:
+		/// Sort key for sortBy()
+		typedef struct sortKey_s {
+			std::string column; ///< Name of the column to sort on
+			bool descending;    ///< Sort from high to low
+			bool numeric;       ///< Compare values as numbers, others sort last
+
+			/// @{ Constructors, so a plain column name can be used as sort key
+			sortKey_s(const std::string & column_i, const bool descending_i = false, const bool numeric_i = false)
+			: column(column_i), descending(descending_i), numeric(numeric_i)
+			{}
+			sortKey_s(const char * column_i, const bool descending_i = false, const bool numeric_i = false)
+			: column(column_i), descending(descending_i), numeric(numeric_i)
+			{}
+			/// @}
+		} sortKey_t;
+
 		protected:
+		/// Secondary hash index over one or more columns
+		typedef struct index_s {
+			std::vector<colidx_t> cols;                                  ///< Indexed columns
+			std::unordered_map<std::string, std::vector<uint32_t>> rows; ///< Ascending rows per key
+			std::vector<const std::string *> keys;                       ///< Key of every row, into rows
+			std::vector<uint32_t> dirty;                                 ///< Rows that may have changed
+		} index_t;
+
 		/// Map of strings to column indices to mimic associative columns.
-		std::unordered_map<std::string, uint16_t> hdrs_;
+		std::unordered_map<std::string, colidx_t> hdrs_;
+
+		/// Secondary indexes, built on demand by find()
+		std::vector<index_t> indexes_;
+
+		/** Resolve a column name to its index.
+		 * @param colname_i Column name
+		 * @returns Column index
+		 * @throws std::invalid_argument when the column doesn't exist. */
+		colidx_t column_(const std::string & colname_i);
+
+		/** Get the index over some columns, building it if needed.
+		 * @param colnames_i Names of the indexed columns
+		 * @returns Up to date index */
+		index_t & index_(const std::vector<std::string> & colnames_i);
+
+		/** Build the lookup key of a row or of given values.
+		 * @param cols_i Columns to build the key of
+		 * @param row_i Row to build the key of
+		 * @returns Key, the plain value for a single column */
+		std::string key_(const std::vector<colidx_t> & cols_i, const uint32_t row_i) const;
+
+		/** Update an index for its rows that may have changed.
+		 * @param idx_io Index to update */
+		void refresh_(index_t & idx_io);
+
+		/** Mark a cell as possibly changed in the indexes that cover it.
+		 * @param column_i Column of the cell
+		 * @param row_i Row of the cell */
+		void touch_(const colidx_t column_i, const uint32_t row_i);
+
+		/** Heap memory of the header map and the indexes.
+		 * @see Table::measureBytes_() */
+		virtual size_t measureBytes_() const override;
 
 		/** Make header names unique by adding digits when duplicates are
 		 * found. */
@@ -58,17 +117,107 @@ namespace Fs2a {
 		: Table(obj_i)
 		{}
 
+		/// Move constructor from superclass
+		HeaderedTable(Table<std::string> && obj_io)
+		: Table(std::move(obj_io))
+		{}
+
+		/// Copy constructor, indexes are not copied but rebuilt on demand
+		HeaderedTable(const HeaderedTable & obj_i)
+		: Table(obj_i), hdrs_(obj_i.hdrs_)
+		{}
+
+		/// Move constructor
+		HeaderedTable(HeaderedTable &&) = default;
+
+		/// Copy assignment, indexes are not copied but rebuilt on demand
+		HeaderedTable & operator=(const HeaderedTable & obj_i);
+
+		/// Move assignment
+		HeaderedTable & operator=(HeaderedTable &&) = default;
+
 		/// Destructor
 		virtual ~HeaderedTable() = default;
 
-		/// Explicitly inherit the Table::cell() method, otherwise it is hidden.
+		/// Explicitly inherit the Table::cell() and rows() methods, otherwise they are hidden.
 		using Table<std::string>::cell;
+		using Table<std::string>::rows;
+
+		/** Fetch a reference to a specific field, increasing the number of
+		 * rows if necessary. Indexes over the column are updated on their
+		 * next use, in case the field is changed through the reference.
+		 * @see Table::cell() */
+		virtual std::string & cell(const colidx_t column_i, const uint32_t row_i) override;
+
+		/** Set the number of rows. This drops all indexes.
+		 * @see Table::rows() */
+		virtual void rows(const uint32_t rows_i) override;
 
 		/** Reference a cell by row number and column name.
 		 * @param colname_i Column name to reference.
 		 * @param row_i Row number to reference, header is row 0. */
 		virtual std::string & cell(const std::string & colname_i, const uint32_t row_i);
 
+		/** Resolve a column name to its index.
+		 * @param colname_i Column name
+		 * @returns Column index, for use with cell() or operator()
+		 * @throws std::invalid_argument when the column doesn't exist. */
+		inline colidx_t columnIndex(const std::string & colname_i) { return column_(colname_i); }
+
+		/** Range over the values of a column, without the header.
+		 * The name is resolved once, after which scanning the range has no lookups or bounds
+		 * checks. Like operator(), changing cells through it doesn't update indexes, see
+		 * index().
+		 * @param colname_i Column name
+		 * @returns Range over the cells of rows 1 and up, valid until the number of rows changes
+		 * @throws std::invalid_argument when the column doesn't exist. */
+		inline StridedRange<std::string> column(const std::string & colname_i)
+		{
+			return columnRange(column_(colname_i), 1);
+		}
+
+		/** Make header names unique by adding digits when duplicates are
+		 * found. Shared with the other tables that address columns by name.
+		 * Runs in linear time, so very wide tables are no problem.
+		 * @param names_io Header names, duplicates are renamed in place */
+		static void uniqueHeaders(std::vector<std::string> & names_io);
+
+		/** Build a hash index over one or more columns, unless it exists.
+		 * find() also builds indexes when needed, this is to build them up
+		 * front. Indexes are kept up to date for cells changed through
+		 * cell(). Changing the number of rows or sorting drops them, and
+		 * so does dropIndexes(), which is needed after changing cells
+		 * through operator(), row() or appendRow().
+		 * @param colnames_i Names of the columns to index
+		 * @throws std::invalid_argument when a column doesn't exist. */
+		void index(const std::vector<std::string> & colnames_i);
+
+		/** @{ Find rows by the values of one or more columns, using an index.
+		 * The first lookup on a combination of columns builds its index.
+		 * @param colnames_i Names of the columns to look in
+		 * @param values_i Values to look for, one for every column
+		 * @returns Ascending row numbers of the matching rows, never the
+		 * header. Valid until the table or its indexes change.
+		 * @throws std::invalid_argument when a column doesn't exist or
+		 * the number of values doesn't match the number of columns. */
+		const std::vector<uint32_t> & find(const std::vector<std::string> & colnames_i, const std::vector<std::string> & values_i);
+		const std::vector<uint32_t> & find(const std::string & colname_i, const std::string & value_i);
+		/** @} */
+
+		/// Drop all indexes
+		void dropIndexes();
+
+		/** Release unused memory, dropping all indexes too. They are rebuilt on demand.
+		 * @see Table::compact() */
+		virtual size_t compact() override;
+
+		/** Sort all rows but the header, stable and in parallel.
+		 * @param keys_i Columns to sort on, most significant first
+		 * @param threads_i Number of threads to use, 0 for all hardware
+		 * threads. Small tables use less.
+		 * @throws std::invalid_argument when no or unknown columns are given. */
+		void sortBy(const std::vector<sortKey_t> & keys_i, const unsigned threads_i = 0);
+
 	};
 
 } // Fs2a namespace
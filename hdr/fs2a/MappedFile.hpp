@@ -0,0 +1,85 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Fs2a {
+
+	/** Read-only memory mapping of a whole file.
+	 * The mapping stays valid for the lifetime of the object, also when the file is
+	 * removed or replaced in the meantime. Changing the file in place while it is
+	 * mapped is not supported. */
+	class MappedFile
+	{
+		protected:
+		/// Start of the mapping, nullptr for an empty file
+		const char * data_;
+
+		/// Size of the mapping in bytes
+		size_t size_;
+
+		/// Unmap, if mapped
+		void unmap_();
+
+		public:
+		/** Constructor, maps a file.
+		 * @param path_i Path of the file to map
+		 * @throws std::runtime_error when the file can't be opened or mapped. */
+		explicit MappedFile(const std::string & path_i);
+
+		/// Move constructor
+		MappedFile(MappedFile && obj_io) noexcept;
+
+		/// Move assignment
+		MappedFile & operator=(MappedFile && obj_io) noexcept;
+
+		/// @{ Not copyable, the mapping is owned
+		MappedFile(const MappedFile &) = delete;
+		MappedFile & operator=(const MappedFile &) = delete;
+		/// @}
+
+		/// Destructor, unmaps the file
+		~MappedFile();
+
+		/// Start of the mapped file
+		inline const char * data() const { return data_; }
+
+		/// Size of the mapped file in bytes
+		inline size_t size() const { return size_; }
+
+		/** Advise the kernel that the mapping will be read from front to back, so it reads
+		 * ahead aggressively and drops pages soon after they are read. */
+		void sequential() const;
+	};
+
+} // Fs2a namespace
@@ -0,0 +1,216 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <fs2a/HeaderedTable.hpp>
+#include <fs2a/MappedFile.hpp>
+#include <fs2a/Table.hpp>
+
+namespace Fs2a {
+
+	/** Table in the Fs2a binary table format, mapped into memory.
+	 * Loading only checks the file header and column directory, cells are views into the
+	 * mapping and are never copied. Write files with writeBinary(), or use cacheCSV() to keep
+	 * a binary copy of a CSV file next to it.
+	 *
+	 * The format stores all numbers in the byte order of the writing machine, and is laid
+	 * out column by column:
+	 * - a fileHeader_t,
+	 * - a columnEntry_t for every column,
+	 * - for every column an array of rows + 1 uint64_t offsets, followed by a heap with
+	 *   the contents of its cells. Cell r spans offsets[r] up to offsets[r + 1] in the heap.
+	 *   Every array starts at a multiple of 8 bytes. */
+	class MappedTable
+	{
+		public:
+		/// File header
+		typedef struct fileHeader_s {
+			char magic[8];    ///< "FS2ATBL" with a terminating zero
+			uint32_t order;   ///< 0x01020304 in the byte order of the writer
+			uint32_t version; ///< Format version, 1
+			uint64_t flags;   ///< Combination of flag_e values, and the CSV separator in bits 8-15
+			uint64_t rows;    ///< Number of rows, including a header row
+			uint64_t columns; ///< Number of columns
+		} fileHeader_t;
+
+		/// Column directory entry
+		typedef struct columnEntry_s {
+			uint32_t type;     ///< Type of the column, only 0 for text is used for now
+			uint32_t reserved; ///< Zero
+			uint64_t offsets;  ///< File position of the offsets
+			uint64_t heap;     ///< File position of the heap
+			uint64_t heapSize; ///< Size of the heap in bytes
+		} columnEntry_t;
+
+		/// File header flags
+		enum flag_e : uint64_t {
+			headered = 1 ///< Row 0 holds the column names
+		};
+
+		/// Position of the separator of the CSV file a table was read from in the flags
+		static constexpr unsigned separatorShift = 8;
+
+		/// Format version written and understood
+		static constexpr uint32_t version = 1;
+
+		protected:
+		/// Mapping of the file
+		MappedFile file_;
+
+		/// Number of columns
+		colidx_t cols_;
+
+		/// Number of rows, including a header row
+		uint32_t rows_;
+
+		/// Flags from the file header
+		uint64_t flags_;
+
+		/// Offsets of the cells of every column
+		std::vector<const uint64_t *> offsets_;
+
+		/// Heap of every column
+		std::vector<const char *> heaps_;
+
+		/// Size of the heap of every column
+		std::vector<uint64_t> heapSizes_;
+
+		/// Column names to indices for headered tables, viewing into the mapping
+		std::unordered_map<std::string_view, colidx_t> hdrs_;
+
+		public:
+		/** Constructor, maps a binary table file.
+		 * @param path_i Path of the file
+		 * @throws std::runtime_error when the file can't be mapped or isn't a valid binary
+		 * table for this machine. */
+		explicit MappedTable(const std::string & path_i);
+
+		/// @{ Moving keeps all cell views valid, copying is not possible
+		MappedTable(MappedTable &&) = default;
+		MappedTable & operator=(MappedTable &&) = default;
+		/// @}
+
+		/// Number of columns
+		inline colidx_t columns() const { return cols_; }
+
+		/// Number of rows, including a header row
+		inline uint32_t rows() const { return rows_; }
+
+		/// Whether row 0 holds the column names
+		inline bool isHeadered() const { return flags_ & headered; }
+
+		/// Separator of the CSV file this table was read from, zero when unknown
+		inline char separator() const { return static_cast<char>(flags_ >> separatorShift & 0xFF); }
+
+		/** Unchecked access to a cell, for tight loops.
+		 * @param column_i Column, less than columns()
+		 * @param row_i Row, less than rows()
+		 * @returns View of the cell, valid for the lifetime of this table */
+		inline std::string_view operator()(const colidx_t column_i, const uint32_t row_i) const
+		{
+			const uint64_t * o = offsets_[column_i] + row_i;
+			return std::string_view(heaps_[column_i] + o[0], o[1] - o[0]);
+		}
+
+		/** Checked access to a cell.
+		 * @param column_i Column, zero based
+		 * @param row_i Row, zero based
+		 * @returns View of the cell, valid for the lifetime of this table
+		 * @throws std::out_of_range when the cell doesn't exist.
+		 * @throws std::runtime_error when the offsets of the cell are corrupt. */
+		std::string_view cell(const colidx_t column_i, const uint32_t row_i) const;
+
+		/** Checked access to a cell by column name.
+		 * @param colname_i Column name
+		 * @param row_i Row, header is row 0
+		 * @returns View of the cell, valid for the lifetime of this table
+		 * @throws std::invalid_argument when the column doesn't exist.
+		 * @throws std::logic_error when the table has no header. */
+		std::string_view cell(const std::string & colname_i, const uint32_t row_i) const;
+
+		/** Resolve a column name to its index.
+		 * @param colname_i Column name
+		 * @returns Column index
+		 * @throws std::invalid_argument when the column doesn't exist.
+		 * @throws std::logic_error when the table has no header. */
+		colidx_t columnIndex(const std::string & colname_i) const;
+
+		/** Convert to a table of strings.
+		 * @returns Table with a copy of every cell, which can be turned into a
+		 * HeaderedTable when isHeadered() */
+		Table<std::string> toTable() const;
+	};
+
+	/** Write a table in the binary table format.
+	 * @param table_i Table to write
+	 * @param stream_o Binary stream to write to
+	 * @param headered_i Whether row 0 holds column names
+	 * @param separator_i Separator of the CSV file the table was read from, zero when unknown
+	 * @throws std::runtime_error when writing fails. */
+	void writeBinary(const Table<std::string> & table_i, std::ostream & stream_o, const bool headered_i = false,
+		const char separator_i = 0);
+
+	/** Write a table to a file in the binary table format.
+	 * The file is written under a temporary name first and then renamed, so readers never
+	 * see a partial file.
+	 * @param table_i Table to write
+	 * @param path_i Path of the file
+	 * @param headered_i Whether row 0 holds column names
+	 * @param separator_i Separator of the CSV file the table was read from, zero when unknown
+	 * @throws std::runtime_error when writing fails. */
+	void writeBinary(const Table<std::string> & table_i, const std::string & path_i, const bool headered_i = false,
+		const char separator_i = 0);
+
+	/** Write a headered table to a file in the binary table format, with unique column names.
+	 * @param table_i Table to write
+	 * @param path_i Path of the file
+	 * @param separator_i Separator of the CSV file the table was read from, zero when unknown
+	 * @throws std::runtime_error when writing fails. */
+	void writeBinary(const HeaderedTable & table_i, const std::string & path_i, const char separator_i = 0);
+
+	/** Map the binary copy of a CSV file, creating or refreshing it when needed.
+	 * The copy is the CSV path with ".fs2t" added, and is refreshed when it is older than
+	 * the CSV file, differs in having a header or in its separator, or is unreadable.
+	 * @param csvPath_i Path of the CSV file
+	 * @param separator_i Separator of the CSV file
+	 * @param headered_i Whether the first line of the CSV file holds column names
+	 * @returns Mapped copy
+	 * @throws std::runtime_error when the CSV file can't be read or the copy can't be
+	 * written. */
+	MappedTable cacheCSV(const std::string & csvPath_i, const char separator_i = ';', const bool headered_i = true);
+
+} // Fs2a namespace
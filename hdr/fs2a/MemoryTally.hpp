@@ -0,0 +1,119 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace Fs2a {
+
+	/** Process wide tally of the memory used by live tables.
+	 * Every table holds an Account with the number of bytes it was last known to use, and the
+	 * tally is the sum of all accounts. Tables update their account when their cell storage
+	 * grows or shrinks, and measure the rest, like the heap bytes of strings, on
+	 * updateAccount() and compact(). Reading the tally is a single atomic load, so it can be
+	 * exported as a metric or checked against a budget while tables are being imported. */
+	class MemoryTally
+	{
+		protected:
+		/// Bytes in all accounts
+		static inline std::atomic<int64_t> live_ = 0;
+
+		/// Highest value of live_ since the last resetPeak()
+		static inline std::atomic<int64_t> peak_ = 0;
+
+		/** Add to the tally.
+		 * @param bytes_i Bytes to add, negative to subtract */
+		static void add_(const int64_t bytes_i)
+		{
+			const int64_t now = live_.fetch_add(bytes_i, std::memory_order_relaxed) + bytes_i;
+			int64_t peak = peak_.load(std::memory_order_relaxed);
+			while (now > peak && !peak_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+		}
+
+		public:
+		/** Bytes accounted for by a single table. Copies start empty, because the copy's
+		 * owner accounts for its own storage. Moves take over the bytes, like the storage. */
+		class Account
+		{
+			protected:
+			/// Bytes in the tally for this account
+			int64_t bytes_ = 0;
+
+			public:
+			/// Constructor
+			Account() = default;
+
+			/// @{ Copying, the new owner sets its own bytes
+			Account(const Account &) {}
+			Account & operator=(const Account &) { return *this; }
+			/// @}
+
+			/// @{ Moving, the bytes move with the storage
+			Account(Account && obj_io) noexcept : bytes_(std::exchange(obj_io.bytes_, 0)) {}
+			Account & operator=(Account && obj_io) noexcept
+			{
+				if (this != &obj_io) {
+					add_(-bytes_);
+					bytes_ = std::exchange(obj_io.bytes_, 0);
+				}
+				return *this;
+			}
+			/// @}
+
+			/// Destructor, takes the bytes out of the tally
+			~Account() { add_(-bytes_); }
+
+			/** Set the number of bytes for this account.
+			 * @param bytes_i Bytes now in use */
+			inline void set(const int64_t bytes_i)
+			{
+				if (bytes_i == bytes_) return;
+				add_(bytes_i - bytes_);
+				bytes_ = bytes_i;
+			}
+
+			/// @returns Bytes accounted for
+			inline int64_t bytes() const { return bytes_; }
+		};
+
+		/// @returns Bytes used by all live tables, as far as they accounted for them
+		static inline int64_t live() { return live_.load(std::memory_order_relaxed); }
+
+		/// @returns Highest number of live bytes since the start or the last resetPeak()
+		static inline int64_t peak() { return peak_.load(std::memory_order_relaxed); }
+
+		/// Restart tracking the peak from the current number of live bytes
+		static inline void resetPeak() { peak_.store(live(), std::memory_order_relaxed); }
+	};
+
+} // Fs2a namespace
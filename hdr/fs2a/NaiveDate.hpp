@@ -31,6 +31,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace Fs2a {
 
@@ -103,6 +104,12 @@ namespace Fs2a {
 		 * @throws std::logic_error when the internal date is not valid. */
 		std::string iso8601() const;
 
+		/** Parse a date from ISO8601 format like iso8601(), but without throwing or logging.
+		 * Meant for bulk conversion, where unparsable values are to be expected.
+		 * @param date_i Date in ISO8601 format, meaning YYYY-MM-DD.
+		 * @returns True when parsed and valid. When false, the date is unchanged. */
+		bool parse(std::string_view date_i);
+
 		/** Is the internally stored year a leap year?
 		 * @returns True if leap year, false if not.
 		 * @throws std::logic_error if year is invalid, i.e., 0. */
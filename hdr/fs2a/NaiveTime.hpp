@@ -31,6 +31,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace Fs2a {
 
@@ -104,6 +105,12 @@ namespace Fs2a {
 		 * @throws std::invalid_argument if given string can't be parsed. */
 		NaiveTime & operator=(const std::string & time_i);
 
+		/** Set the internal time from a string like operator=(), but without throwing or logging.
+		 * Meant for bulk conversion, where unparsable values are to be expected.
+		 * @param time_i Time in HH:MM, HH:M, H:MM or H:M format.
+		 * @returns True when parsed and valid. When false, the time is unchanged. */
+		bool parse(std::string_view time_i);
+
 		/** Check whether another NaiveTime object is earlier compared to this one.
 		 * @param rhs Other NaiveTime object to compare this one with.
 		 * @returns True if @p rhs object is later than this one.
@@ -125,6 +132,9 @@ namespace Fs2a {
 		 * @throws std::invalid_argument when @p rhs object is invalid. */
 		bool operator==(const NaiveTime & rhs) const;
 
+		/** Check whether both hour and minute are set. */
+		inline bool valid() const { return valid_(); }
+
 		/** Reset the internal time to unset. */
 		inline void reset() { hour_ = 0xFF; min_ = 0xFF; }
 
@@ -0,0 +1,79 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace Fs2a {
+
+	/** Number of hardware threads of this machine.
+	 * Querying it is a system call, so it is only done once.
+	 * @returns Number of hardware threads, at least 1 */
+	inline size_t hardwareThreads()
+	{
+		static const size_t threads = std::max(1U, std::thread::hardware_concurrency());
+		return threads;
+	}
+
+	/** Run a function for a number of parts, each part in its own thread.
+	 * Part 0 runs in the calling thread. Exceptions are rethrown in the
+	 * calling thread after all threads are joined, lowest part first.
+	 * @param parts_i Number of parts
+	 * @param func_i Function to call with the part number */
+	template <typename F>
+	void parallelParts(const size_t parts_i, F && func_i)
+	{
+		if (parts_i == 0) return;
+
+		std::vector<std::thread> threads;
+		std::vector<std::exception_ptr> errors(parts_i);
+		auto run = [&errors, &func_i](const size_t part_i) {
+			try { func_i(part_i); }
+			catch (...) { errors[part_i] = std::current_exception(); }
+		};
+
+		threads.reserve(parts_i - 1);
+		try {
+			for (size_t p = 1; p < parts_i; p++) threads.emplace_back(run, p);
+		} catch (...) {
+			for (auto & t : threads) t.join();
+			throw;
+		}
+		run(0);
+		for (auto & t : threads) t.join();
+		for (auto & e : errors) if (e) std::rethrow_exception(e);
+	}
+
+} // Fs2a namespace
@@ -0,0 +1,297 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <fs2a/ColumnTable.hpp>
+#include <fs2a/HeaderedTable.hpp>
+
+namespace Fs2a {
+
+	/** Set of selected rows of a table, as a bitmap.
+	 * Rows are data rows counted from zero, so for a HeaderedTable row 0 of a selection is
+	 * row 1 of the table. */
+	class Selection
+	{
+		protected:
+		/// Bitmap, bit r % 64 of word r / 64 is set when row r is selected
+		std::vector<uint64_t> words_;
+
+		/// Number of rows
+		size_t rows_;
+
+		/// Clear the bits beyond the last row
+		void trim_();
+
+		public:
+		/** Constructor.
+		 * @param rows_i Number of rows
+		 * @param all_i True to select all rows, false for none */
+		explicit Selection(const size_t rows_i = 0, const bool all_i = false);
+
+		/// Number of rows, selected or not
+		inline size_t size() const { return rows_; }
+
+		/// @returns Number of selected rows
+		size_t count() const;
+
+		/** Check whether a row is selected.
+		 * @param row_i Row to check
+		 * @returns False when not selected or out of range */
+		inline bool test(const size_t row_i) const {
+			return row_i < rows_ && (words_[row_i >> 6] >> (row_i & 63) & 1);
+		}
+
+		/** Select or deselect a row.
+		 * @param row_i Row, less than size()
+		 * @param selected_i Whether to select it */
+		inline void set(const size_t row_i, const bool selected_i = true) {
+			const uint64_t bit = uint64_t(1) << (row_i & 63);
+			if (selected_i) words_[row_i >> 6] |= bit;
+			else words_[row_i >> 6] &= ~bit;
+		}
+
+		/// @{ Raw bitmap words, see words_
+		inline std::span<const uint64_t> words() const { return words_; }
+		inline std::span<uint64_t> words() { return words_; }
+		/// @}
+
+		/** @{ Combine with another selection of the same size.
+		 * @throws std::invalid_argument when the sizes differ. */
+		Selection & operator&=(const Selection & rhs_i);
+		Selection & operator|=(const Selection & rhs_i);
+		/** @} */
+
+		/// Invert the selection
+		Selection & flip();
+
+		/** Call a function for every selected row, in ascending order.
+		 * @param func_i Function taking the row as size_t */
+		template <typename F>
+		void forEach(F && func_i) const
+		{
+			for (size_t w = 0; w < words_.size(); w++) {
+				for (uint64_t bits = words_[w]; bits; bits &= bits - 1) {
+					func_i(w * 64 + static_cast<size_t>(std::countr_zero(bits)));
+				}
+			}
+		}
+
+		/// @returns Selected rows, in ascending order
+		std::vector<uint32_t> indices() const;
+	};
+
+	/** Condition on the values of one or more columns, to select rows with.
+	 * Build leaves with the static methods and combine them with && and ||. Evaluation is done
+	 * column at a time into Selection bitmaps. An and-combination only evaluates later
+	 * conditions for the 64-row blocks that still have selected rows.
+	 *
+	 * On typed ColumnTable columns, values are compared in the native type of the column, and
+	 * missing values never match. Text columns evaluate the condition once per dictionary
+	 * entry. On string tables like HeaderedTable and on text columns, less, greater and between
+	 * compare numerically when all given values are numbers, in which case values that are no
+	 * number don't match. Otherwise, and for all other conditions, strings are compared as
+	 * they are. */
+	class Predicate
+	{
+		public:
+		/// Kinds of conditions
+		enum op_e : uint8_t {
+			opEqual,        ///< Equal to a value
+			opNotEqual,     ///< Not equal to a value
+			opLess,         ///< Less than a value
+			opLessEqual,    ///< Less than or equal to a value
+			opGreater,      ///< Greater than a value
+			opGreaterEqual, ///< Greater than or equal to a value
+			opBetween,      ///< Between two values, inclusive
+			opIn,           ///< Equal to one of a set of values
+			opPrefix,       ///< Text starting with a value
+			opAll,          ///< All child conditions hold
+			opAny           ///< Any of the child conditions holds
+		};
+
+		protected:
+		/// Kind of condition
+		op_e op_;
+
+		/// Column the condition is on, empty for combinations
+		std::string column_;
+
+		/// Values to compare with
+		std::vector<std::string> values_;
+
+		/// Conditions combined by opAll and opAny
+		std::vector<Predicate> children_;
+
+		/** Constructor for leaves.
+		 * @param op_i Kind of condition
+		 * @param column_i Column name
+		 * @param values_i Values to compare with */
+		Predicate(const op_e op_i, const std::string & column_i, std::vector<std::string> values_i);
+
+		/** Combine two conditions, flattening nested combinations of the same kind.
+		 * @param op_i opAll or opAny
+		 * @param lhs_i First condition
+		 * @param rhs_i Second condition
+		 * @returns Combination */
+		static Predicate combine_(const op_e op_i, Predicate lhs_i, Predicate rhs_i);
+
+		/** Evaluate this condition.
+		 * @param table_i Table to evaluate on, a HeaderedTable or ColumnTable
+		 * @param rows_i Number of data rows
+		 * @param mask_i Only rows in 64-row blocks with a selected row in here need to be
+		 * correct, nullptr for all
+		 * @returns Selected rows */
+		template <typename TableT>
+		Selection evaluate_(TableT & table_i, const size_t rows_i, const Selection * mask_i) const;
+
+		/** Evaluate a leaf on a column of strings.
+		 * @param table_i Table to evaluate on
+		 * @param mask_i See evaluate_()
+		 * @param out_o Selection to fill, of the right size */
+		void leaf_(HeaderedTable & table_i, const Selection * mask_i, Selection & out_o) const;
+
+		/// @see leaf_(HeaderedTable &, const Selection *, Selection &) const
+		void leaf_(const ColumnTable & table_i, const Selection * mask_i, Selection & out_o) const;
+
+		public:
+		/** @{ Compare a column to a value.
+		 * @param column_i Column name
+		 * @param value_i Value to compare with */
+		static Predicate equal(const std::string & column_i, const std::string & value_i);
+		static Predicate notEqual(const std::string & column_i, const std::string & value_i);
+		static Predicate less(const std::string & column_i, const std::string & value_i);
+		static Predicate lessEqual(const std::string & column_i, const std::string & value_i);
+		static Predicate greater(const std::string & column_i, const std::string & value_i);
+		static Predicate greaterEqual(const std::string & column_i, const std::string & value_i);
+		/** @} */
+
+		/** Check whether a column is in a range.
+		 * @param column_i Column name
+		 * @param low_i Lowest value, inclusive
+		 * @param high_i Highest value, inclusive */
+		static Predicate between(const std::string & column_i, const std::string & low_i, const std::string & high_i);
+
+		/** Check whether a column has one of a set of values.
+		 * @param column_i Column name
+		 * @param values_i Values */
+		static Predicate in(const std::string & column_i, const std::vector<std::string> & values_i);
+
+		/** Check whether a text column starts with a value.
+		 * @param column_i Column name
+		 * @param prefix_i Prefix */
+		static Predicate startsWith(const std::string & column_i, const std::string & prefix_i);
+
+		/// Kind of this condition
+		inline op_e op() const { return op_; }
+
+		/** @{ Select the rows of a table for which this condition holds.
+		 * @param table_i Table to evaluate on
+		 * @returns Selected data rows
+		 * @throws std::invalid_argument when a column doesn't exist, or a value can't be
+		 * compared with the type of a typed column. */
+		Selection evaluate(HeaderedTable & table_i) const;
+		Selection evaluate(const ColumnTable & table_i) const;
+		/** @} */
+
+		/// @{ Combine conditions
+		friend Predicate operator&&(Predicate lhs_i, Predicate rhs_i);
+		friend Predicate operator||(Predicate lhs_i, Predicate rhs_i);
+		/// @}
+	};
+
+	/** Read-only view on the selected rows of a HeaderedTable, without copying them.
+	 * Row 0 is the header, like in the table itself. The table should outlive the view, and
+	 * shouldn't change its number of rows while viewed. */
+	class TableView
+	{
+		protected:
+		/// Viewed table
+		HeaderedTable & table_;
+
+		/// Rows of the table in view, starting with the header row 0
+		std::vector<uint32_t> rows_;
+
+		public:
+		/** Constructor.
+		 * @param table_i Table to view
+		 * @param selection_i Selected data rows of the table */
+		TableView(HeaderedTable & table_i, const Selection & selection_i);
+
+		/// Number of columns
+		inline colidx_t columns() const { return table_.columns(); }
+
+		/// Number of rows in view, including the header
+		inline uint32_t rows() const { return static_cast<uint32_t>(rows_.size()); }
+
+		/** Row of the table a row of the view refers to.
+		 * @param row_i Row of the view, less than rows()
+		 * @returns Row of the table */
+		inline uint32_t sourceRow(const uint32_t row_i) const { return rows_[row_i]; }
+
+		/** Unchecked access to a cell.
+		 * @param column_i Column, less than columns()
+		 * @param row_i Row of the view, less than rows()
+		 * @returns Cell of the table */
+		inline const std::string & operator()(const colidx_t column_i, const uint32_t row_i) const
+		{
+			return table_(column_i, rows_[row_i]);
+		}
+
+		/** @{ Checked access to a cell.
+		 * @param column_i Column index or name
+		 * @param row_i Row of the view, header is row 0
+		 * @returns Cell of the table
+		 * @throws std::out_of_range when the cell doesn't exist.
+		 * @throws std::invalid_argument when the column name doesn't exist. */
+		const std::string & cell(const colidx_t column_i, const uint32_t row_i) const;
+		const std::string & cell(const std::string & colname_i, const uint32_t row_i) const;
+		/** @} */
+
+		/** Copy the rows in view to a new table.
+		 * @returns Table with the header and the rows in view */
+		HeaderedTable toTable() const;
+	};
+
+	/** Select rows of a table into a view.
+	 * @param table_i Table to filter, should outlive the view
+	 * @param predicate_i Condition rows should meet
+	 * @returns View on the rows meeting the condition */
+	inline TableView filter(HeaderedTable & table_i, const Predicate & predicate_i)
+	{
+		return TableView(table_i, predicate_i.evaluate(table_i));
+	}
+
+} // Fs2a namespace
@@ -0,0 +1,343 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fs2a/Parallel.hpp>
+#include <fs2a/Table.hpp>
+
+namespace Fs2a {
+
+	/** Class that models a two-dimensional array like Table, stored in row groups.
+	 * Every row group holds a fixed number of rows in one allocation that is made once, so
+	 * adding rows never moves existing cells: their addresses stay valid until their rows
+	 * are removed. Memory grows one group at a time instead of doubling and copying a single
+	 * vector, and rows are addressed with 64-bit indices. Each group can be processed on its
+	 * own, see forEachGroup().
+	 * The number of columns can't be altered when set, but the number of rows can change
+	 * throughout the lifetime of the object. */
+	template <typename T>
+	class RowGroupTable
+	{
+		protected:
+		/** Number of columns in this table. 0 if not yet specified. */
+		colidx_t cols_;
+
+		/** Number of rows per group, a power of two. */
+		uint32_t groupRows_;
+
+		/** Base 2 logarithm of groupRows_, to find a group by shifting. */
+		uint8_t groupShift_;
+
+		/** Number of rows in this table. */
+		uint64_t rows_;
+
+		/** Row groups. Every group has its full capacity reserved and
+		 * only the last one can be partially filled. Within a group, cells
+		 * are grouped by row like in Table. */
+		std::vector<std::vector<T>> groups_;
+
+		/** Check whether the number of columns has been set. */
+		void columnsCheck_() const
+		{
+			if (cols_ == 0) {
+				throw std::logic_error("Please set the number of columns first");
+			}
+		}
+
+		/** Add a group with its full capacity reserved.
+		 * @returns Reference to the new group */
+		std::vector<T> & addGroup_()
+		{
+			groups_.emplace_back().reserve(static_cast<size_t>(groupRows_) * cols_);
+			return groups_.back();
+		}
+
+		/** Check whether a row with a number of cells can be appended.
+		 * @param cells_i Number of cells in the new row
+		 * @returns Group to append the row to */
+		std::vector<T> & appendGroup_(const size_t cells_i)
+		{
+			using namespace std::string_literals;
+
+			columnsCheck_();
+			if (cells_i != cols_) {
+				throw std::invalid_argument("Row to append has "s + std::to_string(cells_i) +
+					" cells, but the number of columns is "s + std::to_string(cols_));
+			}
+			if (rows_ >> groupShift_ == groups_.size()) return addGroup_();
+			return groups_.back();
+		}
+
+		public:
+		/** Constructor.
+		 * @param groupRows_i Number of rows per group, a power of two
+		 * @throws std::invalid_argument when @p groupRows_i is not a power of two. */
+		explicit RowGroupTable(const uint32_t groupRows_i = 65536)
+		: cols_(0), groupRows_(groupRows_i), groupShift_(0), rows_(0)
+		{
+			if (!std::has_single_bit(groupRows_i)) {
+				throw std::invalid_argument("Number of rows per group should be a power of two");
+			}
+			groupShift_ = static_cast<uint8_t>(std::countr_zero(groupRows_i));
+		}
+
+		/** Conversion from a Table.
+		 * @param table_i Table to copy all cells from
+		 * @param groupRows_i Number of rows per group, a power of two */
+		explicit RowGroupTable(const Table<T> & table_i, const uint32_t groupRows_i = 65536)
+		: RowGroupTable(groupRows_i)
+		{
+			if (table_i.columns() == 0) return;
+			columns(table_i.columns());
+			for (uint32_t r = 0; r < table_i.rows(); r++) appendRow(table_i.row(r));
+		}
+
+		/// @{ Copying reserves full groups, so cell addresses in the copy are stable too
+		RowGroupTable(const RowGroupTable & obj_i)
+		: cols_(obj_i.cols_), groupRows_(obj_i.groupRows_), groupShift_(obj_i.groupShift_), rows_(obj_i.rows_)
+		{
+			// A plain vector copy would only reserve the used part of the last group
+			groups_.reserve(obj_i.groups_.size());
+			for (const auto & g : obj_i.groups_) addGroup_().assign(g.begin(), g.end());
+		}
+		RowGroupTable(RowGroupTable &&) = default;
+		RowGroupTable & operator=(const RowGroupTable & obj_i)
+		{
+			if (this != &obj_i) *this = RowGroupTable(obj_i);
+			return *this;
+		}
+		RowGroupTable & operator=(RowGroupTable &&) = default;
+		/// @}
+
+		/** Get the number of columns in this table.
+		 * @returns number of columns, 0 if not yet specified. */
+		inline colidx_t columns() const { return cols_; }
+
+		/** Set the number of columns in this table.
+		 * Can only be specified once and should be greater than zero.
+		 * @param columns_i Number of columns to allocate (>0)
+		 * @throws std::invalid_argument when columns_i == 0
+		 * @throws std::logic_error when number of columns was already set. */
+		void columns(const colidx_t columns_i)
+		{
+			using namespace std::string_literals;
+
+			if (columns_i == 0) {
+				throw std::invalid_argument("Number of columns not allowed to be 0");
+			}
+			if (cols_ != 0 && columns_i != cols_) {
+				throw std::logic_error("Number of columns is already set to "s + std::to_string(cols_));
+			}
+
+			cols_ = columns_i;
+		}
+
+		/** Fetch a reference to a specific field, increasing the number of
+		 * rows if necessary.
+		 * @param column_i Column of field to fetch, zero based
+		 * @param row_i Row of field to fetch, zero based
+		 * @returns Reference to field
+		 * @throws std::out_of_range if requested column is outside of
+		 * column range. */
+		T & cell(const colidx_t column_i, const uint64_t row_i)
+		{
+			using namespace std::string_literals;
+
+			columnsCheck_();
+			if (column_i >= cols_) {
+				throw std::out_of_range("Requested column "s + std::to_string(column_i) +
+					" should be less than the number of columns, which is "s + std::to_string(cols_));
+			}
+			if (row_i >= rows_) rows(row_i + 1);
+
+			return (*this)(column_i, row_i);
+		}
+
+		/** @{ Unchecked access to a specific field, for tight loops.
+		 * The field must exist, so the column must be less than columns()
+		 * and the row less than rows().
+		 * @param column_i Column of field, zero based
+		 * @param row_i Row of field, zero based
+		 * @returns Reference to field */
+		inline T & operator()(const colidx_t column_i, const uint64_t row_i)
+		{
+			return groups_[row_i >> groupShift_][(row_i & (groupRows_ - 1)) * cols_ + column_i];
+		}
+
+		inline const T & operator()(const colidx_t column_i, const uint64_t row_i) const
+		{
+			return groups_[row_i >> groupShift_][(row_i & (groupRows_ - 1)) * cols_ + column_i];
+		}
+		/** @} */
+
+		/** @{ Access all fields of a row at once.
+		 * @param row_i Row to access, zero based
+		 * @returns Span over the fields of the row, valid until the row is removed
+		 * @throws std::out_of_range if the row doesn't exist. */
+		std::span<T> row(const uint64_t row_i)
+		{
+			if (row_i >= rows_) throw std::out_of_range("Requested row " + std::to_string(row_i) + " doesn't exist");
+			return std::span<T>(&(*this)(0, row_i), cols_);
+		}
+
+		std::span<const T> row(const uint64_t row_i) const
+		{
+			if (row_i >= rows_) throw std::out_of_range("Requested row " + std::to_string(row_i) + " doesn't exist");
+			return std::span<const T>(&(*this)(0, row_i), cols_);
+		}
+		/** @} */
+
+		/** Get the number of rows in this table.
+		 * @returns Number of allocated rows */
+		inline uint64_t rows() const { return rows_; }
+
+		/** Set the number of rows, thereby either removing data in rows
+		 * beyond the new rowcount or adding empty rows.
+		 * @param rows_i New rowcount
+		 * @throws std::logic_error when number of columns hasn't been set
+		 * yet. */
+		void rows(const uint64_t rows_i)
+		{
+			columnsCheck_();
+
+			const size_t groups = static_cast<size_t>((rows_i + groupRows_ - 1) >> groupShift_);
+			if (groups < groups_.size()) groups_.resize(groups);
+			while (groups_.size() < groups) {
+				// Fill up the current last group before adding another
+				if (!groups_.empty()) groups_.back().resize(static_cast<size_t>(groupRows_) * cols_);
+				addGroup_();
+			}
+			if (groups) {
+				groups_.back().resize(static_cast<size_t>(rows_i - (static_cast<uint64_t>(groups - 1) << groupShift_)) * cols_);
+			}
+			rows_ = rows_i;
+		}
+
+		/** Append a full row by copying its cells.
+		 * @param row_i Cells of the new row, one for every column
+		 * @returns Index of the new row
+		 * @throws std::logic_error when number of columns hasn't been set
+		 * yet.
+		 * @throws std::invalid_argument when the number of cells doesn't
+		 * match the number of columns. */
+		uint64_t appendRow(std::span<const T> row_i)
+		{
+			std::vector<T> & g = appendGroup_(row_i.size());
+			g.insert(g.end(), row_i.begin(), row_i.end());
+			return rows_++;
+		}
+
+		/** Append a full row by constructing its cells in place.
+		 * @param args_i One constructor argument for every column
+		 * @returns Index of the new row
+		 * @throws std::logic_error when number of columns hasn't been set
+		 * yet.
+		 * @throws std::invalid_argument when the number of arguments doesn't
+		 * match the number of columns.
+		 * Anything thrown by a cell constructor is passed on, after removing
+		 * the cells of the new row that were already constructed. */
+		template <typename... Args>
+		uint64_t emplaceRow(Args &&... args_i)
+		{
+			std::vector<T> & g = appendGroup_(sizeof...(Args));
+			const size_t old = g.size();
+			try {
+				(g.emplace_back(std::forward<Args>(args_i)), ...);
+			} catch (...) {
+				g.erase(g.begin() + old, g.end());
+				if (g.empty()) groups_.pop_back();
+				throw;
+			}
+			return rows_++;
+		}
+
+		/// Number of rows per group
+		inline uint32_t groupRows() const { return groupRows_; }
+
+		/// Number of row groups
+		inline size_t groups() const { return groups_.size(); }
+
+		/** @{ Access all fields of a row group at once.
+		 * @param group_i Group to access, zero based. Its first row is
+		 * group_i * groupRows().
+		 * @returns Span over the fields of all rows in the group, grouped by
+		 * row. Only the last group can have less than groupRows() rows.
+		 * @throws std::out_of_range if the group doesn't exist. */
+		std::span<T> group(const size_t group_i) { return groups_.at(group_i); }
+		std::span<const T> group(const size_t group_i) const { return groups_.at(group_i); }
+		/** @} */
+
+		/** Call a function for every row group, optionally in parallel.
+		 * Groups are handed out to threads one at a time, so a slow group
+		 * doesn't hold up the others.
+		 * @param func_i Function to call with a span over the cells of a
+		 * group, see group(), and the index of the first row in that group
+		 * @param threads_i Number of threads to use, 0 for all hardware
+		 * threads */
+		template <typename F>
+		void forEachGroup(F && func_i, const unsigned threads_i = 1)
+		{
+			const size_t threads = std::min<size_t>(groups_.size(), threads_i ? threads_i : hardwareThreads());
+			std::atomic<size_t> next = 0;
+
+			parallelParts(threads, [&](const size_t) {
+				for (size_t g = next++; g < groups_.size(); g = next++) {
+					func_i(std::span<T>(groups_[g]), static_cast<uint64_t>(g) << groupShift_);
+				}
+			});
+		}
+
+		/** Convert to a Table.
+		 * @returns Table with a copy of every cell
+		 * @throws std::out_of_range when there are too many rows for a Table. */
+		Table<T> toTable() const
+		{
+			Table<T> t;
+
+			if (rows_ > UINT32_MAX) throw std::out_of_range("Too many rows to convert to Table");
+			if (cols_ == 0) return t;
+			t.columns(cols_);
+			t.reserve(static_cast<uint32_t>(rows_));
+			for (uint64_t r = 0; r < rows_; r++) t.appendRow(row(r));
+			return t;
+		}
+	};
+
+} // Fs2a namespace
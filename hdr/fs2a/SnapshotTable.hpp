@@ -0,0 +1,446 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fs2a/Table.hpp>
+
+namespace Fs2a {
+
+	/** Immutable version of a table, stored in row groups like RowGroupTable.
+	 * A snapshot never changes after it is built, so any number of threads can read it
+	 * without locking. Row groups are reference counted and shared between snapshots: a
+	 * Builder that starts from a snapshot only copies the groups it modifies, so publishing
+	 * a new version of a large table costs a copy of the changed groups, not of the table.
+	 * Groups and snapshots are freed when their last user releases them.
+	 * Snapshots are handed out as std::shared_ptr<const SnapshotTable>, see SnapshotPublisher. */
+	template <typename T>
+	class SnapshotTable
+	{
+		public:
+		class Builder;
+
+		/// Shared row group, cells are grouped by row like in Table
+		typedef std::shared_ptr<const std::vector<T>> group_t;
+
+		protected:
+		/** Number of columns in this table. */
+		colidx_t cols_;
+
+		/** Number of rows per group, a power of two. */
+		uint32_t groupRows_;
+
+		/** Base 2 logarithm of groupRows_, to find a group by shifting. */
+		uint8_t groupShift_;
+
+		/** Number of rows in this table. */
+		uint64_t rows_;
+
+		/** Row groups, only the last one can be partially filled. */
+		std::vector<group_t> groups_;
+
+		/// Constructor, for Builder::build()
+		SnapshotTable(const colidx_t cols_i, const uint32_t groupRows_i, const uint8_t groupShift_i,
+			const uint64_t rows_i, std::vector<group_t> groups_i)
+		: cols_(cols_i), groupRows_(groupRows_i), groupShift_(groupShift_i), rows_(rows_i), groups_(std::move(groups_i))
+		{ }
+
+		public:
+		/// Get the number of columns in this table
+		inline colidx_t columns() const { return cols_; }
+
+		/// Get the number of rows in this table
+		inline uint64_t rows() const { return rows_; }
+
+		/// Number of rows per group
+		inline uint32_t groupRows() const { return groupRows_; }
+
+		/// Number of row groups
+		inline size_t groups() const { return groups_.size(); }
+
+		/** Unchecked access to a specific field, for tight loops.
+		 * The field must exist, so the column must be less than columns()
+		 * and the row less than rows().
+		 * @param column_i Column of field, zero based
+		 * @param row_i Row of field, zero based
+		 * @returns Reference to field, valid as long as this snapshot */
+		inline const T & operator()(const colidx_t column_i, const uint64_t row_i) const
+		{
+			return (*groups_[row_i >> groupShift_])[(row_i & (groupRows_ - 1)) * cols_ + column_i];
+		}
+
+		/** Fetch a specific field.
+		 * @param column_i Column of field, zero based
+		 * @param row_i Row of field, zero based
+		 * @returns Reference to field, valid as long as this snapshot
+		 * @throws std::out_of_range if the field doesn't exist. */
+		const T & cell(const colidx_t column_i, const uint64_t row_i) const
+		{
+			using namespace std::string_literals;
+
+			if (column_i >= cols_ || row_i >= rows_) {
+				throw std::out_of_range("Requested field "s + std::to_string(column_i) + ", "s + std::to_string(row_i) +
+					" doesn't exist in a snapshot of "s + std::to_string(cols_) + " columns and "s +
+					std::to_string(rows_) + " rows");
+			}
+			return (*this)(column_i, row_i);
+		}
+
+		/** Access all fields of a row at once.
+		 * @param row_i Row to access, zero based
+		 * @returns Span over the fields of the row
+		 * @throws std::out_of_range if the row doesn't exist. */
+		std::span<const T> row(const uint64_t row_i) const
+		{
+			if (row_i >= rows_) throw std::out_of_range("Requested row " + std::to_string(row_i) + " doesn't exist");
+			return std::span<const T>(&(*this)(0, row_i), cols_);
+		}
+
+		/** Access all fields of a row group at once.
+		 * @param group_i Group to access, zero based
+		 * @returns Span over the fields of all rows in the group, grouped by row
+		 * @throws std::out_of_range if the group doesn't exist. */
+		std::span<const T> group(const size_t group_i) const { return *groups_.at(group_i); }
+
+		/** Check whether a row group is shared with another snapshot, which means that
+		 * none of its rows were changed between the two.
+		 * @param other_i Snapshot to compare with
+		 * @param group_i Group to check, zero based
+		 * @returns True when both snapshots have that group and share its storage */
+		bool shares(const SnapshotTable & other_i, const size_t group_i) const
+		{
+			return group_i < groups_.size() && group_i < other_i.groups_.size() &&
+				groups_[group_i] == other_i.groups_[group_i];
+		}
+
+		/** Convert to a Table.
+		 * @returns Table with a copy of every cell
+		 * @throws std::out_of_range when there are too many rows for a Table. */
+		Table<T> toTable() const
+		{
+			Table<T> t;
+
+			if (rows_ > UINT32_MAX) throw std::out_of_range("Too many rows to convert to Table");
+			if (cols_ == 0) return t;
+			t.columns(cols_);
+			t.reserve(static_cast<uint32_t>(rows_));
+			for (uint64_t r = 0; r < rows_; r++) t.appendRow(row(r));
+			return t;
+		}
+	};
+
+	/** Writer that prepares the next version of a snapshot table.
+	 * It starts out sharing every row group with the snapshot it is based on. The first
+	 * write into a shared group copies that group, later writes into it are in place.
+	 * build() turns the current state into a new snapshot, after which the builder shares
+	 * all its groups with that snapshot again. A builder is meant for a single thread. */
+	template <typename T>
+	class SnapshotTable<T>::Builder
+	{
+		protected:
+		/** Number of columns in this table. */
+		colidx_t cols_;
+
+		/** Number of rows per group, a power of two. */
+		uint32_t groupRows_;
+
+		/** Base 2 logarithm of groupRows_, to find a group by shifting. */
+		uint8_t groupShift_;
+
+		/** Number of rows in this table. */
+		uint64_t rows_;
+
+		/** Row groups, shared or private. */
+		std::vector<group_t> groups_;
+
+		/** Writable pointer for every group that is private to this builder, nullptr for
+		 * groups that are shared with a snapshot. */
+		std::vector<std::vector<T> *> owned_;
+
+		/** Add a private group with its full capacity reserved.
+		 * @returns Reference to the new group */
+		std::vector<T> & addGroup_()
+		{
+			auto g = std::make_shared<std::vector<T>>();
+			g->reserve(static_cast<size_t>(groupRows_) * cols_);
+			owned_.push_back(g.get());
+			groups_.push_back(std::move(g));
+			return *owned_.back();
+		}
+
+		/** Make a group private, copying it if it is shared.
+		 * @param group_i Group to write to
+		 * @returns Reference to the private group */
+		std::vector<T> & own_(const size_t group_i)
+		{
+			if (owned_[group_i] == nullptr) {
+				auto g = std::make_shared<std::vector<T>>();
+				g->reserve(static_cast<size_t>(groupRows_) * cols_);
+				g->assign(groups_[group_i]->begin(), groups_[group_i]->end());
+				owned_[group_i] = g.get();
+				groups_[group_i] = std::move(g);
+			}
+			return *owned_[group_i];
+		}
+
+		/** Check whether a row with a number of cells can be appended.
+		 * @param cells_i Number of cells in the new row
+		 * @returns Group to append the row to */
+		std::vector<T> & appendGroup_(const size_t cells_i)
+		{
+			using namespace std::string_literals;
+
+			if (cells_i != cols_) {
+				throw std::invalid_argument("Row to append has "s + std::to_string(cells_i) +
+					" cells, but the number of columns is "s + std::to_string(cols_));
+			}
+			if (rows_ >> groupShift_ == groups_.size()) return addGroup_();
+			return own_(groups_.size() - 1);
+		}
+
+		public:
+		/** Constructor for an empty table.
+		 * @param columns_i Number of columns
+		 * @param groupRows_i Number of rows per group, a power of two
+		 * @throws std::invalid_argument when @p columns_i is 0 or @p groupRows_i is not a power of two. */
+		explicit Builder(const colidx_t columns_i, const uint32_t groupRows_i = 65536)
+		: cols_(columns_i), groupRows_(groupRows_i), groupShift_(0), rows_(0)
+		{
+			if (columns_i == 0) throw std::invalid_argument("Number of columns not allowed to be 0");
+			if (!std::has_single_bit(groupRows_i)) {
+				throw std::invalid_argument("Number of rows per group should be a power of two");
+			}
+			groupShift_ = static_cast<uint8_t>(std::countr_zero(groupRows_i));
+		}
+
+		/** Constructor that copies a Table.
+		 * @param table_i Table to copy all cells from
+		 * @param groupRows_i Number of rows per group, a power of two
+		 * @throws std::invalid_argument when the table has no columns or @p groupRows_i is
+		 * not a power of two. */
+		explicit Builder(const Table<T> & table_i, const uint32_t groupRows_i = 65536)
+		: Builder(table_i.columns(), groupRows_i)
+		{
+			for (uint32_t r = 0; r < table_i.rows(); r++) appendRow(table_i.row(r));
+		}
+
+		/** Constructor for the next version of a snapshot, sharing all its groups.
+		 * @param base_i Snapshot to start from */
+		explicit Builder(const SnapshotTable & base_i)
+		: cols_(base_i.cols_), groupRows_(base_i.groupRows_), groupShift_(base_i.groupShift_), rows_(base_i.rows_),
+			groups_(base_i.groups_), owned_(groups_.size(), nullptr)
+		{ }
+
+		/// Not copyable, two builders would write in place into the same private groups
+		Builder(const Builder &) = delete;
+		Builder & operator=(const Builder &) = delete;
+
+		/// Movable, the private groups go along with it
+		Builder(Builder &&) = default;
+		Builder & operator=(Builder &&) = default;
+
+		/// Get the number of columns in this table
+		inline colidx_t columns() const { return cols_; }
+
+		/// Get the number of rows in this table
+		inline uint64_t rows() const { return rows_; }
+
+		/** Set the number of rows, thereby either removing data in rows
+		 * beyond the new rowcount or adding empty rows.
+		 * @param rows_i New rowcount */
+		void rows(const uint64_t rows_i)
+		{
+			const size_t groups = static_cast<size_t>((rows_i + groupRows_ - 1) >> groupShift_);
+			if (groups < groups_.size()) {
+				groups_.resize(groups);
+				owned_.resize(groups);
+			}
+			while (groups_.size() < groups) {
+				// Fill up the current last group before adding another
+				if (!groups_.empty()) own_(groups_.size() - 1).resize(static_cast<size_t>(groupRows_) * cols_);
+				addGroup_();
+			}
+			if (groups) {
+				const size_t cells = static_cast<size_t>(rows_i - (static_cast<uint64_t>(groups - 1) << groupShift_)) * cols_;
+				if (groups_.back()->size() != cells) own_(groups - 1).resize(cells);
+			}
+			rows_ = rows_i;
+		}
+
+		/** Read a specific field, without checking or copying.
+		 * @param column_i Column of field, zero based
+		 * @param row_i Row of field, zero based
+		 * @returns Reference to field */
+		inline const T & operator()(const colidx_t column_i, const uint64_t row_i) const
+		{
+			return (*groups_[row_i >> groupShift_])[(row_i & (groupRows_ - 1)) * cols_ + column_i];
+		}
+
+		/** Fetch a writable reference to a specific field, increasing the number of rows if
+		 * necessary. The group of the field is copied first when it is shared.
+		 * @param column_i Column of field to fetch, zero based
+		 * @param row_i Row of field to fetch, zero based
+		 * @returns Reference to field, valid until build()
+		 * @throws std::out_of_range if requested column is outside of
+		 * column range. */
+		T & cell(const colidx_t column_i, const uint64_t row_i)
+		{
+			using namespace std::string_literals;
+
+			if (column_i >= cols_) {
+				throw std::out_of_range("Requested column "s + std::to_string(column_i) +
+					" should be less than the number of columns, which is "s + std::to_string(cols_));
+			}
+			if (row_i >= rows_) rows(row_i + 1);
+			return own_(row_i >> groupShift_)[(row_i & (groupRows_ - 1)) * cols_ + column_i];
+		}
+
+		/** Append a full row by copying its cells.
+		 * @param row_i Cells of the new row, one for every column
+		 * @returns Index of the new row
+		 * @throws std::invalid_argument when the number of cells doesn't
+		 * match the number of columns. */
+		uint64_t appendRow(std::span<const T> row_i)
+		{
+			std::vector<T> & g = appendGroup_(row_i.size());
+			g.insert(g.end(), row_i.begin(), row_i.end());
+			return rows_++;
+		}
+
+		/** Append a full row by constructing its cells in place.
+		 * @param args_i One constructor argument for every column
+		 * @returns Index of the new row
+		 * @throws std::invalid_argument when the number of arguments doesn't
+		 * match the number of columns.
+		 * Anything thrown by a cell constructor is passed on, after removing
+		 * the cells of the new row that were already constructed. */
+		template <typename... Args>
+		uint64_t emplaceRow(Args &&... args_i)
+		{
+			std::vector<T> & g = appendGroup_(sizeof...(Args));
+			const size_t old = g.size();
+			try {
+				(g.emplace_back(std::forward<Args>(args_i)), ...);
+			} catch (...) {
+				g.erase(g.begin() + old, g.end());
+				if (g.empty()) {
+					groups_.pop_back();
+					owned_.pop_back();
+				}
+				throw;
+			}
+			return rows_++;
+		}
+
+		/// @returns Number of groups that were copied or added since the last build()
+		size_t owned() const
+		{
+			size_t n = 0;
+			for (const std::vector<T> * g : owned_) n += g != nullptr;
+			return n;
+		}
+
+		/** Create a snapshot of the current state. Groups that were written are handed over
+		 * to the snapshot, so writing them again copies them again.
+		 * @returns New snapshot */
+		std::shared_ptr<const SnapshotTable> build()
+		{
+			std::fill(owned_.begin(), owned_.end(), nullptr);
+			return std::shared_ptr<const SnapshotTable>(new SnapshotTable(cols_, groupRows_, groupShift_, rows_, groups_));
+		}
+	};
+
+	/** Publication point of the current snapshot of a table.
+	 * Readers fetch the current snapshot and keep using it for as long as they hold it,
+	 * while a single writer prepares the next version with a SnapshotTable::Builder and
+	 * publishes it. Fetching and publishing are single atomic operations on a shared pointer,
+	 * so readers never wait for the writer and never see a half written table. */
+	template <typename T>
+	class SnapshotPublisher
+	{
+		public:
+		/// Snapshot as handed out to readers
+		typedef std::shared_ptr<const SnapshotTable<T>> snapshot_t;
+
+		protected:
+		/// Current snapshot
+		std::atomic<snapshot_t> cur_;
+
+		public:
+		/** Constructor.
+		 * @param snapshot_i First snapshot, can be empty */
+		explicit SnapshotPublisher(snapshot_t snapshot_i = nullptr)
+		: cur_(std::move(snapshot_i))
+		{ }
+
+		/// Not copyable or movable, readers and the writer refer to it
+		SnapshotPublisher(const SnapshotPublisher &) = delete;
+		SnapshotPublisher & operator=(const SnapshotPublisher &) = delete;
+
+		/// @returns The current snapshot, valid for as long as the caller keeps it
+		inline snapshot_t snapshot() const { return cur_.load(std::memory_order_acquire); }
+
+		/** Replace the current snapshot. Readers of the previous snapshot keep it until they
+		 * release it.
+		 * @param snapshot_i New snapshot */
+		inline void publish(snapshot_t snapshot_i) { cur_.store(std::move(snapshot_i), std::memory_order_release); }
+
+		/** Build a snapshot from a builder and publish it.
+		 * @param builder_io Builder to build from
+		 * @returns The published snapshot */
+		snapshot_t publish(typename SnapshotTable<T>::Builder & builder_io)
+		{
+			snapshot_t s = builder_io.build();
+			publish(s);
+			return s;
+		}
+
+		/** Start the next version of the current snapshot.
+		 * @returns Builder sharing all groups with the current snapshot
+		 * @throws std::logic_error when nothing was published yet. */
+		typename SnapshotTable<T>::Builder edit() const
+		{
+			snapshot_t s = snapshot();
+			if (!s) throw std::logic_error("No snapshot published yet");
+			return typename SnapshotTable<T>::Builder(*s);
+		}
+	};
+
+} // Fs2a namespace
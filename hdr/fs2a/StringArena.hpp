@@ -0,0 +1,125 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Fs2a {
+
+	/** Chunked bump allocator for strings.
+	 * Strings are copied back to back into large chunks, so storing one costs a pointer increment
+	 * instead of a heap allocation. Stored strings never move until the arena is cleared or
+	 * destroyed, which frees all of them at once, in one deallocation per chunk. */
+	class StringArena
+	{
+		protected:
+		/// All chunks owned by this arena
+		std::vector<std::unique_ptr<char[]>> chunks_;
+
+		/// Next free byte in the current chunk, which need not be the last one in chunks_
+		char * cur_;
+
+		/// Bytes left in the current chunk
+		size_t left_;
+
+		/// Size of a regular chunk
+		size_t chunkSize_;
+
+		/// Total number of bytes in all chunks
+		size_t capacity_;
+
+		/// Number of bytes handed out
+		size_t used_;
+
+		/** Allocate memory that doesn't fit in the current chunk.
+		 * @param len_i Number of bytes needed
+		 * @returns Pointer to @p len_i bytes of memory */
+		char * allocateSlow_(const size_t len_i);
+
+		public:
+		/** Constructor.
+		 * @param chunkSize_i Size of every regular chunk in bytes. Strings larger than a
+		 * quarter of it get a chunk of their own. */
+		explicit StringArena(const size_t chunkSize_i = 64 * 1024);
+
+		/// Not copyable, stored strings are referenced by their address
+		StringArena(const StringArena &) = delete;
+		StringArena & operator=(const StringArena &) = delete;
+
+		/// Moving keeps the chunks and thus all stored strings valid
+		StringArena(StringArena && obj_io) noexcept;
+		StringArena & operator=(StringArena && obj_io) noexcept;
+
+		/// Destructor
+		~StringArena() = default;
+
+		/** Allocate uninitialized memory from the arena.
+		 * @param len_i Number of bytes
+		 * @returns Pointer to @p len_i bytes, valid until clear() or destruction */
+		inline char * allocate(const size_t len_i)
+		{
+			if (len_i > left_) return allocateSlow_(len_i);
+			char * p = cur_;
+			cur_ += len_i;
+			left_ -= len_i;
+			used_ += len_i;
+			return p;
+		}
+
+		/** Copy a string into the arena.
+		 * @param str_i String to copy
+		 * @returns View of the copy, valid until clear() or destruction */
+		inline std::string_view store(std::string_view str_i)
+		{
+			if (str_i.empty()) return std::string_view();
+			char * p = allocate(str_i.size());
+			memcpy(p, str_i.data(), str_i.size());
+			return std::string_view(p, str_i.size());
+		}
+
+		/// Free all chunks, invalidating all stored strings
+		void clear();
+
+		/// @returns Total number of bytes allocated for chunks
+		inline size_t capacity() const { return capacity_; }
+
+		/// @returns Number of chunks
+		inline size_t chunks() const { return chunks_.size(); }
+
+		/// @returns Number of bytes handed out by allocate() and store()
+		inline size_t used() const { return used_; }
+	};
+
+} // Fs2a namespace
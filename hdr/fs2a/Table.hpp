@@ -32,14 +32,59 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <new>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
+#include <fs2a/MemoryTally.hpp>
+#include <fs2a/TableRanges.hpp>
+
+#ifndef FS2A_COLUMN_INDEX_TYPE
+/** Unsigned integer type for column indices and counts of tables. Defaults to
+ * uint16_t, use uint32_t for tables of more than 65534 columns. It changes the
+ * library interface, so set it for the library and everything using it alike,
+ * e.g. through the FS2A_COLUMN_INDEX_TYPE CMake cache variable. */
+#define FS2A_COLUMN_INDEX_TYPE uint16_t
+#endif
 
 namespace Fs2a {
 
+	/// Type of column indices and counts, see FS2A_COLUMN_INDEX_TYPE
+	typedef FS2A_COLUMN_INDEX_TYPE colidx_t;
+
+	static_assert(std::numeric_limits<colidx_t>::is_integer && !std::numeric_limits<colidx_t>::is_signed,
+		"FS2A_COLUMN_INDEX_TYPE should be an unsigned integer type");
+
+	/// Maximum number of columns of a table, so a column count always fits
+	constexpr colidx_t maxColumns = std::numeric_limits<colidx_t>::max() - 1;
+
+	/** @{ Heap memory owned by a cell, on top of the cell itself.
+	 * @param cell_i Cell to inspect
+	 * @returns Bytes, 0 for strings that fit in the string object itself */
+	template <typename T>
+	inline size_t cellHeapBytes(const T &) { return 0; }
+
+	inline size_t cellHeapBytes(const std::string & cell_i)
+	{
+		static const size_t local = std::string().capacity();
+		return cell_i.capacity() > local ? cell_i.capacity() + 1 : 0;
+	}
+	/** @} */
+
+	/** @{ Release unused memory of a cell.
+	 * @param cell_io Cell to shrink */
+	template <typename T>
+	inline void compactCell(T &) {}
+
+	inline void compactCell(std::string & cell_io) { cell_io.shrink_to_fit(); }
+	/** @} */
+
 	/** Class that models a two-dimensional array, similar to a database
 	 * table.
 	 * The number of columns can't be altered when set, but the number of rows can change throughout the lifetime of the object.
@@ -50,18 +95,89 @@ namespace Fs2a {
 	{
 		protected:
 		/** Number of columns in this table. 0 if not yet specified. */
-		uint16_t cols_;
+		colidx_t cols_;
 
 		/** Data vector containing all cells, grouped by row.
 		 * This means that data_[0] = the cell in row 0, column 0,
 		 * data_[1] = row 0, column 1, data_[2] = row 0, column 2, etc. */
 		std::vector<T> data_;
 
+		/// Share of this table in the MemoryTally
+		MemoryTally::Account account_;
+
+		/// Capacity of data_ when the account was last updated
+		size_t accounted_;
+
+		/// Heap bytes found by the last updateAccount(), see measureBytes_()
+		size_t measured_;
+
+		/** Heap bytes owned by this table besides the cells and their heap memory, that are
+		 * cheap to determine. Kept up to date in the MemoryTally.
+		 * @returns Bytes */
+		virtual size_t ownedBytes_() const { return 0; }
+
+		/** Heap bytes owned by this table besides the cells and their heap memory, that
+		 * take a pass over the table to determine. Only measured by memoryUsage() and updateAccount().
+		 * @returns Bytes */
+		virtual size_t measureBytes_() const { return 0; }
+
+		/** Heap bytes owned by the cells and measureBytes_(), taking a pass over all cells.
+		 * @returns Bytes */
+		size_t measureHeap_() const
+		{
+			size_t heap = measureBytes_();
+			for (const T & v : data_) heap += cellHeapBytes(v);
+			return heap;
+		}
+
+		/** Update the account of this table in the MemoryTally. */
+		void updateAccount_()
+		{
+			accounted_ = data_.capacity();
+			account_.set(static_cast<int64_t>(accounted_ * sizeof(T) + ownedBytes_() + measured_));
+		}
+
 		public:
 		/** Table constructor */
-		Table() : cols_(0)
+		Table() : cols_(0), accounted_(0), measured_(0)
 		{}
 
+		/// @{ Copying and moving, made explicit because of the virtual destructor and the account
+		Table(const Table & obj_i)
+		: cols_(obj_i.cols_), data_(obj_i.data_), measured_(obj_i.measured_)
+		{
+			updateAccount_();
+		}
+
+		Table(Table && obj_io) noexcept
+		: cols_(obj_io.cols_), data_(std::move(obj_io.data_)), account_(std::move(obj_io.account_)),
+			accounted_(std::exchange(obj_io.accounted_, 0)), measured_(std::exchange(obj_io.measured_, 0))
+		{}
+
+		Table & operator=(const Table & obj_i)
+		{
+			if (this != &obj_i) {
+				cols_ = obj_i.cols_;
+				data_ = obj_i.data_;
+				measured_ = obj_i.measured_;
+				updateAccount_();
+			}
+			return *this;
+		}
+
+		Table & operator=(Table && obj_io) noexcept
+		{
+			if (this != &obj_io) {
+				cols_ = obj_io.cols_;
+				data_ = std::move(obj_io.data_);
+				account_ = std::move(obj_io.account_);
+				accounted_ = std::exchange(obj_io.accounted_, 0);
+				measured_ = std::exchange(obj_io.measured_, 0);
+			}
+			return *this;
+		}
+		/// @}
+
 		/** Table destructor */
 		virtual ~Table()
 		{
@@ -70,14 +186,14 @@ namespace Fs2a {
 
 		/** Get the number of columns in this table.
 		 * @returns number of columns, 0 if not yet specified. */
-		virtual inline uint16_t columns() const { return cols_; }
+		virtual inline colidx_t columns() const { return cols_; }
 
 		/** Set the number of columns in this table.
 		 * Can only be specified once and should be greater than zero.
 		 * @param columns_i Number of columns to allocate (>0)
 		 * @throws std::invalid_argument when columns_i == 0
 		 * @throws std::logic_error when number of columns was already set. */
-		virtual void columns(const uint16_t columns_i)
+		virtual void columns(const colidx_t columns_i)
 		{
 			using namespace std::string_literals;
 
@@ -98,7 +214,7 @@ namespace Fs2a {
 		 * @returns Reference to field
 		 * @throws std::out_of_range if requested column is outside of
 		 * column range. */
-		virtual T & cell(const uint16_t column_i, const uint32_t row_i)
+		virtual T & cell(const colidx_t column_i, const uint32_t row_i)
 		{
 			using namespace std::string_literals;
 
@@ -111,7 +227,7 @@ namespace Fs2a {
 			}
 			if (row_i >= rows()) rows(row_i+1);
 
-			return data_.at(row_i * cols_ + column_i);
+			return data_.at(static_cast<size_t>(row_i) * cols_ + column_i);
 		}
 
 		/** Get the number of rows in this table.
@@ -131,7 +247,245 @@ namespace Fs2a {
 			if (cols_ == 0) {
 				throw std::logic_error("Please set the number of columns first");
 			}
-			data_.resize(cols_ * rows_i);
+			data_.resize(static_cast<size_t>(cols_) * rows_i);
+			if (data_.capacity() != accounted_) updateAccount_();
+		}
+
+		/** Reserve storage for a number of rows, so adding rows up to that
+		 * number doesn't reallocate.
+		 * @param rows_i Total number of rows to reserve room for
+		 * @throws std::logic_error when number of columns hasn't been set
+		 * yet. */
+		void reserve(const uint32_t rows_i)
+		{
+			if (cols_ == 0) {
+				throw std::logic_error("Please set the number of columns first");
+			}
+			data_.reserve(static_cast<size_t>(cols_) * rows_i);
+			if (data_.capacity() != accounted_) updateAccount_();
+		}
+
+		/** Append a full row by copying its cells.
+		 * @param row_i Cells of the new row, one for every column
+		 * @returns Index of the new row
+		 * @throws std::logic_error when number of columns hasn't been set
+		 * yet.
+		 * @throws std::invalid_argument when the number of cells doesn't
+		 * match the number of columns. */
+		uint32_t appendRow(std::span<const T> row_i)
+		{
+			appendCheck_(row_i.size());
+			const size_t old = data_.size();
+			// The row may be one of our own, which moves along when growing
+			const std::less<const T *> before;
+			const bool own = !before(row_i.data(), data_.data()) && before(row_i.data(), data_.data() + old);
+			const size_t offset = own ? static_cast<size_t>(row_i.data() - data_.data()) : 0;
+			grow_();
+			const T * src = own ? data_.data() + offset : row_i.data();
+			try {
+				for (colidx_t c = 0; c < cols_; c++) data_.push_back(src[c]);
+			} catch (...) {
+				data_.erase(data_.begin() + old, data_.end());
+				if (data_.capacity() != accounted_) updateAccount_();
+				throw;
+			}
+			if (data_.capacity() != accounted_) updateAccount_();
+			return static_cast<uint32_t>(data_.size() / cols_ - 1);
+		}
+
+		/** Append a full row by constructing its cells in place.
+		 * @param args_i One constructor argument for every column
+		 * @returns Index of the new row
+		 * @throws std::logic_error when number of columns hasn't been set
+		 * yet.
+		 * @throws std::invalid_argument when the number of arguments doesn't
+		 * match the number of columns.
+		 * Anything thrown by a cell constructor is passed on, after removing
+		 * the cells of the new row that were already constructed. */
+		template <typename... Args>
+		uint32_t emplaceRow(Args &&... args_i)
+		{
+			appendCheck_(sizeof...(Args));
+			const size_t old = data_.size();
+			if (data_.capacity() < old + cols_) {
+				// Arguments may refer to our own cells, so construct them before growing
+				std::vector<T> row;
+				row.reserve(cols_);
+				(row.emplace_back(std::forward<Args>(args_i)), ...);
+				grow_();
+				try {
+					for (T & cell : row) data_.push_back(std::move(cell));
+				} catch (...) {
+					data_.erase(data_.begin() + old, data_.end());
+					if (data_.capacity() != accounted_) updateAccount_();
+					throw;
+				}
+				updateAccount_();
+				return static_cast<uint32_t>(data_.size() / cols_ - 1);
+			}
+			try {
+				(data_.emplace_back(std::forward<Args>(args_i)), ...);
+			} catch (...) {
+				data_.erase(data_.begin() + old, data_.end());
+				if (data_.capacity() != accounted_) updateAccount_();
+				throw;
+			}
+			if (data_.capacity() != accounted_) updateAccount_();
+			return static_cast<uint32_t>(data_.size() / cols_ - 1);
+		}
+
+		/** @{ Unchecked access to a specific field, for tight loops.
+		 * The field must exist, so the column must be less than columns()
+		 * and the row less than rows(). Use cell() for checked access that
+		 * also adds rows.
+		 * @param column_i Column of field, zero based
+		 * @param row_i Row of field, zero based
+		 * @returns Reference to field */
+		inline T & operator()(const colidx_t column_i, const uint32_t row_i)
+		{
+			return data_[static_cast<size_t>(row_i) * cols_ + column_i];
+		}
+
+		inline const T & operator()(const colidx_t column_i, const uint32_t row_i) const
+		{
+			return data_[static_cast<size_t>(row_i) * cols_ + column_i];
+		}
+		/** @} */
+
+		/** @{ Access all fields of a row at once.
+		 * @param row_i Row to access, zero based
+		 * @returns Span over the fields of the row, valid until the number
+		 * of rows changes
+		 * @throws std::out_of_range if the row doesn't exist. */
+		std::span<T> row(const uint32_t row_i)
+		{
+			rowCheck_(row_i);
+			return std::span<T>(data_.data() + static_cast<size_t>(row_i) * cols_, cols_);
+		}
+
+		std::span<const T> row(const uint32_t row_i) const
+		{
+			rowCheck_(row_i);
+			return std::span<const T>(data_.data() + static_cast<size_t>(row_i) * cols_, cols_);
+		}
+		/** @} */
+
+		/** @{ Range over the cells of a column, with random access iterators.
+		 * Scanning it skips a row at a time without any bounds checks, and
+		 * std::ranges algorithms and the parallel algorithms accept it.
+		 * @param column_i Column to access, zero based
+		 * @param firstRow_i First row to include, e.g. 1 to skip a header
+		 * @returns Range over the cells, valid until the number of rows changes, empty
+		 * when the first row is the number of rows
+		 * @throws std::out_of_range if the column or first row doesn't exist. */
+		StridedRange<T> columnRange(const colidx_t column_i, const uint32_t firstRow_i = 0)
+		{
+			rangeCheck_(column_i, firstRow_i);
+			if (firstRow_i == rows()) return StridedRange<T>();
+			return StridedRange<T>(data_.data() + static_cast<size_t>(firstRow_i) * cols_ + column_i,
+				rows() - firstRow_i, cols_);
+		}
+
+		StridedRange<const T> columnRange(const colidx_t column_i, const uint32_t firstRow_i = 0) const
+		{
+			rangeCheck_(column_i, firstRow_i);
+			if (firstRow_i == rows()) return StridedRange<const T>();
+			return StridedRange<const T>(data_.data() + static_cast<size_t>(firstRow_i) * cols_ + column_i,
+				rows() - firstRow_i, cols_);
+		}
+		/** @} */
+
+		/** @{ Range over all rows, yielding a span over the cells of every row.
+		 * @returns Range over the rows, valid until the number of rows changes */
+		RowRange<T> rowRange() { return RowRange<T>(data_.data(), rows(), cols_ ? cols_ : 1); }
+		RowRange<const T> rowRange() const { return RowRange<const T>(data_.data(), rows(), cols_ ? cols_ : 1); }
+		/** @} */
+
+		/** Determine the memory used by this table: the capacity of the cell storage, heap
+		 * memory owned by the cells, like long strings, and memory of derived tables, like
+		 * arenas, headers and indexes. Takes a pass over all cells. Doesn't change anything,
+		 * so readers of a shared table can call it, see updateAccount() to also update the
+		 * MemoryTally.
+		 * @returns Bytes in use, not counting the table object itself */
+		size_t memoryUsage() const
+		{
+			return data_.capacity() * sizeof(T) + ownedBytes_() + measureHeap_();
+		}
+
+		/** Determine the memory used by this table like memoryUsage(), and update the account
+		 * of this table in the MemoryTally with it.
+		 * @returns Bytes in use, not counting the table object itself */
+		size_t updateAccount()
+		{
+			measured_ = measureHeap_();
+			updateAccount_();
+			return data_.capacity() * sizeof(T) + ownedBytes_() + measured_;
+		}
+
+		/** Release unused memory, like capacity left after removing rows.
+		 * Derived tables can free more, like indexes or duplicate strings.
+		 * Updates the account of this table in the MemoryTally.
+		 * @returns memoryUsage() after compacting */
+		virtual size_t compact()
+		{
+			for (T & v : data_) compactCell(v);
+			data_.shrink_to_fit();
+			return updateAccount();
+		}
+
+		protected:
+		/** Check whether a column range can be made.
+		 * @param column_i Column of the range
+		 * @param firstRow_i First row of the range, may be one past the last row */
+		void rangeCheck_(const colidx_t column_i, const uint32_t firstRow_i) const
+		{
+			using namespace std::string_literals;
+
+			if (column_i >= cols_) {
+				throw std::out_of_range("Requested column "s + std::to_string(column_i) +
+					" should be less than the number of columns, which is "s + std::to_string(cols_));
+			}
+			if (firstRow_i > rows()) {
+				throw std::out_of_range("Requested first row "s + std::to_string(firstRow_i) +
+					" is beyond the number of rows, which is "s + std::to_string(rows()));
+			}
+		}
+
+		/** Make room for one more row, growing geometrically like the vector itself. */
+		void grow_()
+		{
+			const size_t need = data_.size() + cols_;
+			if (data_.capacity() < need) data_.reserve(std::max(need, 2 * data_.capacity()));
+		}
+
+		/** Check whether a row with a number of cells can be appended.
+		 * @param cells_i Number of cells in the new row */
+		void appendCheck_(const size_t cells_i) const
+		{
+			using namespace std::string_literals;
+
+			if (cols_ == 0) {
+				throw std::logic_error("Please set the number of columns first");
+			}
+			if (cells_i != cols_) {
+				throw std::invalid_argument("Row to append has "s + std::to_string(cells_i) +
+					" cells, but the number of columns is "s + std::to_string(cols_));
+			}
+			if (data_.size() / cols_ >= UINT32_MAX) {
+				throw std::out_of_range("Table already has the maximum number of rows");
+			}
+		}
+
+		/** Check whether a row exists.
+		 * @param row_i Row to check */
+		void rowCheck_(const uint32_t row_i) const
+		{
+			using namespace std::string_literals;
+
+			if (row_i >= rows()) {
+				throw std::out_of_range("Requested row "s + std::to_string(row_i) +
+					" should be less than the number of rows, which is "s + std::to_string(rows()));
+			}
 		}
 	};
 
@@ -0,0 +1,181 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fs2a/ColumnTable.hpp>
+#include <fs2a/HeaderedTable.hpp>
+
+namespace Fs2a {
+
+	/// Kinds of joins for hashJoin()
+	enum join_e : uint8_t {
+		innerJoin, ///< Rows with a match on both sides
+		leftJoin,  ///< All rows of the left side, with the matches of the right side if any
+		antiJoin   ///< Rows of the left side without a match on the right side
+	};
+
+	/** Join two tables on the values of one or more key columns.
+	 * The right table is put in a hash table, which the rows of the left table are matched
+	 * against in parallel. The result has the columns of the left table, followed by the
+	 * non-key columns of the right table for inner and left joins. Right column names that
+	 * are also used on the left get a suffix like in HeaderedTable. Rows are in the order of
+	 * the left table, and for every left row its matches are in the order of the right table.
+	 * @param left_i Left table
+	 * @param right_i Right table, preferably the smaller one
+	 * @param keyCols_i Names of the key columns, which both tables should have
+	 * @param kind_i Kind of join
+	 * @param threads_i Number of threads to use, 0 for all hardware threads. Small tables
+	 * use less.
+	 * @returns Joined table, with a header row
+	 * @throws std::invalid_argument when no key columns are given or a table lacks one. */
+	HeaderedTable hashJoin(HeaderedTable & left_i, HeaderedTable & right_i, const std::vector<std::string> & keyCols_i,
+		const join_e kind_i = innerJoin, const unsigned threads_i = 0);
+
+	/** Compare two versions of a table by key, like yesterday's and today's export.
+	 * The old table is indexed on its key columns with a hash of the content of every row.
+	 * The rows of the new table are then matched against it in parallel partitions, without
+	 * indexing the new table, so memory is bounded by the old side and the changes. Cells
+	 * are only compared for rows whose content hash differs, so unchanged rows cost a hash.
+	 * Both tables need the same column names, in any order.
+	 * @param old_i Old version of the table
+	 * @param new_i New version of the table
+	 * @param keyCols_i Names of the key columns, which should identify a row in both tables
+	 * @param threads_i Number of threads to use, 0 for all hardware threads. Small tables
+	 * use less.
+	 * @returns Change set with a header. Its first column, "change", holds "inserted",
+	 * "changed" or "deleted". The second, "changed", holds the comma separated names of the
+	 * changed columns of changed rows. The columns of the new table follow, holding the new
+	 * values, or the old ones for deleted rows. Inserted and changed rows come first in the
+	 * order of the new table, then the deleted rows in the order of the old table.
+	 * @throws std::invalid_argument when no key columns are given, the columns of the tables
+	 * differ or a key is not unique. */
+	HeaderedTable diff(HeaderedTable & old_i, HeaderedTable & new_i, const std::vector<std::string> & keyCols_i,
+		const unsigned threads_i = 0);
+
+	/** Grouping of the rows of a table by the values of key columns, to aggregate them.
+	 * Create one with groupBy() and call agg() on it. */
+	class GroupBy
+	{
+		public:
+		/// Aggregate functions
+		enum func_e : uint8_t {
+			count, ///< Number of rows, or of non-empty values when a column is given
+			sum,   ///< Sum of the numeric values
+			min,   ///< Lowest numeric value
+			max    ///< Highest numeric value
+		};
+
+		/// Aggregate to calculate for every group
+		typedef struct aggregate_s {
+			func_e func;        ///< Aggregate function
+			std::string column; ///< Column to aggregate, can be empty for count
+			std::string name;   ///< Name of the result column, empty for e.g. "sum_amount"
+		} aggregate_t;
+
+		protected:
+		/// Table to group
+		HeaderedTable & table_;
+
+		/// Key column indices
+		std::vector<colidx_t> keys_;
+
+		public:
+		/** Constructor.
+		 * @param table_i Table to group, should outlive this object
+		 * @param keyCols_i Names of the key columns
+		 * @throws std::invalid_argument when no key columns are given or one doesn't exist. */
+		GroupBy(HeaderedTable & table_i, const std::vector<std::string> & keyCols_i);
+
+		/** Calculate aggregates for every group.
+		 * Values that are not numbers are ignored by sum, min and max, and a group without
+		 * any numbers gets an empty value. Sums of integers stay exact.
+		 * @param aggs_i Aggregates to calculate
+		 * @param threads_i Number of threads to use, 0 for all hardware threads
+		 * @returns Table with a header, the key columns and a column per aggregate. Groups are
+		 * in order of their first row.
+		 * @throws std::invalid_argument when a column doesn't exist or is missing. */
+		HeaderedTable agg(const std::vector<aggregate_t> & aggs_i, const unsigned threads_i = 0) const;
+	};
+
+	/** Group the rows of a table, to aggregate them with GroupBy::agg().
+	 * @param table_i Table to group, should outlive the result
+	 * @param keyCols_i Names of the key columns
+	 * @returns Grouping
+	 * @throws std::invalid_argument when no key columns are given or one doesn't exist. */
+	inline GroupBy groupBy(HeaderedTable & table_i, const std::vector<std::string> & keyCols_i)
+	{
+		return GroupBy(table_i, keyCols_i);
+	}
+
+	/** Grouping of the rows of a column table, to aggregate them like GroupBy.
+	 * Text key columns are grouped on their dictionary codes, so no key strings are hashed or
+	 * compared. Create one with groupBy() and call agg() on it. */
+	class ColumnGroupBy
+	{
+		protected:
+		/// Table to group
+		const ColumnTable & table_;
+
+		/// Key column indices
+		std::vector<colidx_t> keys_;
+
+		public:
+		/** Constructor.
+		 * @param table_i Table to group, should outlive this object
+		 * @param keyCols_i Names of the key columns
+		 * @throws std::invalid_argument when no key columns are given or one doesn't exist. */
+		ColumnGroupBy(const ColumnTable & table_i, const std::vector<std::string> & keyCols_i);
+
+		/** Calculate aggregates for every group, like GroupBy::agg().
+		 * Missing key values form a group of their own. Sum, min and max use the values of
+		 * integer, decimal and boolean columns, and the numbers in text columns.
+		 * @param aggs_i Aggregates to calculate
+		 * @param threads_i Number of threads to use, 0 for all hardware threads
+		 * @returns Table with a header, the key columns and a column per aggregate. Groups are
+		 * in order of their first row.
+		 * @throws std::invalid_argument when a column doesn't exist or is missing. */
+		HeaderedTable agg(const std::vector<GroupBy::aggregate_t> & aggs_i, const unsigned threads_i = 0) const;
+	};
+
+	/** Group the rows of a column table, to aggregate them with ColumnGroupBy::agg().
+	 * @param table_i Table to group, should outlive the result
+	 * @param keyCols_i Names of the key columns
+	 * @returns Grouping
+	 * @throws std::invalid_argument when no key columns are given or one doesn't exist. */
+	inline ColumnGroupBy groupBy(const ColumnTable & table_i, const std::vector<std::string> & keyCols_i)
+	{
+		return ColumnGroupBy(table_i, keyCols_i);
+	}
+
+} // Fs2a namespace
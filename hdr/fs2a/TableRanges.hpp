@@ -0,0 +1,239 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace Fs2a {
+
+	/** Range over every n-th element of an array, like a column of a table that is stored
+	 * row by row. Its iterators are random access, so it works with std::ranges algorithms,
+	 * std::sort and the parallel algorithms. It doesn't own the elements, so it is valid as
+	 * long as the storage it was made from doesn't change size.
+	 * @tparam T Element type, const for a read-only range */
+	template <typename T>
+	class StridedRange : public std::ranges::view_interface<StridedRange<T>>
+	{
+		public:
+		/// Random access iterator, stepping over the stride at a time
+		class iterator
+		{
+			protected:
+			/// First element of the range
+			T * first_ = nullptr;
+
+			/// Index of the current element within the range
+			std::ptrdiff_t i_ = 0;
+
+			/// Distance between elements
+			std::ptrdiff_t stride_ = 1;
+
+			public:
+			typedef std::random_access_iterator_tag iterator_concept;
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef std::remove_cv_t<T> value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef T * pointer;
+			typedef T & reference;
+
+			/// Constructor, for a singular iterator
+			iterator() = default;
+
+			/** Constructor. The element pointer is only formed on access, because the
+			 * end of a range that doesn't start at the first cell of a row lies beyond
+			 * the end of the storage.
+			 * @param first_i First element of the range
+			 * @param i_i Index of the element to start at
+			 * @param stride_i Distance between elements */
+			iterator(T * first_i, const std::ptrdiff_t i_i, const std::ptrdiff_t stride_i)
+			: first_(first_i), i_(i_i), stride_(stride_i)
+			{}
+
+			/// @{ Element access
+			inline T & operator*() const { return first_[i_ * stride_]; }
+			inline T * operator->() const { return first_ + i_ * stride_; }
+			inline T & operator[](const difference_type n_i) const { return first_[(i_ + n_i) * stride_]; }
+			/// @}
+
+			/// @{ Stepping
+			inline iterator & operator++() { ++i_; return *this; }
+			inline iterator operator++(int) { iterator i = *this; ++i_; return i; }
+			inline iterator & operator--() { --i_; return *this; }
+			inline iterator operator--(int) { iterator i = *this; --i_; return i; }
+			inline iterator & operator+=(const difference_type n_i) { i_ += n_i; return *this; }
+			inline iterator & operator-=(const difference_type n_i) { i_ -= n_i; return *this; }
+			inline iterator operator+(const difference_type n_i) const { return iterator(first_, i_ + n_i, stride_); }
+			inline iterator operator-(const difference_type n_i) const { return iterator(first_, i_ - n_i, stride_); }
+			friend inline iterator operator+(const difference_type n_i, const iterator & i_i) { return i_i + n_i; }
+			inline difference_type operator-(const iterator & o_i) const { return i_ - o_i.i_; }
+			/// @}
+
+			/// @{ Comparison, of iterators into the same range
+			inline bool operator==(const iterator & o_i) const { return i_ == o_i.i_; }
+			inline std::strong_ordering operator<=>(const iterator & o_i) const { return i_ <=> o_i.i_; }
+			/// @}
+		};
+
+		protected:
+		/// First element
+		T * first_ = nullptr;
+
+		/// Number of elements
+		size_t size_ = 0;
+
+		/// Distance between elements
+		std::ptrdiff_t stride_ = 1;
+
+		public:
+		/// Constructor, for an empty range
+		StridedRange() = default;
+
+		/** Constructor.
+		 * @param first_i First element
+		 * @param size_i Number of elements
+		 * @param stride_i Distance between elements, at least 1 */
+		StridedRange(T * first_i, const size_t size_i, const size_t stride_i)
+		: first_(first_i), size_(size_i), stride_(static_cast<std::ptrdiff_t>(stride_i))
+		{}
+
+		/// @{ Iterators
+		inline iterator begin() const { return iterator(first_, 0, stride_); }
+		inline iterator end() const { return iterator(first_, static_cast<std::ptrdiff_t>(size_), stride_); }
+		/// @}
+
+		/// Number of elements
+		inline size_t size() const { return size_; }
+
+		/// Distance between elements
+		inline size_t stride() const { return static_cast<size_t>(stride_); }
+	};
+
+	/** Range over the rows of a table that is stored row by row, yielding a span over the
+	 * cells of every row. Its iterators are random access, but yield spans by value, so
+	 * algorithms that need references to elements can't rearrange rows through it. It
+	 * doesn't own the cells, so it is valid as long as the table doesn't change size.
+	 * @tparam T Cell type, const for a read-only range */
+	template <typename T>
+	class RowRange : public std::ranges::view_interface<RowRange<T>>
+	{
+		public:
+		/// Random access iterator, yielding a span per row
+		class iterator
+		{
+			protected:
+			/// First cell of the current row
+			T * p_ = nullptr;
+
+			/// Number of cells per row
+			std::ptrdiff_t cols_ = 1;
+
+			public:
+			typedef std::random_access_iterator_tag iterator_concept;
+			typedef std::input_iterator_tag iterator_category;
+			typedef std::span<T> value_type;
+			typedef std::ptrdiff_t difference_type;
+
+			/// Constructor, for a singular iterator
+			iterator() = default;
+
+			/** Constructor.
+			 * @param p_i First cell of the row to start at
+			 * @param cols_i Number of cells per row */
+			iterator(T * p_i, const std::ptrdiff_t cols_i) : p_(p_i), cols_(cols_i) {}
+
+			/// @{ Row access
+			inline std::span<T> operator*() const { return std::span<T>(p_, static_cast<size_t>(cols_)); }
+			inline std::span<T> operator[](const difference_type n_i) const { return *(*this + n_i); }
+			/// @}
+
+			/// @{ Stepping
+			inline iterator & operator++() { p_ += cols_; return *this; }
+			inline iterator operator++(int) { iterator i = *this; p_ += cols_; return i; }
+			inline iterator & operator--() { p_ -= cols_; return *this; }
+			inline iterator operator--(int) { iterator i = *this; p_ -= cols_; return i; }
+			inline iterator & operator+=(const difference_type n_i) { p_ += n_i * cols_; return *this; }
+			inline iterator & operator-=(const difference_type n_i) { p_ -= n_i * cols_; return *this; }
+			inline iterator operator+(const difference_type n_i) const { return iterator(p_ + n_i * cols_, cols_); }
+			inline iterator operator-(const difference_type n_i) const { return iterator(p_ - n_i * cols_, cols_); }
+			friend inline iterator operator+(const difference_type n_i, const iterator & i_i) { return i_i + n_i; }
+			inline difference_type operator-(const iterator & o_i) const { return (p_ - o_i.p_) / cols_; }
+			/// @}
+
+			/// @{ Comparison, of iterators into the same range
+			inline bool operator==(const iterator & o_i) const { return p_ == o_i.p_; }
+			inline std::strong_ordering operator<=>(const iterator & o_i) const { return p_ <=> o_i.p_; }
+			/// @}
+		};
+
+		protected:
+		/// First cell of the first row
+		T * first_ = nullptr;
+
+		/// Number of rows
+		size_t rows_ = 0;
+
+		/// Number of cells per row
+		std::ptrdiff_t cols_ = 1;
+
+		public:
+		/// Constructor, for an empty range
+		RowRange() = default;
+
+		/** Constructor.
+		 * @param first_i First cell of the first row
+		 * @param rows_i Number of rows
+		 * @param cols_i Number of cells per row, at least 1 */
+		RowRange(T * first_i, const size_t rows_i, const size_t cols_i)
+		: first_(first_i), rows_(rows_i), cols_(static_cast<std::ptrdiff_t>(cols_i))
+		{}
+
+		/// @{ Iterators
+		inline iterator begin() const { return iterator(first_, cols_); }
+		inline iterator end() const { return iterator(first_ + static_cast<std::ptrdiff_t>(rows_) * cols_, cols_); }
+		/// @}
+
+		/// Number of rows
+		inline size_t size() const { return rows_; }
+	};
+
+} // Fs2a namespace
+
+/// @{ The ranges don't own their elements, so their iterators outlive them
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<Fs2a::StridedRange<T>> = true;
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<Fs2a::RowRange<T>> = true;
+/// @}
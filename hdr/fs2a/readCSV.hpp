@@ -30,8 +30,14 @@
 
 #pragma once
 
+#include <filesystem>
 #include <istream>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <fs2a/ArenaTable.hpp>
+#include <fs2a/ColumnTable.hpp>
 #include <fs2a/Table.hpp>
 
 namespace Fs2a {
@@ -42,4 +48,104 @@ namespace Fs2a {
 	 * @returns Table object with all data. */
 	Table<std::string> readCSV(std::istream & stream_i, const char separator_i = ';');
 
+	/** Read and parse CSV data from a given stream into an arena backed table.
+	 * Parsing is the same as for readCSV() into a Table<std::string>, but every field is
+	 * stored in the arena of the table instead of in its own heap allocation.
+	 * @param stream_i Input stream to read CSV from.
+	 * @param table_o Empty table to read into, can be a HeaderedArenaTable.
+	 * @param separator_i Separator character to use, default is
+	 * semicolon ';' */
+	void readCSV(std::istream & stream_i, ArenaTable & table_o, const char separator_i = ';');
+
+	/** Read and parse CSV data from a file by mapping it into memory.
+	 * Parsing is the same as for readCSV() from a stream, but fields are not copied. They
+	 * view straight into the mapping, except quoted fields with escaped quotes, which are
+	 * stored in the arena of the table. The table retains the mapping, also when moved.
+	 * Large files are split into parts at line endings that are parsed in parallel. A part
+	 * that turns out to start inside a quoted field is parsed again from the right place,
+	 * so the result and the line numbers in errors are the same as when parsing serially.
+	 * @param path_i Path of the CSV file
+	 * @param table_o Empty table to read into, can be a HeaderedArenaTable.
+	 * @param separator_i Separator character to use, default is
+	 * semicolon ';'
+	 * @param threads_i Number of threads to use, 0 for all hardware threads. Every thread
+	 * gets at least a few MiB to parse.
+	 * @throws std::runtime_error when the file can't be mapped, or on invalid CSV. */
+	void readCSV(const std::filesystem::path & path_i, ArenaTable & table_o, const char separator_i = ';',
+		const unsigned threads_i = 0);
+
+	/** Read and parse CSV data from a file by mapping it into memory.
+	 * @see readCSV(const std::filesystem::path &, ArenaTable &, const char, const unsigned)
+	 * @param path_i Path of the CSV file
+	 * @param separator_i Separator character to use, default is
+	 * semicolon ';'
+	 * @param threads_i Number of threads to use, 0 for all hardware threads
+	 * @returns Table with all data, viewing into the mapped file. */
+	ArenaTable readCSV(const std::filesystem::path & path_i, const char separator_i = ';',
+		const unsigned threads_i = 0);
+
+	/** Read and parse CSV data from a given stream into a column table with text columns.
+	 * Parsing is the same as for readCSV() into a Table<std::string>, the first row names the
+	 * columns, made unique like in HeaderedTable. Every field is dictionary encoded as it is
+	 * read, so a column with few distinct values never holds a string per row. Empty fields
+	 * and fields missing at the end of a row are missing values.
+	 * @param stream_i Input stream to read CSV from.
+	 * @param table_o Empty table to read into
+	 * @param separator_i Separator character to use, default is
+	 * semicolon ';'
+	 * @throws std::invalid_argument when @p table_o already has columns. */
+	void readCSV(std::istream & stream_i, ColumnTable & table_o, const char separator_i = ';');
+
+	/** Reader of CSV data from a stream, one row at a time.
+	 * Parsing is the same as for readCSV() into a Table<std::string>, but no table is kept.
+	 * The stream is read in blocks and the fields of a row are reused for the next one, so
+	 * memory use depends on the longest row, not on the size of the input. Fields missing
+	 * at the end of a row are empty. */
+	class CsvReader
+	{
+		protected:
+		/// Parser state, defined with the parser
+		struct state_s;
+
+		/// Parser state
+		std::unique_ptr<state_s> state_;
+
+		public:
+		/** Constructor, reads nothing yet.
+		 * @param stream_i Input stream to read CSV from, should outlive the reader.
+		 * @param separator_i Separator character to use, default is
+		 * semicolon ';' */
+		explicit CsvReader(std::istream & stream_i, const char separator_i = ';');
+
+		/// @{ Movable, not copyable
+		CsvReader(CsvReader && obj_io) noexcept;
+		CsvReader & operator=(CsvReader && obj_io) noexcept;
+		CsvReader(const CsvReader &) = delete;
+		CsvReader & operator=(const CsvReader &) = delete;
+		/// @}
+
+		/// Destructor
+		~CsvReader();
+
+		/** Fields of the first row, read on first use.
+		 * @returns Views that stay valid for the lifetime of the reader.
+		 * @throws std::runtime_error on invalid CSV, again on every later call. */
+		std::span<const std::string_view> header();
+
+		/// @returns Number of columns, as determined by the header
+		colidx_t columns();
+
+		/** Read the next row after the header.
+		 * @returns False at the end of the stream, when there is no row.
+		 * @throws std::runtime_error on invalid CSV. */
+		bool next();
+
+		/** Fields of the row read by the last call to next().
+		 * @returns Views that stay valid until the next call to next(). */
+		std::span<const std::string_view> row() const;
+
+		/// @returns Number of rows read by next() so far
+		size_t rows() const;
+	};
+
 } // Fs2a namespace
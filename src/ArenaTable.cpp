@@ -0,0 +1,132 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <vector>
+#include <fs2a/ArenaTable.hpp>
+#include <fs2a/HeaderedTable.hpp>
+
+namespace Fs2a {
+
+	using namespace std::string_literals;
+	using std::string;
+
+	ArenaTable::ArenaTable(const ArenaTable & obj_i)
+	: Table<std::string_view>(obj_i)
+	{
+		for (auto & v : data_) v = store(v);
+	}
+
+	ArenaTable::ArenaTable(const Table<string> & obj_i)
+	{
+		if (obj_i.columns() == 0) return;
+		columns(obj_i.columns());
+		rows(obj_i.rows());
+		for (uint32_t r = 0; r < obj_i.rows(); r++) {
+			for (colidx_t c = 0; c < cols_; c++) (*this)(c, r) = store(obj_i(c, r));
+		}
+	}
+
+	ArenaTable & ArenaTable::operator=(const ArenaTable & obj_i)
+	{
+		if (this != &obj_i) {
+			ArenaTable copy(obj_i);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	size_t ArenaTable::compact()
+	{
+		// The old arena stays alive until all cells point into the new one
+		StringArena arena;
+		std::unordered_map<std::string_view, std::string_view> seen;
+		for (auto & v : data_) {
+			auto [it, fresh] = seen.try_emplace(v);
+			if (fresh) it->second = arena.store(v);
+			v = it->second;
+		}
+		arena_ = std::move(arena);
+		file_.reset();
+		return Table<std::string_view>::compact();
+	}
+
+	Table<string> ArenaTable::toTable() const
+	{
+		Table<string> t;
+
+		if (cols_ == 0) return t;
+		t.columns(cols_);
+		t.rows(rows());
+		for (uint32_t r = 0; r < rows(); r++) {
+			for (colidx_t c = 0; c < cols_; c++) t(c, r) = (*this)(c, r);
+		}
+		return t;
+	}
+
+	std::string_view & HeaderedArenaTable::cell(const string & colname_i, const uint32_t row_i)
+	{
+		if (cols_ == 0) throw std::logic_error("Please set the number of columns first");
+		if (rows() < 1) throw std::logic_error("No first row to read as header");
+		if (colname_i.empty()) throw std::invalid_argument("Given column name is empty");
+		if (hdrs_.empty()) readHeaders_();
+
+		// Headers Iterator
+		auto hi = hdrs_.find(colname_i);
+		if (hi == hdrs_.end()) throw std::invalid_argument("Unknown column header \""s + colname_i + "\"");
+		return ArenaTable::cell(hi->second, row_i);
+	}
+
+	size_t HeaderedArenaTable::measureBytes_() const
+	{
+		size_t bytes = hdrs_.bucket_count() * sizeof(void *) + hdrs_.size() * (2 * sizeof(void *) + sizeof(*hdrs_.begin()));
+		for (const auto & h : hdrs_) bytes += cellHeapBytes(h.first);
+		return bytes;
+	}
+
+	void HeaderedArenaTable::readHeaders_()
+	{
+		std::vector<string> names;
+		names.reserve(cols_);
+		for (colidx_t c = 0; c < cols_; c++) names.emplace_back(data_[c]);
+
+		HeaderedTable::uniqueHeaders(names);
+		hdrs_.clear();
+
+		for (colidx_t c = 0; c < cols_; c++) {
+			if (data_[c] != names[c]) data_[c] = store(names[c]);
+			if (names[c].empty()) {
+				hdrs_.clear();
+				throw std::runtime_error("Header at row 1, column "s + std::to_string(c+1) + " is empty");
+			}
+			hdrs_.insert(std::make_pair(names[c], c));
+		}
+	}
+
+} // Fs2a namespace
@@ -0,0 +1,286 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <fs2a/Base16.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FS2A_BASE16_X86
+#include <immintrin.h>
+#endif
+
+namespace Fs2a {
+
+	namespace {
+
+		/// Digits in lower and upper case
+		const char digits[2][17] = { "0123456789abcdef", "0123456789ABCDEF" };
+
+		/// Decode table, invalid digits have the upper nibble set
+		constexpr std::array<uint8_t, 256> decTbl = [] {
+			std::array<uint8_t, 256> t{};
+			for (auto & v : t) v = 0xFF;
+			for (uint8_t i = 0; i < 10; i++) t['0' + i] = i;
+			for (uint8_t i = 0; i < 6; i++) t['a' + i] = t['A' + i] = 10 + i;
+			return t;
+		}();
+
+		void encodeScalar(const uint8_t * in_i, const size_t len_i, char * out_o, const bool upper_i)
+		{
+			const char * d = digits[upper_i];
+
+			for (size_t i = 0; i < len_i; i++) {
+				out_o[2*i] = d[in_i[i] >> 4];
+				out_o[2*i+1] = d[in_i[i] & 0x0F];
+			}
+		}
+
+		size_t decodeScalar(const char * in_i, const size_t len_i, uint8_t * out_o)
+		{
+			const uint8_t * in = reinterpret_cast<const uint8_t *>(in_i);
+			size_t i = 0;
+
+			for (; i + 1 < len_i; i += 2) {
+				uint8_t h = decTbl[in[i]], l = decTbl[in[i+1]];
+				if ((h | l) & 0xF0) return i;
+				out_o[i/2] = static_cast<uint8_t>((h << 4) | l);
+			}
+			return i;
+		}
+
+#ifdef FS2A_BASE16_X86
+		__attribute__((target("ssse3")))
+		void encodeSsse3(const uint8_t * in_i, const size_t len_i, char * out_o, const bool upper_i)
+		{
+			const __m128i tbl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(digits[upper_i]));
+			const __m128i nib = _mm_set1_epi8(0x0F);
+			size_t i = 0;
+
+			for (; i + 16 <= len_i; i += 16) {
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_i + i));
+				__m128i hi = _mm_shuffle_epi8(tbl, _mm_and_si128(_mm_srli_epi16(v, 4), nib));
+				__m128i lo = _mm_shuffle_epi8(tbl, _mm_and_si128(v, nib));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out_o + 2*i), _mm_unpacklo_epi8(hi, lo));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out_o + 2*i + 16), _mm_unpackhi_epi8(hi, lo));
+			}
+			encodeScalar(in_i + i, len_i - i, out_o + 2*i, upper_i);
+		}
+
+		/** Convert 16 digits to their values.
+		 * @param c_i Digits
+		 * @param ok_o Set to 0xFF for every valid digit
+		 * @returns Values of the digits */
+		__attribute__((target("ssse3")))
+		inline __m128i valuesSsse3(const __m128i c_i, __m128i & ok_o)
+		{
+			// Unsigned x <= n is tested as min(x, n) == x
+			__m128i d = _mm_sub_epi8(c_i, _mm_set1_epi8('0'));
+			__m128i isd = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+			__m128i a = _mm_sub_epi8(_mm_or_si128(c_i, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+			__m128i isa = _mm_cmpeq_epi8(_mm_min_epu8(a, _mm_set1_epi8(5)), a);
+			ok_o = _mm_or_si128(isd, isa);
+			return _mm_or_si128(_mm_and_si128(isd, d), _mm_and_si128(isa, _mm_add_epi8(a, _mm_set1_epi8(10))));
+		}
+
+		__attribute__((target("ssse3")))
+		size_t decodeSsse3(const char * in_i, const size_t len_i, uint8_t * out_o)
+		{
+			// Multiply the high nibble by 16 and add the low one in a single step
+			const __m128i mul = _mm_set1_epi16(0x0110);
+			size_t i = 0;
+
+			for (; i + 32 <= len_i; i += 32) {
+				__m128i ok0, ok1;
+				__m128i v0 = valuesSsse3(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in_i + i)), ok0);
+				__m128i v1 = valuesSsse3(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in_i + i + 16)), ok1);
+				if (_mm_movemask_epi8(_mm_and_si128(ok0, ok1)) != 0xFFFF) break;
+				__m128i b = _mm_packus_epi16(_mm_maddubs_epi16(v0, mul), _mm_maddubs_epi16(v1, mul));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out_o + i/2), b);
+			}
+			return i + decodeScalar(in_i + i, len_i - i, out_o + i/2);
+		}
+
+		__attribute__((target("avx2")))
+		void encodeAvx2(const uint8_t * in_i, const size_t len_i, char * out_o, const bool upper_i)
+		{
+			const __m256i tbl = _mm256_broadcastsi128_si256(
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(digits[upper_i])));
+			const __m256i nib = _mm256_set1_epi8(0x0F);
+			size_t i = 0;
+
+			for (; i + 32 <= len_i; i += 32) {
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in_i + i));
+				__m256i hi = _mm256_shuffle_epi8(tbl, _mm256_and_si256(_mm256_srli_epi16(v, 4), nib));
+				__m256i lo = _mm256_shuffle_epi8(tbl, _mm256_and_si256(v, nib));
+				// Interleaving works per 128-bit lane, so put the lanes in order afterwards
+				__m256i a = _mm256_unpacklo_epi8(hi, lo), b = _mm256_unpackhi_epi8(hi, lo);
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(out_o + 2*i), _mm256_permute2x128_si256(a, b, 0x20));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(out_o + 2*i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+			}
+			// The tail runs legacy SSE code, avoid the transition penalty on dirty upper halves
+			_mm256_zeroupper();
+			encodeSsse3(in_i + i, len_i - i, out_o + 2*i, upper_i);
+		}
+
+		/// AVX2 version of valuesSsse3()
+		__attribute__((target("avx2")))
+		inline __m256i valuesAvx2(const __m256i c_i, __m256i & ok_o)
+		{
+			__m256i d = _mm256_sub_epi8(c_i, _mm256_set1_epi8('0'));
+			__m256i isd = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+			__m256i a = _mm256_sub_epi8(_mm256_or_si256(c_i, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+			__m256i isa = _mm256_cmpeq_epi8(_mm256_min_epu8(a, _mm256_set1_epi8(5)), a);
+			ok_o = _mm256_or_si256(isd, isa);
+			return _mm256_or_si256(_mm256_and_si256(isd, d),
+				_mm256_and_si256(isa, _mm256_add_epi8(a, _mm256_set1_epi8(10))));
+		}
+
+		__attribute__((target("avx2")))
+		size_t decodeAvx2(const char * in_i, const size_t len_i, uint8_t * out_o)
+		{
+			const __m256i mul = _mm256_set1_epi16(0x0110);
+			size_t i = 0;
+
+			for (; i + 64 <= len_i; i += 64) {
+				__m256i ok0, ok1;
+				__m256i v0 = valuesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in_i + i)), ok0);
+				__m256i v1 = valuesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in_i + i + 32)), ok1);
+				if (_mm256_movemask_epi8(_mm256_and_si256(ok0, ok1)) != -1) break;
+				// Packing also works per lane, so restore the order of the 64-bit quarters
+				__m256i b = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, mul), _mm256_maddubs_epi16(v1, mul));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(out_o + i/2), _mm256_permute4x64_epi64(b, 0xD8));
+			}
+			_mm256_zeroupper();
+			return i + decodeSsse3(in_i + i, len_i - i, out_o + i/2);
+		}
+#endif
+
+		/** Determine the fastest kernel once.
+		 * @returns Fastest kernel supported by this CPU */
+		Base16::kernel_e detect()
+		{
+#ifdef FS2A_BASE16_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) return Base16::avx2;
+			if (__builtin_cpu_supports("ssse3")) return Base16::ssse3;
+#endif
+			return Base16::scalar;
+		}
+
+		/** Resolve the kernel to use.
+		 * @param kernel_i Requested kernel
+		 * @returns Kernel to run
+		 * @throws std::invalid_argument when the kernel isn't supported. */
+		Base16::kernel_e resolve(const Base16::kernel_e kernel_i)
+		{
+			static const Base16::kernel_e fastest = detect();
+
+			if (kernel_i == Base16::best) return fastest;
+			if (kernel_i > fastest) throw std::invalid_argument("Base16 kernel not supported by this CPU");
+			return kernel_i;
+		}
+
+	} // anonymous namespace
+
+	bool Base16::supported(const kernel_e kernel_i)
+	{
+		return kernel_i == best || kernel_i <= resolve(best);
+	}
+
+	void Base16::encode(const uint8_t * in_i, const size_t len_i, char * out_o, const bool upper_i,
+		const kernel_e kernel_i)
+	{
+		switch (resolve(kernel_i)) {
+#ifdef FS2A_BASE16_X86
+			case avx2:
+				encodeAvx2(in_i, len_i, out_o, upper_i);
+				break;
+
+			case ssse3:
+				encodeSsse3(in_i, len_i, out_o, upper_i);
+				break;
+#endif
+			default:
+				encodeScalar(in_i, len_i, out_o, upper_i);
+				break;
+		}
+	}
+
+	size_t Base16::decode(const char * in_i, const size_t len_i, uint8_t * out_o, const kernel_e kernel_i)
+	{
+		switch (resolve(kernel_i)) {
+#ifdef FS2A_BASE16_X86
+			case avx2:
+				return decodeAvx2(in_i, len_i, out_o);
+
+			case ssse3:
+				return decodeSsse3(in_i, len_i, out_o);
+#endif
+			default:
+				return decodeScalar(in_i, len_i, out_o);
+		}
+	}
+
+	size_t base16encode(std::span<const std::byte> data_i, std::span<char> out_o, const bool upper_i)
+	{
+		if (out_o.size() < Base16::encodedLength(data_i.size())) {
+			throw std::length_error("Output buffer too small for Base16 encoding");
+		}
+		Base16::encode(reinterpret_cast<const uint8_t *>(data_i.data()), data_i.size(), out_o.data(), upper_i);
+		return Base16::encodedLength(data_i.size());
+	}
+
+	size_t base16decode(std::string_view hex_i, std::span<std::byte> out_o)
+	{
+		if (hex_i.size() % 2) throw std::runtime_error("Base16 input has an odd number of digits");
+		if (out_o.size() < Base16::decodedLength(hex_i.size())) {
+			throw std::length_error("Output buffer too small for Base16 decoding");
+		}
+
+		size_t n = Base16::decode(hex_i.data(), hex_i.size(), reinterpret_cast<uint8_t *>(out_o.data()));
+		if (n < hex_i.size()) {
+			// The pair at n contains an invalid digit, find out which one
+			if (decTbl[static_cast<uint8_t>(hex_i[n])] != 0xFF) n++;
+			std::ostringstream oss;
+			oss << "Unknown Base16 character \"" << hex_i[n] << "\" encountered at position " << n;
+			throw std::runtime_error(oss.str());
+		}
+		return Base16::decodedLength(hex_i.size());
+	}
+
+	std::ostream & operator<<(std::ostream & os_i, const Base16View & view_i)
+	{
+		view_i.write(std::ostreambuf_iterator<char>(os_i), view_i.upper());
+		return os_i;
+	}
+
+} // Fs2a namespace
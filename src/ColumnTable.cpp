@@ -0,0 +1,463 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <type_traits>
+#include <fmt/format.h>
+#include <fs2a/ColumnTable.hpp>
+#include <fs2a/Logger.hpp>
+#include <fs2a/Parallel.hpp>
+
+namespace Fs2a {
+
+	using namespace std::string_literals;
+	using std::string;
+
+	namespace {
+
+		/// Minimum number of cells per thread when converting columns
+		constexpr size_t parallelMinimum = 1 << 16;
+
+		/** @{ Convert a complete string to a value, without throwing.
+		 * @param value_i String to convert
+		 * @param value_o Converted value
+		 * @returns False when the string doesn't fully convert */
+		bool parseInteger(std::string_view value_i, int64_t & value_o)
+		{
+			const char * end = value_i.data() + value_i.size();
+			auto res = std::from_chars(value_i.data(), end, value_o);
+			return res.ec == std::errc() && res.ptr == end;
+		}
+
+		bool parseDecimal(std::string_view value_i, double & value_o)
+		{
+			const char * end = value_i.data() + value_i.size();
+			auto res = std::from_chars(value_i.data(), end, value_o);
+			return res.ec == std::errc() && res.ptr == end;
+		}
+
+		/** Check whether a number looks like one to type inference. Leading zeros, like in zip
+		 * codes and account numbers, would get lost, and nan and inf are more likely words than
+		 * numbers. Other spellings, like -0 or 1.50, are accepted and normalised on conversion.
+		 * @param value_i Number to check
+		 * @returns True when the number starts with a digit or point, after an optional minus
+		 * sign, and has no leading zeros */
+		bool plainNumber(std::string_view value_i)
+		{
+			if (!value_i.empty() && value_i.front() == '-') value_i.remove_prefix(1);
+			if (value_i.empty() || (value_i[0] != '.' && (value_i[0] < '0' || value_i[0] > '9'))) return false;
+			return value_i.size() == 1 || value_i[0] != '0' || value_i[1] < '0' || value_i[1] > '9';
+		}
+
+		bool parseBoolean(std::string_view value_i, uint8_t & value_o)
+		{
+			auto is = [&](std::string_view word_i) {
+				return value_i.size() == word_i.size() && std::equal(word_i.begin(), word_i.end(), value_i.begin(),
+					[](const char w_i, const char v_i) { return w_i == (v_i | 0x20); });
+			};
+			if (is("true")) value_o = 1;
+			else if (is("false")) value_o = 0;
+			else return false;
+			return true;
+		}
+		/** @} */
+
+	} // anonymous namespace
+
+	const char * ColumnTable::typeName(const type_e type_i)
+	{
+		switch (type_i) {
+			case text:    return "text";
+			case integer: return "integer";
+			case decimal: return "decimal";
+			case date:    return "date";
+			case time:    return "time";
+			case boolean: return "boolean";
+		}
+		return "unknown";
+	}
+
+	ColumnTable::Column::Column(const string & name_i, const type_e type_i)
+	: name_(name_i), type_(type_i), rows_(0)
+	{
+		switch (type_) {
+			// Qualified, because the text enumerator is hidden by Column::text()
+			case ColumnTable::text: values_.emplace<std::monostate>(); break;
+			case integer:           values_.emplace<std::vector<int64_t>>(); break;
+			case decimal:           values_.emplace<std::vector<double>>(); break;
+			case date:              values_.emplace<std::vector<NaiveDate>>(); break;
+			case time:              values_.emplace<std::vector<NaiveTime>>(); break;
+			case boolean:           values_.emplace<std::vector<uint8_t>>(); break;
+		}
+	}
+
+	void ColumnTable::Column::pushValid_(const bool valid_i)
+	{
+		if ((rows_ & 63) == 0) valid_.push_back(0);
+		if (valid_i) valid_.back() |= uint64_t(1) << (rows_ & 63);
+		rows_++;
+	}
+
+	size_t ColumnTable::Column::nulls() const
+	{
+		size_t set = 0;
+		for (const uint64_t w : valid_) set += std::popcount(w);
+		return rows_ - set;
+	}
+
+	const DictColumn & ColumnTable::Column::dict() const
+	{
+		if (type_ != ColumnTable::text) throw std::logic_error("Column \"" + name_ + "\" holds " + typeName(type_) + " values");
+		return dict_;
+	}
+
+	const string & ColumnTable::Column::text(const size_t row_i) const
+	{
+		const DictColumn & d = dict();
+		FCET(row_i < rows_, std::out_of_range, "Row {:d} of column \"{:s}\" doesn't exist, it has {:d} rows",
+			row_i, name_, rows_);
+		static const string empty;
+		return valid(row_i) ? d[row_i] : empty;
+	}
+
+	string ColumnTable::Column::str(const size_t row_i) const
+	{
+		FCET(row_i < rows_, std::out_of_range, "Row {:d} of column \"{:s}\" doesn't exist, it has {:d} rows",
+			row_i, name_, rows_);
+		if (!valid(row_i)) return ""s;
+
+		switch (type_) {
+			case ColumnTable::text: return dict_[row_i];
+			case integer:           return std::to_string(vec_<int64_t>()[row_i]);
+			case decimal:           return fmt::format("{}", vec_<double>()[row_i]);
+			case date:              return vec_<NaiveDate>()[row_i].iso8601();
+			case time:              return vec_<NaiveTime>()[row_i];
+			case boolean:           return vec_<uint8_t>()[row_i] ? "true"s : "false"s;
+		}
+		return ""s;
+	}
+
+	void ColumnTable::Column::append(const double value_i)
+	{
+		vec_<double>().push_back(value_i);
+		pushValid_(true);
+	}
+
+	void ColumnTable::Column::append(const NaiveDate & value_i)
+	{
+		FCET(value_i.valid(), std::invalid_argument, "Can't append invalid date to column \"{:s}\"", name_);
+		vec_<NaiveDate>().push_back(value_i);
+		pushValid_(true);
+	}
+
+	void ColumnTable::Column::append(const NaiveTime & value_i)
+	{
+		FCET(value_i.valid(), std::invalid_argument, "Can't append invalid time to column \"{:s}\"", name_);
+		vec_<NaiveTime>().push_back(value_i);
+		pushValid_(true);
+	}
+
+	bool ColumnTable::Column::parse_(std::string_view value_i)
+	{
+		if (value_i.empty()) {
+			appendNull();
+			return true;
+		}
+
+		switch (type_) {
+			case ColumnTable::text:
+				dict_.append(value_i);
+				break;
+
+			case integer: {
+				int64_t v = 0;
+				if (!parseInteger(value_i, v)) return false;
+				vec_<int64_t>().push_back(v);
+				break;
+			}
+
+			case decimal: {
+				double v = 0.0;
+				if (!parseDecimal(value_i, v)) return false;
+				vec_<double>().push_back(v);
+				break;
+			}
+
+			case date: {
+				NaiveDate d;
+				if (!d.parse(value_i)) return false;
+				vec_<NaiveDate>().push_back(d);
+				break;
+			}
+
+			case time: {
+				NaiveTime t;
+				if (!t.parse(value_i)) return false;
+				vec_<NaiveTime>().push_back(t);
+				break;
+			}
+
+			case boolean: {
+				uint8_t b = 0;
+				if (!parseBoolean(value_i, b)) return false;
+				vec_<uint8_t>().push_back(b);
+				break;
+			}
+		}
+		pushValid_(true);
+		return true;
+	}
+
+	void ColumnTable::Column::append(std::string_view value_i)
+	{
+		FCET(parse_(value_i), std::invalid_argument, "Unable to convert \"{:s}\" to {:s} for column \"{:s}\"",
+			value_i, typeName(type_), name_);
+	}
+
+	void ColumnTable::Column::appendNull()
+	{
+		if (type_ == ColumnTable::text) dict_.appendCode(0);
+		else std::visit([](auto & v) { if constexpr (!std::is_same_v<decltype(v), std::monostate &>) v.emplace_back(); }, values_);
+		pushValid_(false);
+	}
+
+	void ColumnTable::Column::reserve(const size_t rows_i)
+	{
+		if (type_ == ColumnTable::text) dict_.reserve(rows_i);
+		else std::visit([&](auto & v) { if constexpr (!std::is_same_v<decltype(v), std::monostate &>) v.reserve(rows_i); }, values_);
+		valid_.reserve((rows_i + 63) / 64);
+	}
+
+	void ColumnTable::Column::compact()
+	{
+		if (type_ == ColumnTable::text) dict_.compact();
+		else std::visit([](auto & v) { if constexpr (!std::is_same_v<decltype(v), std::monostate &>) v.shrink_to_fit(); }, values_);
+		valid_.shrink_to_fit();
+	}
+
+	size_t ColumnTable::Column::memoryUsage() const
+	{
+		size_t bytes = cellHeapBytes(name_) + valid_.capacity() * sizeof(uint64_t);
+		if (type_ == ColumnTable::text) bytes += dict_.memoryUsage();
+		else bytes += std::visit([](const auto & v) -> size_t {
+			if constexpr (std::is_same_v<decltype(v), const std::monostate &>) return 0;
+			else return v.capacity() * sizeof(v[0]);
+		}, values_);
+		return bytes;
+	}
+
+	ColumnTable::Column & ColumnTable::addColumn(const string & name_i, const type_e type_i)
+	{
+		FCET(!name_i.empty(), std::invalid_argument, "Given column name is empty");
+		FCET(cols_.size() < maxColumns, std::out_of_range, "Maximum number of columns {:d} reached", cols_.size());
+		FCET(hdrs_.find(name_i) == hdrs_.end(), std::invalid_argument, "Column \"{:s}\" already exists", name_i);
+
+		const size_t r = rows();
+		Column col(name_i, type_i);
+		col.reserve(r);
+		for (size_t i = 0; i < r; i++) col.appendNull();
+
+		hdrs_.emplace(name_i, static_cast<colidx_t>(cols_.size()));
+		cols_.push_back(std::move(col));
+		return cols_.back();
+	}
+
+	colidx_t ColumnTable::columnIndex(const string & name_i) const
+	{
+		auto hi = hdrs_.find(name_i);
+		if (hi == hdrs_.end()) throw std::invalid_argument("Unknown column header \""s + name_i + "\"");
+		return hi->second;
+	}
+
+	ColumnTable::Column & ColumnTable::column(const string & name_i)
+	{
+		return cols_[columnIndex(name_i)];
+	}
+
+	const ColumnTable::Column & ColumnTable::column(const string & name_i) const
+	{
+		return const_cast<ColumnTable *>(this)->column(name_i);
+	}
+
+	ColumnTable ColumnTable::fromTable(const Table<string> & table_i, const std::vector<type_e> & types_i)
+	{
+		std::vector<conversionError_t> errors;
+		ColumnTable ct = fromTable(table_i, types_i, errors);
+		if (!errors.empty()) {
+			const conversionError_t & e = errors.front();
+			const Column & col = ct.cols_[e.column];
+			FET(std::invalid_argument, "Unable to convert \"{:s}\" at row {:d} to {:s} for column \"{:s}\"",
+				e.value, e.row, typeName(col.type_), col.name_);
+		}
+		return ct;
+	}
+
+	ColumnTable ColumnTable::fromTable(const Table<string> & table_i, const std::vector<type_e> & types_i,
+		std::vector<conversionError_t> & errors_o)
+	{
+		const colidx_t cols = table_i.columns();
+		FCET(types_i.size() == cols, std::invalid_argument,
+			"Got {:d} column types for a table with {:d} columns", types_i.size(), cols);
+		FCET(table_i.rows() >= 1, std::invalid_argument, "No first row to read as header");
+
+		const uint32_t rows = table_i.rows();
+		// Header names as HeaderedTable would have them, so repeated names don't clash
+		std::vector<string> names;
+		names.reserve(cols);
+		for (colidx_t c = 0; c < cols; c++) names.push_back(table_i(c, 0));
+		HeaderedTable::uniqueHeaders(names);
+
+		ColumnTable ct;
+		for (colidx_t c = 0; c < cols; c++) ct.addColumn(names[c], types_i[c]).reserve(rows - 1);
+
+		// Columns are independent, so they are converted in parallel, each with its own errors.
+		// Column at a time keeps the destination writes sequential.
+		std::vector<std::vector<conversionError_t>> errors(cols);
+		const size_t parts = std::max<size_t>(1, std::min<size_t>({ hardwareThreads(), cols,
+			static_cast<size_t>(cols) * rows / parallelMinimum }));
+		parallelParts(parts, [&](const size_t p_i) {
+			for (size_t c = p_i; c < cols; c += parts) {
+				Column & col = ct.cols_[c];
+				for (uint32_t r = 1; r < rows; r++) {
+					const string & v = table_i(static_cast<colidx_t>(c), r);
+					if (col.parse_(v)) continue;
+					col.appendNull();
+					errors[c].push_back({ static_cast<colidx_t>(c), r, v });
+				}
+			}
+		});
+
+		const size_t first = errors_o.size();
+		for (auto & e : errors) errors_o.insert(errors_o.end(), std::make_move_iterator(e.begin()),
+			std::make_move_iterator(e.end()));
+		std::stable_sort(errors_o.begin() + first, errors_o.end(),
+			[](const conversionError_t & a_i, const conversionError_t & b_i) { return a_i.row < b_i.row; });
+
+		ct.updateAccount();
+		return ct;
+	}
+
+	ColumnTable ColumnTable::encode(const Table<string> & table_i)
+	{
+		return fromTable(table_i, std::vector<type_e>(table_i.columns(), ColumnTable::text));
+	}
+
+	size_t ColumnTable::compact()
+	{
+		for (Column & c : cols_) c.compact();
+		cols_.shrink_to_fit();
+		return updateAccount();
+	}
+
+	size_t ColumnTable::memoryUsage() const
+	{
+		size_t bytes = cols_.capacity() * sizeof(Column);
+		for (const Column & c : cols_) bytes += c.memoryUsage();
+		bytes += hdrs_.bucket_count() * sizeof(void *) + hdrs_.size() * (2 * sizeof(void *) + sizeof(*hdrs_.begin()));
+		for (const auto & h : hdrs_) bytes += cellHeapBytes(h.first);
+		return bytes;
+	}
+
+	size_t ColumnTable::updateAccount()
+	{
+		const size_t bytes = memoryUsage();
+		account_.set(static_cast<int64_t>(bytes));
+		return bytes;
+	}
+
+	std::vector<ColumnTable::type_e> ColumnTable::inferTypes(const Table<string> & table_i, const uint32_t sample_i)
+	{
+		const colidx_t cols = table_i.columns();
+		const uint32_t rows = table_i.rows() > 0 ? table_i.rows() - 1 : 0;
+		const uint32_t samples = sample_i == 0 || sample_i > rows ? rows : sample_i;
+
+		// Candidate types as bits, in order of preference
+		static constexpr type_e order[] = { integer, decimal, boolean, date, time };
+		constexpr auto bit = [](const type_e type_i) { return 1U << type_i; };
+		constexpr unsigned all = bit(integer) | bit(decimal) | bit(boolean) | bit(date) | bit(time);
+
+		std::vector<type_e> types(cols, ColumnTable::text);
+		for (colidx_t c = 0; c < cols; c++) {
+			unsigned candidates = all;
+			bool seen = false;
+			for (uint32_t s = 0; s < samples && candidates; s++) {
+				const string & v = table_i(c, static_cast<uint32_t>(1 + uint64_t(s) * rows / samples));
+				if (v.empty()) continue;
+				seen = true;
+
+				int64_t i;
+				double d;
+				uint8_t b;
+				NaiveDate nd;
+				NaiveTime nt;
+				if (!plainNumber(v)) candidates &= ~(bit(integer) | bit(decimal));
+				if ((candidates & bit(integer)) && !parseInteger(v, i)) candidates &= ~bit(integer);
+				if ((candidates & bit(decimal)) && !parseDecimal(v, d)) candidates &= ~bit(decimal);
+				if ((candidates & bit(boolean)) && !parseBoolean(v, b)) candidates &= ~bit(boolean);
+				if ((candidates & bit(date)) && !nd.parse(v)) candidates &= ~bit(date);
+				if ((candidates & bit(time)) && !nt.parse(v)) candidates &= ~bit(time);
+			}
+			if (!seen) continue;
+			for (const type_e t : order) {
+				if (candidates & bit(t)) {
+					types[c] = t;
+					break;
+				}
+			}
+		}
+
+		return types;
+	}
+
+	ColumnTable ColumnTable::infer(const Table<string> & table_i, std::vector<conversionError_t> & errors_o,
+		const uint32_t sample_i)
+	{
+		return fromTable(table_i, inferTypes(table_i, sample_i), errors_o);
+	}
+
+	HeaderedTable ColumnTable::toTable() const
+	{
+		HeaderedTable t;
+		if (cols_.empty()) return t;
+
+		t.columns(columns());
+		t.rows(static_cast<uint32_t>(rows() + 1));
+		for (colidx_t c = 0; c < columns(); c++) {
+			const Column & col = cols_[c];
+			t(c, 0) = col.name();
+			for (size_t r = 0; r < col.size(); r++) t(c, static_cast<uint32_t>(r + 1)) = col.str(r);
+		}
+
+		return t;
+	}
+
+} // Fs2a namespace
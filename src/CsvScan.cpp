@@ -0,0 +1,231 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <cstring>
+#include <stdexcept>
+#include <fs2a/CsvScan.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FS2A_CSVSCAN_X86
+#include <immintrin.h>
+#endif
+
+namespace Fs2a {
+
+	namespace {
+
+		CsvScan::masks_t classifyScalar(const char * in_i, const char separator_i)
+		{
+			CsvScan::masks_t m{0, 0, 0, 0};
+
+			for (unsigned i = 0; i < CsvScan::blockBytes; i++) {
+				const uint64_t b = uint64_t(1) << i;
+				// Quotes and line endings take precedence over the separator, like in the vector kernels
+				if (in_i[i] == '"') m.quote |= b;
+				else if (in_i[i] == '\r') m.cr |= b;
+				else if (in_i[i] == '\n') m.lf |= b;
+				else if (in_i[i] == separator_i) m.separator |= b;
+			}
+			return m;
+		}
+
+		void classifyAllScalar(const char * in_i, const size_t blocks_i, const char separator_i, CsvScan::masks_t * out_o)
+		{
+			for (size_t b = 0; b < blocks_i; b++) out_o[b] = classifyScalar(in_i + b * CsvScan::blockBytes, separator_i);
+		}
+
+		uint64_t prefixXorScalar(uint64_t bits_i)
+		{
+			bits_i ^= bits_i << 1;
+			bits_i ^= bits_i << 2;
+			bits_i ^= bits_i << 4;
+			bits_i ^= bits_i << 8;
+			bits_i ^= bits_i << 16;
+			bits_i ^= bits_i << 32;
+			return bits_i;
+		}
+
+#ifdef FS2A_CSVSCAN_X86
+		/** Bitmask of the bytes of 16 input bytes equal to a given one.
+		 * @param v_i Input bytes
+		 * @param c_i Byte to compare with, in all lanes
+		 * @returns 16 bit mask */
+		__attribute__((target("sse2")))
+		inline uint64_t eqSse2(const __m128i v_i, const __m128i c_i)
+		{
+			return static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v_i, c_i)));
+		}
+
+		__attribute__((target("sse2")))
+		inline CsvScan::masks_t classifySse2(const char * in_i, const char separator_i)
+		{
+			const __m128i q = _mm_set1_epi8('"'), s = _mm_set1_epi8(separator_i);
+			const __m128i cr = _mm_set1_epi8('\r'), lf = _mm_set1_epi8('\n');
+			CsvScan::masks_t m{0, 0, 0, 0};
+
+			for (unsigned i = 0; i < CsvScan::blockBytes; i += 16) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_i + i));
+				m.quote |= eqSse2(v, q) << i;
+				m.separator |= eqSse2(v, s) << i;
+				m.cr |= eqSse2(v, cr) << i;
+				m.lf |= eqSse2(v, lf) << i;
+			}
+			// A quote or line ending as separator is a quote or line ending
+			m.separator &= ~(m.quote | m.cr | m.lf);
+			return m;
+		}
+
+		__attribute__((target("sse2")))
+		void classifyAllSse2(const char * in_i, const size_t blocks_i, const char separator_i, CsvScan::masks_t * out_o)
+		{
+			for (size_t b = 0; b < blocks_i; b++) out_o[b] = classifySse2(in_i + b * CsvScan::blockBytes, separator_i);
+		}
+
+		/** Bitmask of the bytes of 32 input bytes equal to a given one.
+		 * @param v_i Input bytes
+		 * @param c_i Byte to compare with, in all lanes
+		 * @returns 32 bit mask */
+		__attribute__((target("avx2")))
+		inline uint64_t eqAvx2(const __m256i v_i, const __m256i c_i)
+		{
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v_i, c_i)));
+		}
+
+		__attribute__((target("avx2")))
+		inline CsvScan::masks_t classifyAvx2(const char * in_i, const char separator_i)
+		{
+			const __m256i q = _mm256_set1_epi8('"'), s = _mm256_set1_epi8(separator_i);
+			const __m256i cr = _mm256_set1_epi8('\r'), lf = _mm256_set1_epi8('\n');
+			const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in_i));
+			const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in_i + 32));
+			CsvScan::masks_t m;
+
+			m.quote = eqAvx2(lo, q) | eqAvx2(hi, q) << 32;
+			m.separator = eqAvx2(lo, s) | eqAvx2(hi, s) << 32;
+			m.cr = eqAvx2(lo, cr) | eqAvx2(hi, cr) << 32;
+			m.lf = eqAvx2(lo, lf) | eqAvx2(hi, lf) << 32;
+			m.separator &= ~(m.quote | m.cr | m.lf);
+			return m;
+		}
+
+		__attribute__((target("avx2")))
+		void classifyAllAvx2(const char * in_i, const size_t blocks_i, const char separator_i, CsvScan::masks_t * out_o)
+		{
+			for (size_t b = 0; b < blocks_i; b++) out_o[b] = classifyAvx2(in_i + b * CsvScan::blockBytes, separator_i);
+			_mm256_zeroupper();
+		}
+
+		__attribute__((target("sse2,pclmul")))
+		uint64_t prefixXorClmul(const uint64_t bits_i)
+		{
+			// Carry-less multiplication by all ones XORs every bit into all higher ones
+			const __m128i v = _mm_set_epi64x(0, static_cast<int64_t>(bits_i));
+			return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_clmulepi64_si128(v, _mm_set1_epi8(-1), 0)));
+		}
+#endif
+
+		/** Determine the fastest kernel once.
+		 * @returns Fastest kernel supported by this CPU */
+		CsvScan::kernel_e detect()
+		{
+#ifdef FS2A_CSVSCAN_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("pclmul")) {
+				if (__builtin_cpu_supports("avx2")) return CsvScan::avx2;
+				if (__builtin_cpu_supports("sse2")) return CsvScan::sse2;
+			}
+#endif
+			return CsvScan::scalar;
+		}
+
+		/** Resolve the kernel to use.
+		 * @param kernel_i Requested kernel
+		 * @returns Kernel to run
+		 * @throws std::invalid_argument when the kernel isn't supported. */
+		CsvScan::kernel_e resolve(const CsvScan::kernel_e kernel_i)
+		{
+			static const CsvScan::kernel_e fastest = detect();
+
+			if (kernel_i == CsvScan::best) return fastest;
+			if (kernel_i > fastest) throw std::invalid_argument("CsvScan kernel not supported by this CPU");
+			return kernel_i;
+		}
+
+	} // anonymous namespace
+
+	bool CsvScan::supported(const kernel_e kernel_i)
+	{
+		return kernel_i == best || kernel_i <= resolve(best);
+	}
+
+	void CsvScan::classify(const char * in_i, const size_t len_i, const char separator_i, masks_t * out_o,
+		const kernel_e kernel_i)
+	{
+		void (*all)(const char *, const size_t, const char, masks_t *) = classifyAllScalar;
+
+		switch (resolve(kernel_i)) {
+#ifdef FS2A_CSVSCAN_X86
+			case avx2:
+				all = classifyAllAvx2;
+				break;
+
+			case sse2:
+				all = classifyAllSse2;
+				break;
+#endif
+			default:
+				break;
+		}
+
+		const size_t full = len_i / blockBytes, rest = len_i % blockBytes;
+		all(in_i, full, separator_i, out_o);
+		if (rest == 0) return;
+
+		// Classify the remainder from a padded copy, and clear whatever the padding matched
+		char tail[blockBytes] = {};
+		std::memcpy(tail, in_i + full * blockBytes, rest);
+		masks_t & m = out_o[full];
+		all(tail, 1, separator_i, &m);
+		const uint64_t valid = (uint64_t(1) << rest) - 1;
+		m.quote &= valid;
+		m.separator &= valid;
+		m.cr &= valid;
+		m.lf &= valid;
+	}
+
+	uint64_t CsvScan::prefixXor(const uint64_t bits_i, const kernel_e kernel_i)
+	{
+#ifdef FS2A_CSVSCAN_X86
+		if (resolve(kernel_i) != scalar) return prefixXorClmul(bits_i);
+#endif
+		return prefixXorScalar(bits_i);
+	}
+
+} // Fs2a namespace
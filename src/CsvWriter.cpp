@@ -96,6 +96,21 @@ namespace Fs2a {
 		return quotedField_(field_i);
 	}
 
+	size_t CsvWriter::field(const Base16View & hex_i)
+	{
+		FCET(out_ != nullptr, std::logic_error, "Destination pointer for output not set yet, call destination() method first");
+		FCET(!settings_.forceHeader || lines_, std::logic_error, "The output CSV should contain a header but it was not yet written");
+
+		// Hexadecimal digits never need quoting
+		if (column_) out_->put(settings_.fieldSep);
+		if (settings_.quoting == always) out_->put('"');
+		*out_ << hex_i;
+		if (settings_.quoting == always) out_->put('"');
+		column_++;
+		if (columns_ && column_ == columns_) return endRow();
+		else return column_;
+	}
+
 	size_t CsvWriter::fields(const std::vector<std::string> & fields_i)
 	{
 		FCET(out_ != nullptr, std::logic_error, "Destination pointer for output not set yet, call destination() method first");
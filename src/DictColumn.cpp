@@ -0,0 +1,120 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <limits>
+#include <fs2a/DictColumn.hpp>
+
+namespace Fs2a {
+
+	DictColumn::DictColumn(HeaderedTable & table_i, const std::string & colname_i)
+	{
+		const colidx_t c = table_i.columnIndex(colname_i);
+		const uint32_t rows = table_i.rows();
+		reserve(rows > 0 ? rows - 1 : 0);
+		for (uint32_t r = 1; r < rows; r++) append(table_i(c, r));
+	}
+
+	DictColumn::DictColumn(const DictColumn & obj_i)
+	: dict_(obj_i.dict_), codes_(obj_i.codes_)
+	{
+		lookup_.reserve(dict_.size());
+		for (size_t i = 0; i < dict_.size(); i++) lookup_.emplace(dict_[i], static_cast<uint32_t>(i));
+	}
+
+	DictColumn & DictColumn::operator=(const DictColumn & obj_i)
+	{
+		if (this != &obj_i) *this = DictColumn(obj_i);
+		return *this;
+	}
+
+	void DictColumn::widen_()
+	{
+		// Convert to the next alternative, which is twice as wide
+		if (auto c8 = std::get_if<std::vector<uint8_t>>(&codes_)) {
+			std::vector<uint16_t> c16(c8->begin(), c8->end());
+			c16.reserve(c8->capacity());
+			codes_ = std::move(c16);
+		} else if (auto c16 = std::get_if<std::vector<uint16_t>>(&codes_)) {
+			std::vector<uint32_t> c32(c16->begin(), c16->end());
+			c32.reserve(c16->capacity());
+			codes_ = std::move(c32);
+		}
+	}
+
+	uint32_t DictColumn::append(std::string_view value_i)
+	{
+		auto it = lookup_.find(value_i);
+		uint32_t code;
+		if (it != lookup_.end()) {
+			code = it->second;
+		} else {
+			code = static_cast<uint32_t>(dict_.size());
+			dict_.emplace_back(value_i);
+			lookup_.emplace(dict_.back(), code);
+			if (code == uint32_t(std::numeric_limits<uint8_t>::max()) + 1 ||
+				code == uint32_t(std::numeric_limits<uint16_t>::max()) + 1) widen_();
+		}
+		appendCode(code);
+		return code;
+	}
+
+	void DictColumn::appendCode(const uint32_t code_i)
+	{
+		std::visit([&](auto & c_io) { c_io.push_back(static_cast<std::decay_t<decltype(c_io[0])>>(code_i)); }, codes_);
+	}
+
+	bool DictColumn::find(std::string_view value_i, uint32_t & code_o) const
+	{
+		auto it = lookup_.find(value_i);
+		if (it == lookup_.end()) return false;
+		code_o = it->second;
+		return true;
+	}
+
+	void DictColumn::compact()
+	{
+		std::visit([](auto & c_io) { c_io.shrink_to_fit(); }, codes_);
+	}
+
+	size_t DictColumn::memoryUsage() const
+	{
+		size_t bytes = dict_.size() * sizeof(std::string);
+		for (const std::string & s : dict_) bytes += cellHeapBytes(s);
+		bytes += lookup_.bucket_count() * sizeof(void *) + lookup_.size() * (2 * sizeof(void *) + sizeof(*lookup_.begin()));
+		bytes += std::visit([](const auto & c_i) { return c_i.capacity() * sizeof(c_i[0]); }, codes_);
+		return bytes;
+	}
+
+	void DictColumn::reserve(const size_t rows_i)
+	{
+		std::visit([&](auto & c_io) { c_io.reserve(rows_i); }, codes_);
+	}
+
+} // Fs2a namespace
@@ -28,14 +28,75 @@
  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_set>
 #include <fs2a/HeaderedTable.hpp>
+#include <fs2a/Parallel.hpp>
 
 namespace Fs2a {
 
 	using namespace std::string_literals;
 	using std::string;
 
+	HeaderedTable & HeaderedTable::operator=(const HeaderedTable & obj_i)
+	{
+		if (this != &obj_i) {
+			Table<string>::operator=(obj_i);
+			hdrs_ = obj_i.hdrs_;
+			indexes_.clear();
+		}
+		return *this;
+	}
+
+	string & HeaderedTable::cell(const colidx_t column_i, const uint32_t row_i)
+	{
+		string & c = Table<string>::cell(column_i, row_i);
+		if (!indexes_.empty()) touch_(column_i, row_i);
+		return c;
+	}
+
 	string & HeaderedTable::cell(const string & colname_i, const uint32_t row_i)
+	{
+		return cell(column_(colname_i), row_i);
+	}
+
+	size_t HeaderedTable::measureBytes_() const
+	{
+		// Hash tables are estimated as a bucket array and a node per entry with two pointers
+		constexpr size_t node = 2 * sizeof(void *);
+		size_t bytes = hdrs_.bucket_count() * sizeof(void *) + hdrs_.size() * (node + sizeof(*hdrs_.begin()));
+		for (const auto & h : hdrs_) bytes += cellHeapBytes(h.first);
+
+		for (const index_t & idx : indexes_) {
+			bytes += idx.cols.capacity() * sizeof(colidx_t) + idx.keys.capacity() * sizeof(const string *) +
+				idx.dirty.capacity() * sizeof(uint32_t);
+			bytes += idx.rows.bucket_count() * sizeof(void *) + idx.rows.size() * (node + sizeof(*idx.rows.begin()));
+			for (const auto & r : idx.rows) bytes += cellHeapBytes(r.first) + r.second.capacity() * sizeof(uint32_t);
+		}
+		bytes += indexes_.capacity() * sizeof(index_t);
+		return bytes;
+	}
+
+	size_t HeaderedTable::compact()
+	{
+		indexes_.clear();
+		indexes_.shrink_to_fit();
+		return Table<string>::compact();
+	}
+
+	void HeaderedTable::rows(const uint32_t rows_i)
+	{
+		indexes_.clear();
+		Table<string>::rows(rows_i);
+	}
+
+	colidx_t HeaderedTable::column_(const string & colname_i)
 	{
 		if (cols_ == 0) throw std::logic_error("Please set the number of columns first");
 		if (rows() < 1) throw std::logic_error("No first row to read as header");
@@ -45,38 +106,240 @@ namespace Fs2a {
 		// Headers Iterator
 		auto hi = hdrs_.find(colname_i);
 		if (hi == hdrs_.end()) throw std::invalid_argument("Unknown column header \""s + colname_i + "\"");
-		return Table<string>::cell(hi->second, row_i);
+		return hi->second;
 	}
 
-	void HeaderedTable::makeHeadersUnique_()
+	void HeaderedTable::dropIndexes()
 	{
-		for(uint16_t c = 0; c < cols_; c++) { // Column index
-			for (uint16_t d = c+1; d < cols_; d++) { // Duplicate index
-				if (Table<string>::cell(c, 0) == Table<string>::cell(d, 0)) {
-					// Duplicate header found
-					string uniqName = "";
-					uint16_t a = 0; // header Addition to make it unique
-					// Tempted to let "a" go to UINT16_MAX inclusive, but
-					// then the loop would never end due to wrapping.
-					while (a < UINT16_MAX) {
-						uniqName = Table<string>::cell(d, 0) + "_" + std::to_string(a);
-						for (uint16_t p = 0; p < cols_; p++) { // Potential new duplicate
-							if (Table<string>::cell(p, 0) == uniqName) {
-								// Altered column name is also a duplicate,
-								// continue searching
-								uniqName = "";
-								break;
-							}
-						}
-						// Unique new column name found
-						if (uniqName.size()) break;
-						a++;
-					}
+		indexes_.clear();
+	}
+
+	const std::vector<uint32_t> & HeaderedTable::find(const std::vector<string> & colnames_i, const std::vector<string> & values_i)
+	{
+		if (colnames_i.size() != values_i.size()) {
+			throw std::invalid_argument("Got "s + std::to_string(values_i.size()) + " values to find for " +
+				std::to_string(colnames_i.size()) + " columns");
+		}
+
+		static const std::vector<uint32_t> none;
+		index_t & idx = index_(colnames_i);
+		string key;
+		if (values_i.size() == 1) key = values_i.front();
+		else {
+			for (const string & v : values_i) {
+				const uint32_t len = static_cast<uint32_t>(v.size());
+				key.append(reinterpret_cast<const char *>(&len), sizeof(len)).append(v);
+			}
+		}
+
+		auto ri = idx.rows.find(key);
+		return ri == idx.rows.end() ? none : ri->second;
+	}
+
+	const std::vector<uint32_t> & HeaderedTable::find(const string & colname_i, const string & value_i)
+	{
+		return find(std::vector<string>{colname_i}, std::vector<string>{value_i});
+	}
+
+	void HeaderedTable::index(const std::vector<string> & colnames_i)
+	{
+		index_(colnames_i);
+	}
+
+	HeaderedTable::index_t & HeaderedTable::index_(const std::vector<string> & colnames_i)
+	{
+		if (colnames_i.empty()) throw std::invalid_argument("No columns given to index");
+
+		std::vector<colidx_t> cols;
+		cols.reserve(colnames_i.size());
+		for (const string & n : colnames_i) cols.push_back(column_(n));
+
+		for (auto it = indexes_.begin(); it != indexes_.end(); it++) {
+			if (it->cols != cols) continue;
+			// Rows appended without going through rows() aren't indexed
+			if (it->keys.size() == rows()) {
+				refresh_(*it);
+				return *it;
+			}
+			indexes_.erase(it);
+			break;
+		}
+
+		index_t idx;
+		const uint32_t rows = this->rows();
+		idx.cols = std::move(cols);
+		idx.keys.resize(rows, nullptr);
+		for (uint32_t r = 1; r < rows; r++) {
+			auto it = idx.rows.try_emplace(key_(idx.cols, r)).first;
+			it->second.push_back(r);
+			idx.keys[r] = &it->first;
+		}
 
-					if (uniqName.empty()) throw std::runtime_error("Column name "s + Table<string>::cell(c, 0) + " has duplicates, but unable to generate new unique name");
-					Table<string>::cell(d, 0) = uniqName;
+		indexes_.push_back(std::move(idx));
+		return indexes_.back();
+	}
+
+	string HeaderedTable::key_(const std::vector<colidx_t> & cols_i, const uint32_t row_i) const
+	{
+		if (cols_i.size() == 1) return (*this)(cols_i.front(), row_i);
+
+		// Length prefixed, so values containing any character can't mix up
+		string key;
+		for (const colidx_t c : cols_i) {
+			const string & v = (*this)(c, row_i);
+			const uint32_t len = static_cast<uint32_t>(v.size());
+			key.append(reinterpret_cast<const char *>(&len), sizeof(len)).append(v);
+		}
+		return key;
+	}
+
+	void HeaderedTable::refresh_(index_t & idx_io)
+	{
+		for (const uint32_t r : idx_io.dirty) {
+			string key = key_(idx_io.cols, r);
+			const string * old = idx_io.keys[r];
+			if (*old == key) continue;
+
+			// Move the row from its old key to its new one
+			auto oi = idx_io.rows.find(*old);
+			oi->second.erase(std::lower_bound(oi->second.begin(), oi->second.end(), r));
+			if (oi->second.empty()) idx_io.rows.erase(oi);
+
+			auto ni = idx_io.rows.try_emplace(std::move(key)).first;
+			ni->second.insert(std::lower_bound(ni->second.begin(), ni->second.end(), r), r);
+			idx_io.keys[r] = &ni->first;
+		}
+		idx_io.dirty.clear();
+	}
+
+	void HeaderedTable::touch_(const colidx_t column_i, const uint32_t row_i)
+	{
+		if (row_i == 0) return;
+
+		for (size_t i = 0; i < indexes_.size(); ) {
+			index_t & idx = indexes_[i];
+			if (std::find(idx.cols.begin(), idx.cols.end(), column_i) != idx.cols.end()) {
+				// Rebuild on next use when rows were appended behind its back, or
+				// when that is cheaper than updating a large part of the rows
+				if (row_i >= idx.keys.size() || idx.dirty.size() > idx.keys.size() / 4 + 64) {
+					indexes_.erase(indexes_.begin() + static_cast<ptrdiff_t>(i));
+					continue;
+				}
+				idx.dirty.push_back(row_i);
+			}
+			i++;
+		}
+	}
+
+	void HeaderedTable::sortBy(const std::vector<sortKey_t> & keys_i, const unsigned threads_i)
+	{
+		// Minimum number of rows per thread
+		constexpr uint32_t parallelMinimum = 1 << 15;
+
+		if (keys_i.empty()) throw std::invalid_argument("No columns given to sort by");
+
+		std::vector<colidx_t> cols;
+		for (const sortKey_t & k : keys_i) cols.push_back(column_(k.column));
+
+		const uint32_t n = rows() - 1;
+		if (n < 2) return;
+
+		// Numeric columns are converted once, values that are no number become NaN
+		std::vector<std::vector<double>> nums(keys_i.size());
+		for (size_t k = 0; k < keys_i.size(); k++) {
+			if (!keys_i[k].numeric) continue;
+			nums[k].resize(n);
+			for (uint32_t r = 0; r < n; r++) {
+				const string & v = (*this)(cols[k], r + 1);
+				double d = std::numeric_limits<double>::quiet_NaN();
+				auto res = std::from_chars(v.data(), v.data() + v.size(), d);
+				if (res.ec != std::errc() || res.ptr != v.data() + v.size()) d = std::numeric_limits<double>::quiet_NaN();
+				nums[k][r] = d;
+			}
+		}
+
+		auto less = [&](const uint32_t a_i, const uint32_t b_i) {
+			for (size_t k = 0; k < keys_i.size(); k++) {
+				const bool desc = keys_i[k].descending;
+				if (keys_i[k].numeric) {
+					const double x = nums[k][a_i - 1], y = nums[k][b_i - 1];
+					const bool xn = std::isnan(x), yn = std::isnan(y);
+					if (xn || yn) {
+						if (xn != yn) return yn;
+						continue;
+					}
+					if (x != y) return desc ? x > y : x < y;
+				} else {
+					const int c = (*this)(cols[k], a_i).compare((*this)(cols[k], b_i));
+					if (c) return desc ? c > 0 : c < 0;
 				}
 			}
+			return false;
+		};
+
+		// Stable sort parts of the permutation in parallel, then merge them pairwise
+		std::vector<uint32_t> perm(n);
+		std::iota(perm.begin(), perm.end(), 1U);
+		const size_t parts = std::max<size_t>(1, std::min<size_t>(threads_i ? threads_i : hardwareThreads(), n / parallelMinimum));
+		std::vector<size_t> bounds(parts + 1);
+		for (size_t p = 0; p <= parts; p++) bounds[p] = n * p / parts;
+
+		parallelParts(parts, [&](const size_t p_i) {
+			std::stable_sort(perm.begin() + bounds[p_i], perm.begin() + bounds[p_i + 1], less);
+		});
+		for (size_t width = 1; width < parts; width *= 2) {
+			parallelParts((parts + 2 * width - 1) / (2 * width), [&](const size_t m_i) {
+				const size_t lo = 2 * width * m_i, mid = std::min(lo + width, parts), hi = std::min(lo + 2 * width, parts);
+				if (mid < hi) {
+					std::inplace_merge(perm.begin() + bounds[lo], perm.begin() + bounds[mid], perm.begin() + bounds[hi], less);
+				}
+			});
+		}
+
+		// Move the rows into their new order, the header stays first
+		std::vector<string> sorted;
+		sorted.reserve(data_.size());
+		std::move(data_.begin(), data_.begin() + cols_, std::back_inserter(sorted));
+		for (const uint32_t r : perm) {
+			auto first = data_.begin() + static_cast<ptrdiff_t>(r) * cols_;
+			std::move(first, first + cols_, std::back_inserter(sorted));
+		}
+		data_.swap(sorted);
+		updateAccount_();
+		indexes_.clear();
+	}
+
+	void HeaderedTable::makeHeadersUnique_()
+	{
+		std::vector<string> names;
+		names.reserve(cols_);
+		for (colidx_t c = 0; c < cols_; c++) names.push_back(Table<string>::cell(c, 0));
+
+		uniqueHeaders(names);
+		for (colidx_t c = 0; c < cols_; c++) {
+			if (Table<string>::cell(c, 0) != names[c]) Table<string>::cell(c, 0) = std::move(names[c]);
+		}
+	}
+
+	void HeaderedTable::uniqueHeaders(std::vector<string> & names_io)
+	{
+		// All names as they are are taken, so generated names never clash with later ones
+		std::unordered_set<string> taken(names_io.begin(), names_io.end());
+		if (taken.size() == names_io.size()) return;
+
+		// First occurrences keep their name, the others get the lowest free suffix of their name
+		std::unordered_set<std::string_view> seen;
+		std::unordered_map<string, size_t> next;
+		seen.reserve(names_io.size());
+		for (string & name : names_io) {
+			if (seen.insert(name).second) continue;
+
+			size_t & a = next[name]; // header Addition to make it unique
+			string uniqName;
+			do {
+				uniqName = name + "_" + std::to_string(a++);
+			} while (!taken.insert(uniqName).second);
+			name = std::move(uniqName);
 		}
 	}
 
@@ -85,7 +348,7 @@ namespace Fs2a {
 		makeHeadersUnique_();
 		hdrs_.clear();
 
-		for (uint16_t c = 0; c < cols_; c++) {
+		for (colidx_t c = 0; c < cols_; c++) {
 			string hdrname = Table<string>::cell(c, 0);
 			if (hdrname.empty()) {
 				hdrs_.clear();
@@ -0,0 +1,102 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fs2a/Logger.hpp>
+#include <fs2a/MappedFile.hpp>
+
+namespace Fs2a {
+
+	MappedFile::MappedFile(const std::string & path_i)
+	: data_(nullptr), size_(0)
+	{
+		errno = 0;
+		const int fd = open(path_i.c_str(), O_RDONLY | O_CLOEXEC);
+		FCET(fd != -1, std::runtime_error, "Unable to open {:s}: {:s}", path_i, std::strerror(errno));
+
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			const int err = errno;
+			close(fd);
+			FET(std::runtime_error, "Unable to determine size of {:s}: {:s}", path_i, std::strerror(err));
+		}
+
+		size_ = static_cast<size_t>(st.st_size);
+		if (size_ > 0) {
+			void * p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+			const int err = errno;
+			close(fd);
+			FCET(p != MAP_FAILED, std::runtime_error, "Unable to map {:s}: {:s}", path_i, std::strerror(err));
+			data_ = static_cast<const char *>(p);
+		} else {
+			close(fd);
+		}
+	}
+
+	MappedFile::MappedFile(MappedFile && obj_io) noexcept
+	: data_(std::exchange(obj_io.data_, nullptr)), size_(std::exchange(obj_io.size_, 0))
+	{ }
+
+	MappedFile & MappedFile::operator=(MappedFile && obj_io) noexcept
+	{
+		if (this != &obj_io) {
+			unmap_();
+			data_ = std::exchange(obj_io.data_, nullptr);
+			size_ = std::exchange(obj_io.size_, 0);
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		unmap_();
+	}
+
+	void MappedFile::sequential() const
+	{
+		// Only a hint, so failure doesn't matter
+		if (data_ != nullptr) madvise(const_cast<char *>(data_), size_, MADV_SEQUENTIAL);
+	}
+
+	void MappedFile::unmap_()
+	{
+		if (data_ != nullptr) munmap(const_cast<char *>(data_), size_);
+		data_ = nullptr;
+		size_ = 0;
+	}
+
+} // Fs2a namespace
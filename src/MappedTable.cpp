@@ -0,0 +1,262 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <fs2a/Logger.hpp>
+#include <fs2a/MappedTable.hpp>
+#include <fs2a/readCSV.hpp>
+
+namespace Fs2a {
+
+	namespace fs = std::filesystem;
+
+	namespace {
+
+		/// Magic bytes at the start of every file
+		constexpr char magic[8] = "FS2ATBL";
+
+		/// Byte order marker
+		constexpr uint32_t order = 0x01020304;
+
+		/** Round up to a multiple of 8.
+		 * @param pos_i Position to round
+		 * @returns Rounded position */
+		constexpr uint64_t align8(const uint64_t pos_i) { return (pos_i + 7) & ~uint64_t(7); }
+
+	} // anonymous namespace
+
+	MappedTable::MappedTable(const std::string & path_i)
+	: file_(path_i), cols_(0), rows_(0), flags_(0)
+	{
+		const char * d = file_.data();
+		const uint64_t size = file_.size();
+
+		FCET(size >= sizeof(fileHeader_t), std::runtime_error, "File {:s} is too small for a binary table", path_i);
+		fileHeader_t h;
+		memcpy(&h, d, sizeof(h));
+		FCET(memcmp(h.magic, magic, sizeof(magic)) == 0, std::runtime_error, "File {:s} is not a binary table", path_i);
+		FCET(h.order == order, std::runtime_error, "Binary table {:s} has a different byte order", path_i);
+		FCET(h.version == version, std::runtime_error, "Binary table {:s} has unsupported version {:d}", path_i,
+			h.version);
+		FCET(h.rows <= UINT32_MAX && h.columns <= maxColumns, std::runtime_error,
+			"Binary table {:s} has {:d} columns and {:d} rows, which is too large", path_i, h.columns, h.rows);
+		FCET(size >= sizeof(fileHeader_t) + h.columns * sizeof(columnEntry_t), std::runtime_error,
+			"Binary table {:s} is truncated in its column directory", path_i);
+
+		cols_ = static_cast<colidx_t>(h.columns);
+		rows_ = static_cast<uint32_t>(h.rows);
+		flags_ = h.flags;
+		offsets_.reserve(cols_);
+		heaps_.reserve(cols_);
+		heapSizes_.reserve(cols_);
+		for (colidx_t c = 0; c < cols_; c++) {
+			columnEntry_t e;
+			memcpy(&e, d + sizeof(fileHeader_t) + c * sizeof(columnEntry_t), sizeof(e));
+			FCET(e.type == 0, std::runtime_error, "Column {:d} of binary table {:s} has unsupported type {:d}", c,
+				path_i, e.type);
+			FCET(e.offsets % 8 == 0 && e.offsets <= size && (size - e.offsets) / sizeof(uint64_t) > h.rows &&
+				e.heap <= size && e.heapSize <= size - e.heap, std::runtime_error,
+				"Column {:d} of binary table {:s} lies outside the file", c, path_i);
+
+			const uint64_t * o = reinterpret_cast<const uint64_t *>(d + e.offsets);
+			FCET(o[0] == 0 && o[rows_] == e.heapSize, std::runtime_error,
+				"Column {:d} of binary table {:s} has corrupt offsets", c, path_i);
+			offsets_.push_back(o);
+			heaps_.push_back(d + e.heap);
+			heapSizes_.push_back(e.heapSize);
+		}
+
+		if (isHeadered() && rows_ > 0) {
+			hdrs_.reserve(cols_);
+			for (colidx_t c = 0; c < cols_; c++) hdrs_.emplace(cell(c, 0), c);
+		}
+	}
+
+	std::string_view MappedTable::cell(const colidx_t column_i, const uint32_t row_i) const
+	{
+		FCET(column_i < cols_, std::out_of_range, "Requested column {:d} should be less than the number of columns, "
+			"which is {:d}", column_i, cols_);
+		FCET(row_i < rows_, std::out_of_range, "Requested row {:d} should be less than the number of rows, which is {:d}",
+			row_i, rows_);
+		const uint64_t * o = offsets_[column_i] + row_i;
+		FCET(o[0] <= o[1] && o[1] <= heapSizes_[column_i], std::runtime_error,
+			"Cell at column {:d}, row {:d} has corrupt offsets", column_i, row_i);
+		return (*this)(column_i, row_i);
+	}
+
+	std::string_view MappedTable::cell(const std::string & colname_i, const uint32_t row_i) const
+	{
+		return cell(columnIndex(colname_i), row_i);
+	}
+
+	colidx_t MappedTable::columnIndex(const std::string & colname_i) const
+	{
+		FCET(isHeadered(), std::logic_error, "Binary table has no header to look up column {:s}", colname_i);
+		auto it = hdrs_.find(colname_i);
+		FCET(it != hdrs_.end(), std::invalid_argument, "Column name {:s} not found", colname_i);
+		return it->second;
+	}
+
+	Table<std::string> MappedTable::toTable() const
+	{
+		Table<std::string> t;
+		if (cols_ == 0) return t;
+
+		t.columns(cols_);
+		t.rows(rows_);
+		for (uint32_t r = 0; r < rows_; r++) {
+			for (colidx_t c = 0; c < cols_; c++) t(c, r) = cell(c, r);
+		}
+		return t;
+	}
+
+	void writeBinary(const Table<std::string> & table_i, std::ostream & stream_o, const bool headered_i,
+		const char separator_i)
+	{
+		const colidx_t cols = table_i.columns();
+		const uint32_t rows = table_i.rows();
+
+		MappedTable::fileHeader_t h;
+		memcpy(h.magic, magic, sizeof(magic));
+		h.order = order;
+		h.version = MappedTable::version;
+		h.flags = (headered_i ? uint64_t(MappedTable::headered) : 0) |
+			uint64_t(static_cast<unsigned char>(separator_i)) << MappedTable::separatorShift;
+		h.rows = rows;
+		h.columns = cols;
+
+		// Lay out all columns first, the directory comes before them
+		std::vector<MappedTable::columnEntry_t> dir(cols);
+		uint64_t pos = sizeof(h) + cols * sizeof(MappedTable::columnEntry_t);
+		for (colidx_t c = 0; c < cols; c++) {
+			MappedTable::columnEntry_t & e = dir[c];
+			e.type = 0;
+			e.reserved = 0;
+			e.offsets = pos;
+			e.heap = pos + (rows + uint64_t(1)) * sizeof(uint64_t);
+			e.heapSize = 0;
+			for (uint32_t r = 0; r < rows; r++) e.heapSize += table_i(c, r).size();
+			pos = align8(e.heap + e.heapSize);
+		}
+
+		stream_o.write(reinterpret_cast<const char *>(&h), sizeof(h));
+		stream_o.write(reinterpret_cast<const char *>(dir.data()), dir.size() * sizeof(MappedTable::columnEntry_t));
+		std::vector<uint64_t> offsets(rows + uint64_t(1));
+		static const char padding[8] = {};
+		for (colidx_t c = 0; c < cols; c++) {
+			offsets[0] = 0;
+			for (uint32_t r = 0; r < rows; r++) offsets[r + 1] = offsets[r] + table_i(c, r).size();
+			stream_o.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint64_t));
+			for (uint32_t r = 0; r < rows; r++) {
+				const std::string & v = table_i(c, r);
+				stream_o.write(v.data(), static_cast<std::streamsize>(v.size()));
+			}
+			stream_o.write(padding, static_cast<std::streamsize>(align8(dir[c].heapSize) - dir[c].heapSize));
+		}
+		FCET(stream_o.good(), std::runtime_error, "Failed writing binary table");
+	}
+
+	void writeBinary(const Table<std::string> & table_i, const std::string & path_i, const bool headered_i,
+		const char separator_i)
+	{
+		const std::string tmp = path_i + ".tmp" + std::to_string(getpid());
+		{
+			std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+			FCET(out.is_open(), std::runtime_error, "Unable to open {:s} for writing", tmp);
+			try {
+				writeBinary(table_i, out, headered_i, separator_i);
+				out.close();
+				FCET(!out.fail(), std::runtime_error, "Failed writing binary table {:s}", tmp);
+			} catch (...) {
+				std::error_code ec;
+				fs::remove(tmp, ec);
+				throw;
+			}
+		}
+		std::error_code ec;
+		fs::rename(tmp, path_i, ec);
+		if (ec) {
+			fs::remove(tmp, ec);
+			FET(std::runtime_error, "Unable to rename {:s} to {:s}: {:s}", tmp, path_i, ec.message());
+		}
+	}
+
+	void writeBinary(const HeaderedTable & table_i, const std::string & path_i, const char separator_i)
+	{
+		if (table_i.rows() == 0) {
+			writeBinary(static_cast<const Table<std::string> &>(table_i), path_i, true, separator_i);
+			return;
+		}
+
+		// Only copy the table when the header needs different names
+		std::vector<std::string> names;
+		for (colidx_t c = 0; c < table_i.columns(); c++) names.push_back(table_i(c, 0));
+		HeaderedTable::uniqueHeaders(names);
+		bool unique = true;
+		for (colidx_t c = 0; c < table_i.columns() && unique; c++) unique = names[c] == table_i(c, 0);
+		if (unique) {
+			writeBinary(static_cast<const Table<std::string> &>(table_i), path_i, true, separator_i);
+			return;
+		}
+
+		Table<std::string> t(table_i);
+		for (colidx_t c = 0; c < t.columns(); c++) t(c, 0) = std::move(names[c]);
+		writeBinary(t, path_i, true, separator_i);
+	}
+
+	MappedTable cacheCSV(const std::string & csvPath_i, const char separator_i, const bool headered_i)
+	{
+		const std::string cache = csvPath_i + ".fs2t";
+		std::error_code ec;
+		const fs::file_time_type csvTime = fs::last_write_time(csvPath_i, ec);
+		FCET(!ec, std::runtime_error, "Unable to read CSV file {:s}: {:s}", csvPath_i, ec.message());
+
+		const fs::file_time_type cacheTime = fs::last_write_time(cache, ec);
+		if (!ec && cacheTime >= csvTime) {
+			try {
+				MappedTable t(cache);
+				if (t.isHeadered() == headered_i && t.separator() == separator_i) return t;
+			} catch (const std::runtime_error &) {
+				// Unreadable, so write it again
+			}
+		}
+
+		std::ifstream in(csvPath_i, std::ios::binary);
+		FCET(in.is_open(), std::runtime_error, "Unable to open CSV file {:s}", csvPath_i);
+		if (headered_i) writeBinary(HeaderedTable(readCSV(in, separator_i)), cache, separator_i);
+		else writeBinary(readCSV(in, separator_i), cache, false, separator_i);
+		return MappedTable(cache);
+	}
+
+} // Fs2a namespace
@@ -27,6 +27,7 @@
  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 
+#include <charconv>
 #include <cstdint>
 #include <ctime>
 #include <limits>
@@ -109,6 +110,27 @@ namespace Fs2a {
 		return fmt::format("{:04d}-{:02d}-{:02d}", year_ , month_, day_);
 	}
 
+	bool NaiveDate::parse(std::string_view date_i)
+	{
+		if (date_i.size() != 10 || date_i[4] != '-' || date_i[7] != '-') return false;
+
+		// Exactly the given number of digits, so no signs or spaces
+		auto num = [&](const size_t pos_i, const size_t len_i, unsigned & v_o) {
+			const char * first = date_i.data() + pos_i, * last = first + len_i;
+			auto res = std::from_chars(first, last, v_o);
+			return res.ec == std::errc() && res.ptr == last && *first != '+';
+		};
+		unsigned year = 0, mon = 0, day = 0;
+		if (!num(0, 4, year) || !num(5, 2, mon) || !num(8, 2, day)) return false;
+		if (year < 1900 || !NaiveDate::valid(static_cast<uint16_t>(year), static_cast<uint8_t>(mon),
+			static_cast<uint8_t>(day))) return false;
+
+		year_ = static_cast<uint16_t>(year);
+		month_ = static_cast<uint8_t>(mon);
+		day_ = static_cast<uint8_t>(day);
+		return true;
+	}
+
 	bool NaiveDate::leap_(const uint16_t year_i)
 	{
 		if (year_i % 400 == 0) return true;
@@ -27,6 +27,7 @@
  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 
+#include <charconv>
 #include <cstdlib>
 #include <regex>
 #include <stdexcept>
@@ -123,6 +124,27 @@ namespace Fs2a {
 		return *this;
 	}
 
+	bool NaiveTime::parse(std::string_view time_i)
+	{
+		const size_t colon = time_i.find(':');
+		if (colon == 0 || colon > 2) return false;
+		const size_t minLen = time_i.size() - colon - 1;
+		if (minLen < 1 || minLen > 2) return false;
+
+		// Only digits, so no signs
+		auto num = [&](const size_t pos_i, const size_t len_i, unsigned & v_o) {
+			const char * first = time_i.data() + pos_i, * last = first + len_i;
+			auto res = std::from_chars(first, last, v_o);
+			return res.ec == std::errc() && res.ptr == last && *first != '+';
+		};
+		unsigned hour = 0, min = 0;
+		if (!num(0, colon, hour) || !num(colon + 1, minLen, min) || hour > 23 || min > 59) return false;
+
+		hour_ = static_cast<uint8_t>(hour);
+		min_ = static_cast<uint8_t>(min);
+		return true;
+	}
+
 	bool NaiveTime::operator>(const NaiveTime & rhs) const
 	{
 		if (!valid_()) throw std::logic_error("Lefthand-side object is not valid");
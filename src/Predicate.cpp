@@ -0,0 +1,517 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <algorithm>
+#include <charconv>
+#include <deque>
+#include <limits>
+#include <string_view>
+#include <fs2a/Logger.hpp>
+#include <fs2a/Predicate.hpp>
+
+namespace Fs2a {
+
+	using std::string;
+	using std::string_view;
+
+	namespace {
+
+		/** Fill a selection from a condition per row, 64 rows at a time.
+		 * @param out_o Selection to fill
+		 * @param mask_i Blocks of 64 rows without any row selected in here are skipped,
+		 * nullptr for none
+		 * @param match_i Condition, called with the row */
+		template <typename F>
+		void scan(Selection & out_o, const Selection * mask_i, F && match_i)
+		{
+			std::span<uint64_t> words = out_o.words();
+			const size_t rows = out_o.size();
+			for (size_t w = 0; w < words.size(); w++) {
+				if (mask_i != nullptr && mask_i->words()[w] == 0) {
+					words[w] = 0;
+					continue;
+				}
+				const size_t base = w * 64, n = std::min<size_t>(64, rows - base);
+				uint64_t bits = 0;
+				for (size_t b = 0; b < n; b++) bits |= uint64_t(match_i(base + b)) << b;
+				words[w] = bits;
+			}
+		}
+
+		/** Compare the value of every row with keys.
+		 * The operator is resolved once, so the loop per row is branch free and can be
+		 * vectorized for native types.
+		 * @param op_i Comparison operator
+		 * @param keys_i Values to compare with, sorted and unique for opIn
+		 * @param get_i Function returning the value of a row
+		 * @param out_o Selection to fill
+		 * @param mask_i See scan() */
+		template <typename K, typename Get>
+		void compare(const Predicate::op_e op_i, const std::vector<K> & keys_i, Get && get_i, Selection & out_o,
+			const Selection * mask_i)
+		{
+			switch (op_i) {
+				case Predicate::opEqual:
+					scan(out_o, mask_i, [&, k = keys_i[0]](const size_t r_i) { return get_i(r_i) == k; });
+					break;
+				case Predicate::opNotEqual:
+					scan(out_o, mask_i, [&, k = keys_i[0]](const size_t r_i) { return get_i(r_i) != k; });
+					break;
+				case Predicate::opLess:
+					scan(out_o, mask_i, [&, k = keys_i[0]](const size_t r_i) { return get_i(r_i) < k; });
+					break;
+				case Predicate::opLessEqual:
+					scan(out_o, mask_i, [&, k = keys_i[0]](const size_t r_i) { return get_i(r_i) <= k; });
+					break;
+				case Predicate::opGreater:
+					scan(out_o, mask_i, [&, k = keys_i[0]](const size_t r_i) { return get_i(r_i) > k; });
+					break;
+				case Predicate::opGreaterEqual:
+					scan(out_o, mask_i, [&, k = keys_i[0]](const size_t r_i) { return get_i(r_i) >= k; });
+					break;
+				case Predicate::opBetween:
+					scan(out_o, mask_i, [&, lo = keys_i[0], hi = keys_i[1]](const size_t r_i) {
+						const K v = get_i(r_i);
+						return lo <= v && v <= hi;
+					});
+					break;
+				case Predicate::opIn:
+					scan(out_o, mask_i, [&](const size_t r_i) {
+						return std::binary_search(keys_i.begin(), keys_i.end(), K(get_i(r_i)));
+					});
+					break;
+				default:
+					break;
+			}
+		}
+
+		/** @{ Convert a complete string, without throwing.
+		 * @param value_i String to convert
+		 * @param value_o Converted value
+		 * @returns False when the string doesn't fully convert */
+		template <typename N>
+		bool parseNumber(string_view value_i, N & value_o)
+		{
+			const char * end = value_i.data() + value_i.size();
+			auto res = std::from_chars(value_i.data(), end, value_o);
+			return res.ec == std::errc() && res.ptr == end;
+		}
+
+		bool parseBoolean(string_view value_i, uint8_t & value_o)
+		{
+			auto is = [&](string_view word_i) {
+				return value_i.size() == word_i.size() && std::equal(word_i.begin(), word_i.end(), value_i.begin(),
+					[](const char w_i, const char v_i) { return w_i == (v_i | 0x20); });
+			};
+			if (is("true")) value_o = 1;
+			else if (is("false")) value_o = 0;
+			else return false;
+			return true;
+		}
+
+		bool parseDate(string_view value_i, uint32_t & value_o)
+		{
+			NaiveDate d;
+			if (!d.parse(value_i)) return false;
+			value_o = uint32_t(d.year()) << 9 | uint32_t(d.month()) << 5 | d.day();
+			return true;
+		}
+
+		bool parseTime(string_view value_i, uint32_t & value_o)
+		{
+			NaiveTime t;
+			if (!t.parse(value_i)) return false;
+			value_o = uint32_t(t.hour()) * 60 + t.minute();
+			return true;
+		}
+		/** @} */
+
+		/** Convert the values of a condition to keys of a column type.
+		 * @param op_i Comparison operator, to sort the keys for opIn
+		 * @param values_i Values to convert
+		 * @param parse_i Conversion function
+		 * @param col_i Column the keys are for, for error messages
+		 * @returns Keys
+		 * @throws std::invalid_argument when a value doesn't convert */
+		template <typename K, typename P>
+		std::vector<K> keys(const Predicate::op_e op_i, const std::vector<string> & values_i, P && parse_i,
+			const ColumnTable::Column & col_i)
+		{
+			std::vector<K> res;
+			res.reserve(values_i.size());
+			for (const string & v : values_i) {
+				K k{};
+				FCET(parse_i(v, k), std::invalid_argument, "Value \"{:s}\" can't be compared with {:s} column \"{:s}\"",
+					v, ColumnTable::typeName(col_i.type()), col_i.name());
+				res.push_back(k);
+			}
+			if (op_i == Predicate::opIn) {
+				std::sort(res.begin(), res.end());
+				res.erase(std::unique(res.begin(), res.end()), res.end());
+			}
+			return res;
+		}
+
+		/** Evaluate a condition on strings.
+		 * @param op_i Comparison operator
+		 * @param values_i Values to compare with
+		 * @param get_i Function returning the string_view of a row
+		 * @param out_o Selection to fill
+		 * @param mask_i See scan() */
+		template <typename Get>
+		void strings(const Predicate::op_e op_i, const std::vector<string> & values_i, Get && get_i, Selection & out_o,
+			const Selection * mask_i)
+		{
+			if (op_i == Predicate::opPrefix) {
+				scan(out_o, mask_i, [&, p = string_view(values_i[0])](const size_t r_i) { return get_i(r_i).starts_with(p); });
+				return;
+			}
+
+			// Order comparisons with only numbers compare numerically
+			if (op_i >= Predicate::opLess && op_i <= Predicate::opBetween) {
+				std::vector<double> nums;
+				for (const string & v : values_i) {
+					double d;
+					if (!parseNumber(v, d)) break;
+					nums.push_back(d);
+				}
+				if (nums.size() == values_i.size()) {
+					compare(op_i, nums, [&](const size_t r_i) {
+						double d;
+						return parseNumber(get_i(r_i), d) ? d : std::numeric_limits<double>::quiet_NaN();
+					}, out_o, mask_i);
+					return;
+				}
+			}
+
+			std::vector<string_view> k(values_i.begin(), values_i.end());
+			if (op_i == Predicate::opIn) {
+				std::sort(k.begin(), k.end());
+				k.erase(std::unique(k.begin(), k.end()), k.end());
+			}
+			compare(op_i, k, get_i, out_o, mask_i);
+		}
+
+	} // anonymous namespace
+
+	Selection::Selection(const size_t rows_i, const bool all_i)
+	: words_((rows_i + 63) / 64, all_i ? ~uint64_t(0) : 0), rows_(rows_i)
+	{
+		trim_();
+	}
+
+	void Selection::trim_()
+	{
+		if (rows_ & 63) words_.back() &= (uint64_t(1) << (rows_ & 63)) - 1;
+	}
+
+	size_t Selection::count() const
+	{
+		size_t n = 0;
+		for (const uint64_t w : words_) n += std::popcount(w);
+		return n;
+	}
+
+	Selection & Selection::operator&=(const Selection & rhs_i)
+	{
+		FCET(rows_ == rhs_i.rows_, std::invalid_argument, "Can't combine selections of {:d} and {:d} rows", rows_,
+			rhs_i.rows_);
+		for (size_t w = 0; w < words_.size(); w++) words_[w] &= rhs_i.words_[w];
+		return *this;
+	}
+
+	Selection & Selection::operator|=(const Selection & rhs_i)
+	{
+		FCET(rows_ == rhs_i.rows_, std::invalid_argument, "Can't combine selections of {:d} and {:d} rows", rows_,
+			rhs_i.rows_);
+		for (size_t w = 0; w < words_.size(); w++) words_[w] |= rhs_i.words_[w];
+		return *this;
+	}
+
+	Selection & Selection::flip()
+	{
+		for (uint64_t & w : words_) w = ~w;
+		trim_();
+		return *this;
+	}
+
+	std::vector<uint32_t> Selection::indices() const
+	{
+		std::vector<uint32_t> res;
+		res.reserve(count());
+		forEach([&](const size_t r_i) { res.push_back(static_cast<uint32_t>(r_i)); });
+		return res;
+	}
+
+	Predicate::Predicate(const op_e op_i, const string & column_i, std::vector<string> values_i)
+	: op_(op_i), column_(column_i), values_(std::move(values_i))
+	{
+		FCET(op_ == opAll || op_ == opAny || !column_.empty(), std::invalid_argument, "Given column name is empty");
+	}
+
+	Predicate Predicate::combine_(const op_e op_i, Predicate lhs_i, Predicate rhs_i)
+	{
+		Predicate p(op_i, "", {});
+		for (Predicate * c : { &lhs_i, &rhs_i }) {
+			if (c->op_ == op_i) {
+				std::move(c->children_.begin(), c->children_.end(), std::back_inserter(p.children_));
+			} else {
+				p.children_.push_back(std::move(*c));
+			}
+		}
+		return p;
+	}
+
+	Predicate Predicate::equal(const string & column_i, const string & value_i)
+	{
+		return Predicate(opEqual, column_i, { value_i });
+	}
+
+	Predicate Predicate::notEqual(const string & column_i, const string & value_i)
+	{
+		return Predicate(opNotEqual, column_i, { value_i });
+	}
+
+	Predicate Predicate::less(const string & column_i, const string & value_i)
+	{
+		return Predicate(opLess, column_i, { value_i });
+	}
+
+	Predicate Predicate::lessEqual(const string & column_i, const string & value_i)
+	{
+		return Predicate(opLessEqual, column_i, { value_i });
+	}
+
+	Predicate Predicate::greater(const string & column_i, const string & value_i)
+	{
+		return Predicate(opGreater, column_i, { value_i });
+	}
+
+	Predicate Predicate::greaterEqual(const string & column_i, const string & value_i)
+	{
+		return Predicate(opGreaterEqual, column_i, { value_i });
+	}
+
+	Predicate Predicate::between(const string & column_i, const string & low_i, const string & high_i)
+	{
+		return Predicate(opBetween, column_i, { low_i, high_i });
+	}
+
+	Predicate Predicate::in(const string & column_i, const std::vector<string> & values_i)
+	{
+		return Predicate(opIn, column_i, values_i);
+	}
+
+	Predicate Predicate::startsWith(const string & column_i, const string & prefix_i)
+	{
+		return Predicate(opPrefix, column_i, { prefix_i });
+	}
+
+	Predicate operator&&(Predicate lhs_i, Predicate rhs_i)
+	{
+		return Predicate::combine_(Predicate::opAll, std::move(lhs_i), std::move(rhs_i));
+	}
+
+	Predicate operator||(Predicate lhs_i, Predicate rhs_i)
+	{
+		return Predicate::combine_(Predicate::opAny, std::move(lhs_i), std::move(rhs_i));
+	}
+
+	template <typename TableT>
+	Selection Predicate::evaluate_(TableT & table_i, const size_t rows_i, const Selection * mask_i) const
+	{
+		if (op_ == opAll) {
+			// Later conditions only need to look at blocks that are still selected
+			Selection out = children_.front().evaluate_(table_i, rows_i, mask_i);
+			for (size_t c = 1; c < children_.size(); c++) out &= children_[c].evaluate_(table_i, rows_i, &out);
+			return out;
+		}
+		if (op_ == opAny) {
+			Selection out = children_.front().evaluate_(table_i, rows_i, mask_i);
+			for (size_t c = 1; c < children_.size(); c++) out |= children_[c].evaluate_(table_i, rows_i, mask_i);
+			return out;
+		}
+
+		Selection out(rows_i);
+		if (op_ == opIn && values_.empty()) return out;
+		leaf_(table_i, mask_i, out);
+		return out;
+	}
+
+	void Predicate::leaf_(HeaderedTable & table_i, const Selection * mask_i, Selection & out_o) const
+	{
+		const colidx_t c = table_i.columnIndex(column_);
+		strings(op_, values_, [&](const size_t r_i) { return string_view(table_i(c, static_cast<uint32_t>(r_i + 1))); },
+			out_o, mask_i);
+	}
+
+	void Predicate::leaf_(const ColumnTable & table_i, const Selection * mask_i, Selection & out_o) const
+	{
+		const ColumnTable::Column & col = table_i.column(column_);
+		FCET(op_ != opPrefix || col.type() == ColumnTable::text, std::invalid_argument,
+			"Prefix condition on {:s} column \"{:s}\", only text columns have prefixes",
+			ColumnTable::typeName(col.type()), col.name());
+
+		switch (col.type()) {
+			case ColumnTable::text: {
+				const DictColumn & d = col.dict();
+				if (op_ == opEqual || op_ == opNotEqual) {
+					// Compare the codes with the code of the value, in their native width
+					uint32_t code = 0;
+					const bool known = d.find(values_[0], code);
+					const bool equal = op_ == opEqual;
+					if (!known) {
+						if (!equal) scan(out_o, mask_i, [](const size_t) { return true; });
+						break;
+					}
+					d.visit([&](const auto & v_i) {
+						scan(out_o, mask_i, [&](const size_t r_i) { return (v_i[r_i] == code) == equal; });
+					});
+					break;
+				}
+
+				// Evaluate every distinct string once, then look up the codes
+				const std::deque<string> & dict = d.dictionary();
+				Selection codes(dict.size());
+				strings(op_, values_, [&](const size_t i_i) { return string_view(dict[i_i]); }, codes, nullptr);
+				d.visit([&](const auto & v_i) {
+					scan(out_o, mask_i, [&](const size_t r_i) { return codes.test(v_i[r_i]); });
+				});
+				break;
+			}
+
+			case ColumnTable::integer: {
+				std::span<const int64_t> v = col.values<int64_t>();
+				bool integral = true;
+				for (const string & s : values_) {
+					int64_t i;
+					integral = integral && parseNumber(s, i);
+				}
+				if (integral) {
+					compare(op_, keys<int64_t>(op_, values_, parseNumber<int64_t>, col),
+						[&](const size_t r_i) { return v[r_i]; }, out_o, mask_i);
+				} else {
+					compare(op_, keys<double>(op_, values_, parseNumber<double>, col),
+						[&](const size_t r_i) { return static_cast<double>(v[r_i]); }, out_o, mask_i);
+				}
+				break;
+			}
+
+			case ColumnTable::decimal: {
+				std::span<const double> v = col.values<double>();
+				compare(op_, keys<double>(op_, values_, parseNumber<double>, col),
+					[&](const size_t r_i) { return v[r_i]; }, out_o, mask_i);
+				break;
+			}
+
+			case ColumnTable::date: {
+				const std::vector<uint32_t> k = keys<uint32_t>(op_, values_, parseDate, col);
+				std::span<const NaiveDate> v = col.values<NaiveDate>();
+				std::vector<uint32_t> dates(v.size());
+				for (size_t r = 0; r < v.size(); r++) {
+					if (col.valid(r)) dates[r] = uint32_t(v[r].year()) << 9 | uint32_t(v[r].month()) << 5 | v[r].day();
+				}
+				compare(op_, k, [&](const size_t r_i) { return dates[r_i]; }, out_o, mask_i);
+				break;
+			}
+
+			case ColumnTable::time: {
+				const std::vector<uint32_t> k = keys<uint32_t>(op_, values_, parseTime, col);
+				std::span<const NaiveTime> v = col.values<NaiveTime>();
+				std::vector<uint32_t> times(v.size());
+				for (size_t r = 0; r < v.size(); r++) {
+					if (col.valid(r)) times[r] = uint32_t(v[r].hour()) * 60 + v[r].minute();
+				}
+				compare(op_, k, [&](const size_t r_i) { return times[r_i]; }, out_o, mask_i);
+				break;
+			}
+
+			case ColumnTable::boolean: {
+				std::span<const uint8_t> v = col.values<uint8_t>();
+				compare(op_, keys<uint8_t>(op_, values_, parseBoolean, col),
+					[&](const size_t r_i) { return v[r_i]; }, out_o, mask_i);
+				break;
+			}
+		}
+
+		// Missing values never match
+		std::span<const uint64_t> valid = col.validity();
+		std::span<uint64_t> words = out_o.words();
+		for (size_t w = 0; w < words.size(); w++) words[w] &= valid[w];
+	}
+
+	Selection Predicate::evaluate(HeaderedTable & table_i) const
+	{
+		return evaluate_(table_i, table_i.rows() > 0 ? table_i.rows() - 1 : 0, nullptr);
+	}
+
+	Selection Predicate::evaluate(const ColumnTable & table_i) const
+	{
+		return evaluate_(table_i, table_i.rows(), nullptr);
+	}
+
+	TableView::TableView(HeaderedTable & table_i, const Selection & selection_i)
+	: table_(table_i)
+	{
+		if (table_.rows() == 0) return;
+		FCET(selection_i.size() < table_.rows(), std::invalid_argument,
+			"Selection of {:d} rows doesn't fit a table with {:d} data rows", selection_i.size(), table_.rows() - 1);
+
+		rows_.reserve(selection_i.count() + 1);
+		rows_.push_back(0);
+		selection_i.forEach([&](const size_t r_i) { rows_.push_back(static_cast<uint32_t>(r_i + 1)); });
+	}
+
+	const string & TableView::cell(const colidx_t column_i, const uint32_t row_i) const
+	{
+		FCET(column_i < columns(), std::out_of_range, "Requested column {:d} should be less than the number of "
+			"columns, which is {:d}", column_i, columns());
+		FCET(row_i < rows(), std::out_of_range, "Requested row {:d} should be less than the number of rows in view, "
+			"which is {:d}", row_i, rows());
+		return (*this)(column_i, row_i);
+	}
+
+	const string & TableView::cell(const string & colname_i, const uint32_t row_i) const
+	{
+		return cell(table_.columnIndex(colname_i), row_i);
+	}
+
+	HeaderedTable TableView::toTable() const
+	{
+		HeaderedTable t;
+		if (rows_.empty()) return t;
+
+		t.columns(columns());
+		t.reserve(rows());
+		for (const uint32_t r : rows_) t.appendRow(std::span<const string>(table_.row(r)));
+		return t;
+	}
+
+} // Fs2a namespace
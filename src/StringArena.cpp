@@ -0,0 +1,89 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <utility>
+#include <fs2a/StringArena.hpp>
+
+namespace Fs2a {
+
+	StringArena::StringArena(const size_t chunkSize_i)
+	: cur_(nullptr), left_(0), chunkSize_(chunkSize_i ? chunkSize_i : 1), capacity_(0), used_(0)
+	{ }
+
+	StringArena::StringArena(StringArena && obj_io) noexcept
+	: chunks_(std::move(obj_io.chunks_)), cur_(obj_io.cur_), left_(obj_io.left_),
+	  chunkSize_(obj_io.chunkSize_), capacity_(obj_io.capacity_), used_(obj_io.used_)
+	{
+		obj_io.chunks_.clear();
+		obj_io.cur_ = nullptr;
+		obj_io.left_ = obj_io.capacity_ = obj_io.used_ = 0;
+	}
+
+	StringArena & StringArena::operator=(StringArena && obj_io) noexcept
+	{
+		if (this != &obj_io) {
+			chunks_ = std::move(obj_io.chunks_);
+			cur_ = std::exchange(obj_io.cur_, nullptr);
+			left_ = std::exchange(obj_io.left_, 0);
+			chunkSize_ = obj_io.chunkSize_;
+			capacity_ = std::exchange(obj_io.capacity_, 0);
+			used_ = std::exchange(obj_io.used_, 0);
+			obj_io.chunks_.clear();
+		}
+		return *this;
+	}
+
+	char * StringArena::allocateSlow_(const size_t len_i)
+	{
+		if (len_i > chunkSize_ / 4) {
+			// Large strings get a chunk of their own, so the current chunk can still be filled up.
+			// It is only reached through cur_, so it doesn't have to stay last.
+			chunks_.push_back(std::make_unique_for_overwrite<char[]>(len_i));
+			capacity_ += len_i;
+			used_ += len_i;
+			return chunks_.back().get();
+		}
+
+		chunks_.push_back(std::make_unique_for_overwrite<char[]>(chunkSize_));
+		capacity_ += chunkSize_;
+		cur_ = chunks_.back().get() + len_i;
+		left_ = chunkSize_ - len_i;
+		used_ += len_i;
+		return chunks_.back().get();
+	}
+
+	void StringArena::clear()
+	{
+		chunks_.clear();
+		cur_ = nullptr;
+		left_ = capacity_ = used_ = 0;
+	}
+
+} // Fs2a namespace
@@ -0,0 +1,601 @@
+/* BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Fs2a, Bren de Hartog <bren@fs2a.pro>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+#include <fmt/format.h>
+#include <fs2a/Logger.hpp>
+#include <fs2a/Parallel.hpp>
+#include <fs2a/StringArena.hpp>
+#include <fs2a/TableOps.hpp>
+
+namespace Fs2a {
+
+	using std::string;
+	using std::string_view;
+
+	namespace {
+
+		/// Minimum number of rows per thread
+		constexpr uint32_t parallelMinimum = 1 << 14;
+
+		/// Hash table from key to a row or group number
+		typedef std::unordered_map<string_view, uint32_t> keymap_t;
+
+		/** Determine the number of parts to split rows over.
+		 * @param rows_i Number of rows
+		 * @param threads_i Requested number of threads, 0 for all
+		 * @returns Number of parts, at least 1 */
+		size_t partCount(const uint32_t rows_i, const unsigned threads_i)
+		{
+			return std::max<size_t>(1, std::min<size_t>(threads_i ? threads_i : hardwareThreads(), rows_i / parallelMinimum));
+		}
+
+		/** Resolve column names.
+		 * @param table_io Table to resolve them in
+		 * @param names_i Column names
+		 * @returns Column indices */
+		std::vector<colidx_t> resolve(HeaderedTable & table_io, const std::vector<string> & names_i)
+		{
+			FCET(!names_i.empty(), std::invalid_argument, "No key columns given");
+			std::vector<colidx_t> cols;
+			cols.reserve(names_i.size());
+			for (const string & n : names_i) cols.push_back(table_io.columnIndex(n));
+			return cols;
+		}
+
+		/** Build the key of a row, without copying for a single key column.
+		 * Multiple key values are length prefixed and concatenated into the arena.
+		 * @param table_i Table to read from
+		 * @param cols_i Key columns
+		 * @param row_i Row to build the key of
+		 * @param arena_io Arena for composite keys
+		 * @returns View of the key */
+		string_view key(const HeaderedTable & table_i, const std::vector<colidx_t> & cols_i, const uint32_t row_i,
+			StringArena & arena_io)
+		{
+			if (cols_i.size() == 1) return table_i(cols_i.front(), row_i);
+
+			size_t len = 0;
+			for (const colidx_t c : cols_i) len += sizeof(uint32_t) + table_i(c, row_i).size();
+			char * p = arena_io.allocate(len), * k = p;
+			for (const colidx_t c : cols_i) {
+				const string & v = table_i(c, row_i);
+				const uint32_t l = static_cast<uint32_t>(v.size());
+				memcpy(p, &l, sizeof(l));
+				memcpy(p + sizeof(l), v.data(), l);
+				p += sizeof(l) + l;
+			}
+			return string_view(k, len);
+		}
+
+		/// Aggregation state of a group
+		typedef struct acc_s {
+			uint64_t n = 0;       ///< Number of values
+			bool integral = true; ///< All values are integers and their sum fits
+			int64_t isum = 0;     ///< Integer sum
+			int64_t imin = std::numeric_limits<int64_t>::max(); ///< Integer minimum
+			int64_t imax = std::numeric_limits<int64_t>::min(); ///< Integer maximum
+			double dsum = 0.0;    ///< Sum
+			double dmin = std::numeric_limits<double>::infinity();  ///< Minimum
+			double dmax = -std::numeric_limits<double>::infinity(); ///< Maximum
+
+			/// Add an integer value
+			inline void add(const int64_t v_i)
+			{
+				n++;
+				if (__builtin_add_overflow(isum, v_i, &isum)) integral = false;
+				imin = std::min(imin, v_i);
+				imax = std::max(imax, v_i);
+				add_(static_cast<double>(v_i));
+			}
+
+			/// Add a non-integer value
+			inline void add(const double v_i)
+			{
+				n++;
+				integral = false;
+				add_(v_i);
+			}
+
+			/// Update the floating point state
+			inline void add_(const double v_i)
+			{
+				dsum += v_i;
+				dmin = std::min(dmin, v_i);
+				dmax = std::max(dmax, v_i);
+			}
+
+			/// Merge the state of another part
+			void merge(const acc_s & o_i)
+			{
+				n += o_i.n;
+				integral = integral && o_i.integral && !__builtin_add_overflow(isum, o_i.isum, &isum);
+				imin = std::min(imin, o_i.imin);
+				imax = std::max(imax, o_i.imax);
+				dsum += o_i.dsum;
+				dmin = std::min(dmin, o_i.dmin);
+				dmax = std::max(dmax, o_i.dmax);
+			}
+		} acc_t;
+
+		/** Add a cell value to an aggregation state, if it is a number.
+		 * @param v_i Value
+		 * @param acc_io State to add it to */
+		inline void accumulate(const string & v_i, acc_t & acc_io)
+		{
+			if (v_i.empty()) return;
+			const char * first = v_i.data(), * last = first + v_i.size();
+
+			int64_t i = 0;
+			auto res = std::from_chars(first, last, i);
+			if (res.ec == std::errc() && res.ptr == last) {
+				acc_io.add(i);
+				return;
+			}
+			double d = 0.0;
+			res = std::from_chars(first, last, d);
+			if (res.ec == std::errc() && res.ptr == last) acc_io.add(d);
+		}
+
+		/// Names of the aggregate functions, indexed by GroupBy::func_e
+		const char * funcNames[] = { "count", "sum", "min", "max" };
+
+		/** Name the result columns of aggregates.
+		 * @param aggs_i Aggregates
+		 * @param names_io Names of the key columns, the names of the aggregates are appended and
+		 * all are made unique
+		 * @throws std::invalid_argument when an aggregate needs a column but has none
+		 * @throws std::out_of_range when there are too many result columns. */
+		void aggregateNames(const std::vector<GroupBy::aggregate_t> & aggs_i, std::vector<string> & names_io)
+		{
+			for (const GroupBy::aggregate_t & a : aggs_i) {
+				FCET(a.func == GroupBy::count || !a.column.empty(), std::invalid_argument,
+					"Aggregate function {:s} needs a column", funcNames[a.func]);
+				if (!a.name.empty()) names_io.push_back(a.name);
+				else if (a.column.empty()) names_io.push_back(funcNames[a.func]);
+				else names_io.push_back(fmt::format("{:s}_{:s}", funcNames[a.func], a.column));
+			}
+			FCET(names_io.size() <= maxColumns, std::out_of_range, "Too many result columns {:d}", names_io.size());
+			HeaderedTable::uniqueHeaders(names_io);
+		}
+
+		/** Format an aggregation state.
+		 * @param func_i Aggregate function
+		 * @param acc_i State
+		 * @returns Aggregate value, empty when there were no numbers to aggregate */
+		string aggregateValue(const GroupBy::func_e func_i, const acc_t & acc_i)
+		{
+			if (func_i == GroupBy::count) return std::to_string(acc_i.n);
+			if (acc_i.n == 0) return string();
+			if (func_i == GroupBy::sum) return acc_i.integral ? std::to_string(acc_i.isum) : fmt::format("{}", acc_i.dsum);
+			if (func_i == GroupBy::min) return acc_i.integral ? std::to_string(acc_i.imin) : fmt::format("{}", acc_i.dmin);
+			return acc_i.integral ? std::to_string(acc_i.imax) : fmt::format("{}", acc_i.dmax);
+		}
+
+		/** Hash the content of a row.
+		 * @param cols_i Number of columns
+		 * @param cell_i Function returning the cell of a column
+		 * @returns Hash of all cells, in column order */
+		template <typename Cell>
+		uint64_t rowHash(const colidx_t cols_i, Cell && cell_i)
+		{
+			std::hash<string_view> hash;
+			uint64_t h = cols_i;
+			for (colidx_t c = 0; c < cols_i; c++) h = (std::rotl(h, 29) ^ hash(cell_i(c))) * 0x9e3779b97f4a7c15ULL;
+			return h;
+		}
+
+		/// Row of the new table that differs from the old table
+		typedef struct diffRow_s {
+			uint32_t row;        ///< Row in the new table
+			bool inserted;       ///< Inserted or changed
+			string changed;      ///< Names of the changed columns
+		} diffRow_t;
+
+	} // anonymous namespace
+
+	HeaderedTable hashJoin(HeaderedTable & left_i, HeaderedTable & right_i, const std::vector<string> & keyCols_i,
+		const join_e kind_i, const unsigned threads_i)
+	{
+		const std::vector<colidx_t> lkeys = resolve(left_i, keyCols_i), rkeys = resolve(right_i, keyCols_i);
+
+		// Result columns and their names
+		std::vector<colidx_t> rcols;
+		if (kind_i != antiJoin) {
+			for (colidx_t c = 0; c < right_i.columns(); c++) {
+				if (std::find(rkeys.begin(), rkeys.end(), c) == rkeys.end()) rcols.push_back(c);
+			}
+		}
+		FCET(static_cast<size_t>(left_i.columns()) + rcols.size() <= maxColumns, std::out_of_range,
+			"Joined table would have {:d} columns, maximum is {:d}", left_i.columns() + rcols.size(), maxColumns);
+		std::vector<string> names;
+		for (colidx_t c = 0; c < left_i.columns(); c++) names.push_back(left_i(c, 0));
+		for (const colidx_t c : rcols) names.push_back(right_i(c, 0));
+		HeaderedTable::uniqueHeaders(names);
+
+		// Build side, rows with the same key are chained in ascending order through next
+		StringArena rarena;
+		keymap_t first;
+		std::vector<uint32_t> next(right_i.rows(), 0);
+		first.reserve(right_i.rows());
+		for (uint32_t r = right_i.rows() - 1; r > 0; r--) {
+			auto [it, fresh] = first.try_emplace(key(right_i, rkeys, r, rarena), r);
+			if (!fresh) {
+				next[r] = it->second;
+				it->second = r;
+			}
+		}
+
+		// Probe side, every part collects pairs of left and right rows, 0 for no right row
+		const uint32_t lrows = left_i.rows() - 1;
+		const size_t parts = partCount(lrows, threads_i);
+		std::vector<std::vector<std::pair<uint32_t, uint32_t>>> matches(parts);
+		parallelParts(parts, [&](const size_t p_i) {
+			StringArena arena;
+			auto & m = matches[p_i];
+			const uint32_t end = static_cast<uint32_t>(1 + uint64_t(lrows) * (p_i + 1) / parts);
+			for (uint32_t l = static_cast<uint32_t>(1 + uint64_t(lrows) * p_i / parts); l < end; l++) {
+				auto it = first.find(key(left_i, lkeys, l, arena));
+				if (it == first.end()) {
+					if (kind_i != innerJoin) m.emplace_back(l, 0);
+				} else if (kind_i != antiJoin) {
+					for (uint32_t r = it->second; r; r = next[r]) m.emplace_back(l, r);
+				}
+			}
+		});
+
+		// Copy the cells of all parts in parallel, each to its own rows
+		std::vector<size_t> offsets(parts + 1, 1);
+		for (size_t p = 0; p < parts; p++) offsets[p + 1] = offsets[p] + matches[p].size();
+		FCET(offsets[parts] <= UINT32_MAX, std::out_of_range, "Joined table would have {:d} rows", offsets[parts]);
+
+		HeaderedTable res;
+		res.columns(static_cast<colidx_t>(names.size()));
+		res.rows(static_cast<uint32_t>(offsets[parts]));
+		for (colidx_t c = 0; c < names.size(); c++) res(c, 0) = std::move(names[c]);
+		const colidx_t lcols = left_i.columns();
+		parallelParts(parts, [&](const size_t p_i) {
+			uint32_t o = static_cast<uint32_t>(offsets[p_i]);
+			for (const auto & [l, r] : matches[p_i]) {
+				for (colidx_t c = 0; c < lcols; c++) res(c, o) = left_i(c, l);
+				if (r) {
+					for (size_t c = 0; c < rcols.size(); c++) res(static_cast<colidx_t>(lcols + c), o) = right_i(rcols[c], r);
+				}
+				o++;
+			}
+		});
+
+		return res;
+	}
+
+	HeaderedTable diff(HeaderedTable & old_i, HeaderedTable & new_i, const std::vector<string> & keyCols_i,
+		const unsigned threads_i)
+	{
+		const std::vector<colidx_t> okeys = resolve(old_i, keyCols_i), nkeys = resolve(new_i, keyCols_i);
+		const colidx_t cols = new_i.columns();
+		FCET(old_i.columns() == cols, std::invalid_argument, "Tables to compare have {:d} and {:d} columns",
+			old_i.columns(), cols);
+		std::vector<colidx_t> ocols(cols); // Old column of every new column
+		for (colidx_t c = 0; c < cols; c++) ocols[c] = old_i.columnIndex(new_i(c, 0));
+
+		// Index the old rows by key and hash their content in the column order of the new table
+		const uint32_t orows = old_i.rows() - 1;
+		StringArena arena;
+		keymap_t index;
+		index.reserve(orows);
+		for (uint32_t r = 1; r <= orows; r++) {
+			FCET(index.emplace(key(old_i, okeys, r, arena), r).second, std::invalid_argument,
+				"Key of row {:d} of the old table is not unique", r);
+		}
+		std::vector<uint64_t> hashes(orows);
+		const size_t oparts = partCount(orows, threads_i);
+		parallelParts(oparts, [&](const size_t p_i) {
+			const uint32_t b = static_cast<uint32_t>(uint64_t(orows) * p_i / oparts);
+			const uint32_t e = static_cast<uint32_t>(uint64_t(orows) * (p_i + 1) / oparts);
+			for (uint32_t r = b; r < e; r++) {
+				hashes[r] = rowHash(cols, [&](const colidx_t c_i) { return string_view(old_i(ocols[c_i], r + 1)); });
+			}
+		});
+
+		// Match the new rows, comparing cells only when the hashes differ
+		const uint32_t nrows = new_i.rows() - 1;
+		const size_t parts = partCount(nrows, threads_i);
+		std::vector<std::atomic<uint8_t>> matched(orows);
+		std::vector<std::vector<diffRow_t>> changes(parts);
+		parallelParts(parts, [&](const size_t p_i) {
+			StringArena keys;
+			const uint32_t b = static_cast<uint32_t>(uint64_t(nrows) * p_i / parts) + 1;
+			const uint32_t e = static_cast<uint32_t>(uint64_t(nrows) * (p_i + 1) / parts) + 1;
+			for (uint32_t r = b; r < e; r++) {
+				auto it = index.find(key(new_i, nkeys, r, keys));
+				if (it == index.end()) {
+					changes[p_i].push_back({ r, true, string() });
+					continue;
+				}
+				const uint32_t o = it->second;
+				FCET(!matched[o - 1].exchange(1), std::invalid_argument, "Key of row {:d} of the new table is not unique", r);
+				if (rowHash(cols, [&](const colidx_t c_i) { return string_view(new_i(c_i, r)); }) == hashes[o - 1]) continue;
+
+				string names;
+				for (colidx_t c = 0; c < cols; c++) {
+					if (new_i(c, r) == old_i(ocols[c], o)) continue;
+					if (!names.empty()) names.push_back(',');
+					names += new_i(c, 0);
+				}
+				changes[p_i].push_back({ r, false, std::move(names) });
+			}
+		});
+
+		// Keys of inserted rows weren't checked against each other yet, the old index is done
+		for (const auto & part : changes) {
+			for (const diffRow_t & d : part) {
+				if (!d.inserted) continue;
+				FCET(index.emplace(key(new_i, nkeys, d.row, arena), 0).second, std::invalid_argument,
+					"Key of row {:d} of the new table is not unique", d.row);
+			}
+		}
+
+		std::vector<string> names = { "change", "changed" };
+		for (colidx_t c = 0; c < cols; c++) names.push_back(new_i(c, 0));
+		FCET(names.size() <= maxColumns, std::out_of_range, "Too many result columns {:d}", names.size());
+		HeaderedTable::uniqueHeaders(names);
+
+		size_t total = 1;
+		for (const auto & part : changes) total += part.size();
+		for (uint32_t o = 0; o < orows; o++) total += !matched[o];
+		FCET(total <= UINT32_MAX, std::out_of_range, "Too many changes {:d}", total);
+
+		HeaderedTable res;
+		res.columns(static_cast<colidx_t>(names.size()));
+		res.rows(static_cast<uint32_t>(total));
+		for (colidx_t c = 0; c < names.size(); c++) res(c, 0) = std::move(names[c]);
+		uint32_t row = 1;
+		for (auto & part : changes) {
+			for (diffRow_t & d : part) {
+				res(0, row) = d.inserted ? "inserted" : "changed";
+				res(1, row) = std::move(d.changed);
+				for (colidx_t c = 0; c < cols; c++) res(c + 2, row) = new_i(c, d.row);
+				row++;
+			}
+			part = std::vector<diffRow_t>();
+		}
+		for (uint32_t o = 0; o < orows; o++) {
+			if (matched[o]) continue;
+			res(0, row) = "deleted";
+			for (colidx_t c = 0; c < cols; c++) res(c + 2, row) = old_i(ocols[c], o + 1);
+			row++;
+		}
+
+		return res;
+	}
+
+	GroupBy::GroupBy(HeaderedTable & table_i, const std::vector<string> & keyCols_i)
+	: table_(table_i), keys_(resolve(table_i, keyCols_i))
+	{ }
+
+	HeaderedTable GroupBy::agg(const std::vector<aggregate_t> & aggs_i, const unsigned threads_i) const
+	{
+		// Result columns and their names
+		std::vector<int32_t> acols; // Aggregated column, -1 for none
+		std::vector<string> names;
+		for (const colidx_t c : keys_) names.push_back(table_(c, 0));
+		aggregateNames(aggs_i, names);
+		for (const aggregate_t & a : aggs_i) acols.push_back(a.column.empty() ? -1 : table_.columnIndex(a.column));
+
+		// Every part numbers the groups in its rows in order of appearance
+		const uint32_t rows = table_.rows() - 1;
+		const size_t parts = partCount(rows, threads_i);
+		std::vector<uint32_t> gids(rows);
+		std::vector<StringArena> arenas(parts);
+		std::vector<std::vector<string_view>> locals(parts);
+		auto bounds = [&](const size_t p_i) {
+			return std::make_pair(static_cast<uint32_t>(uint64_t(rows) * p_i / parts),
+				static_cast<uint32_t>(uint64_t(rows) * (p_i + 1) / parts));
+		};
+		parallelParts(parts, [&](const size_t p_i) {
+			keymap_t ids;
+			auto [b, e] = bounds(p_i);
+			for (uint32_t r = b; r < e; r++) {
+				string_view k = key(table_, keys_, r + 1, arenas[p_i]);
+				auto [it, fresh] = ids.try_emplace(k, static_cast<uint32_t>(locals[p_i].size()));
+				if (fresh) locals[p_i].push_back(k);
+				gids[r] = it->second;
+			}
+		});
+
+		// Number the groups globally, still in order of appearance
+		keymap_t ids;
+		std::vector<uint32_t> firstRows;
+		std::vector<std::vector<uint32_t>> global(parts);
+		for (size_t p = 0; p < parts; p++) {
+			for (const string_view k : locals[p]) {
+				auto [it, fresh] = ids.try_emplace(k, static_cast<uint32_t>(firstRows.size()));
+				if (fresh) firstRows.push_back(0);
+				global[p].push_back(it->second);
+			}
+		}
+		const uint32_t groups = static_cast<uint32_t>(firstRows.size());
+		parallelParts(parts, [&](const size_t p_i) {
+			auto [b, e] = bounds(p_i);
+			for (uint32_t r = b; r < e; r++) gids[r] = global[p_i][gids[r]];
+		});
+		for (uint32_t r = rows; r > 0; r--) firstRows[gids[r - 1]] = r;
+
+		// Aggregate a column at a time, every part into its own states
+		HeaderedTable res;
+		res.columns(static_cast<colidx_t>(names.size()));
+		res.rows(groups + 1);
+		for (colidx_t c = 0; c < names.size(); c++) res(c, 0) = std::move(names[c]);
+		for (uint32_t g = 0; g < groups; g++) {
+			for (colidx_t k = 0; k < keys_.size(); k++) res(k, g + 1) = table_(keys_[k], firstRows[g]);
+		}
+
+		std::vector<std::vector<acc_t>> accs(parts);
+		for (size_t a = 0; a < aggs_i.size(); a++) {
+			const colidx_t out = static_cast<colidx_t>(keys_.size() + a);
+			parallelParts(parts, [&](const size_t p_i) {
+				std::vector<acc_t> & acc = accs[p_i];
+				acc.assign(groups, acc_t());
+				auto [b, e] = bounds(p_i);
+				if (acols[a] < 0) {
+					for (uint32_t r = b; r < e; r++) acc[gids[r]].n++;
+				} else if (aggs_i[a].func == count) {
+					const colidx_t c = static_cast<colidx_t>(acols[a]);
+					for (uint32_t r = b; r < e; r++) acc[gids[r]].n += !table_(c, r + 1).empty();
+				} else {
+					const colidx_t c = static_cast<colidx_t>(acols[a]);
+					for (uint32_t r = b; r < e; r++) accumulate(table_(c, r + 1), acc[gids[r]]);
+				}
+			});
+			for (size_t p = 1; p < parts; p++) {
+				for (uint32_t g = 0; g < groups; g++) accs[0][g].merge(accs[p][g]);
+			}
+
+			for (uint32_t g = 0; g < groups; g++) res(out, g + 1) = aggregateValue(aggs_i[a].func, accs[0][g]);
+		}
+
+		return res;
+	}
+
+	ColumnGroupBy::ColumnGroupBy(const ColumnTable & table_i, const std::vector<string> & keyCols_i)
+	: table_(table_i)
+	{
+		FCET(!keyCols_i.empty(), std::invalid_argument, "No key columns given");
+		for (const string & n : keyCols_i) keys_.push_back(table_.columnIndex(n));
+	}
+
+	HeaderedTable ColumnGroupBy::agg(const std::vector<GroupBy::aggregate_t> & aggs_i, const unsigned threads_i) const
+	{
+		std::vector<const ColumnTable::Column *> acols; // Aggregated column, nullptr for none
+		std::vector<string> names;
+		for (const colidx_t c : keys_) names.push_back(table_.column(c).name());
+		aggregateNames(aggs_i, names);
+		for (const GroupBy::aggregate_t & a : aggs_i) acols.push_back(a.column.empty() ? nullptr : &table_.column(a.column));
+
+		// Fold the key columns into group numbers one at a time. Every key value gets a number,
+		// 0 for missing, which is combined with the groups so far and renumbered densely in
+		// order of appearance. Text columns use their codes, so only integers are combined.
+		const size_t rows = table_.rows();
+		FCET(rows < UINT32_MAX, std::out_of_range, "Too many rows {:d} to group", rows);
+		std::vector<uint32_t> gids(rows, 0), ids(rows);
+		uint64_t groups = 1;
+		for (const colidx_t k : keys_) {
+			const ColumnTable::Column & col = table_.column(k);
+			uint64_t values = 0;
+			if (col.type() == ColumnTable::text) {
+				const DictColumn & d = col.dict();
+				d.visit([&](const auto & c_i) {
+					for (size_t r = 0; r < rows; r++) ids[r] = col.valid(r) ? uint32_t(c_i[r]) + 1 : 0;
+				});
+				values = d.cardinality() + 1;
+			} else {
+				std::unordered_map<string, uint32_t> numbers;
+				for (size_t r = 0; r < rows; r++) {
+					if (!col.valid(r)) ids[r] = 0;
+					else ids[r] = numbers.try_emplace(col.str(r), static_cast<uint32_t>(numbers.size() + 1)).first->second;
+				}
+				values = numbers.size() + 1;
+			}
+
+			uint32_t next = 0;
+			if (groups * values <= std::max<uint64_t>(rows, 1 << 16)) {
+				std::vector<uint32_t> dense(groups * values, UINT32_MAX);
+				for (size_t r = 0; r < rows; r++) {
+					uint32_t & g = dense[gids[r] * values + ids[r]];
+					if (g == UINT32_MAX) g = next++;
+					gids[r] = g;
+				}
+			} else {
+				std::unordered_map<uint64_t, uint32_t> sparse;
+				for (size_t r = 0; r < rows; r++) {
+					gids[r] = sparse.try_emplace(gids[r] * values + ids[r], next).first->second;
+					if (gids[r] == next) next++;
+				}
+			}
+			groups = next;
+		}
+
+		std::vector<uint32_t> firstRows(groups);
+		for (size_t r = rows; r > 0; r--) firstRows[gids[r - 1]] = static_cast<uint32_t>(r - 1);
+
+		HeaderedTable res;
+		res.columns(static_cast<colidx_t>(names.size()));
+		res.rows(static_cast<uint32_t>(groups + 1));
+		for (colidx_t c = 0; c < names.size(); c++) res(c, 0) = std::move(names[c]);
+		for (uint32_t g = 0; g < groups; g++) {
+			for (colidx_t k = 0; k < keys_.size(); k++) res(k, g + 1) = table_.column(keys_[k]).str(firstRows[g]);
+		}
+
+		// Aggregate a column at a time, every part into its own states
+		const size_t parts = partCount(static_cast<uint32_t>(rows), threads_i);
+		auto bounds = [&](const size_t p_i) { return std::make_pair(rows * p_i / parts, rows * (p_i + 1) / parts); };
+		std::vector<std::vector<acc_t>> accs(parts);
+		for (size_t a = 0; a < aggs_i.size(); a++) {
+			const colidx_t out = static_cast<colidx_t>(keys_.size() + a);
+			const ColumnTable::Column * col = acols[a];
+			parallelParts(parts, [&](const size_t p_i) {
+				std::vector<acc_t> & acc = accs[p_i];
+				acc.assign(groups, acc_t());
+				auto [b, e] = bounds(p_i);
+				if (col == nullptr) {
+					for (size_t r = b; r < e; r++) acc[gids[r]].n++;
+				} else if (aggs_i[a].func == GroupBy::count) {
+					for (size_t r = b; r < e; r++) acc[gids[r]].n += col->valid(r);
+				} else if (col->type() == ColumnTable::integer) {
+					std::span<const int64_t> v = col->values<int64_t>();
+					for (size_t r = b; r < e; r++) if (col->valid(r)) acc[gids[r]].add(v[r]);
+				} else if (col->type() == ColumnTable::decimal) {
+					std::span<const double> v = col->values<double>();
+					for (size_t r = b; r < e; r++) if (col->valid(r)) acc[gids[r]].add(v[r]);
+				} else if (col->type() == ColumnTable::boolean) {
+					std::span<const uint8_t> v = col->values<uint8_t>();
+					for (size_t r = b; r < e; r++) if (col->valid(r)) acc[gids[r]].add(int64_t(v[r]));
+				} else if (col->type() == ColumnTable::text) {
+					const DictColumn & d = col->dict();
+					for (size_t r = b; r < e; r++) if (col->valid(r)) accumulate(d[r], acc[gids[r]]);
+				}
+			});
+			for (size_t p = 1; p < parts; p++) {
+				for (uint32_t g = 0; g < groups; g++) accs[0][g].merge(accs[p][g]);
+			}
+			for (uint32_t g = 0; g < groups; g++) res(out, g + 1) = aggregateValue(aggs_i[a].func, accs[0][g]);
+		}
+
+		return res;
+	}
+
+} // Fs2a namespace
@@ -28,29 +28,306 @@
  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <exception>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
+#include <fs2a/CsvScan.hpp>
+#include <fs2a/HeaderedTable.hpp>
+#include <fs2a/Logger.hpp>
+#include <fs2a/MappedFile.hpp>
+#include <fs2a/Parallel.hpp>
 #include <fs2a/readCSV.hpp>
 
 #define ERR "Error at line "s + std::to_string(line) + ", character "s + std::to_string(pos) + ": "s
 
 namespace Fs2a {
 
-	Table<std::string> readCSV(std::istream & stream_i, const char separator_i)
+	namespace {
+
+		/// Size of the blocks that readCSV_() reads from its stream or classifies at once
+		constexpr size_t blockSize = 256 * 1024;
+
+		/// Smallest part of CSV data in memory that is worth parsing in a thread of its own
+		constexpr size_t csvParallelMinimum = 4 << 20;
+
+		/// Part of the input for parseCSV_() to parse
+		typedef struct part_s {
+			bool header = true;          ///< Whether the part starts with the header
+			size_t line = 1;             ///< Line number at the start, set to the one at the end
+			size_t stop = SIZE_MAX;      ///< Stop at the first end of record at or after this offset in the input
+			size_t end = 0;              ///< Set to the offset in the input where parsing stopped
+		} part_t;
+
+		/** Block of input, for the parser to run over.
+		 * Blocks are either read from a stream into a buffer, or are consecutive windows on
+		 * data in memory, such as a mapped file. Every block is classified into bitmasks of
+		 * structural characters by CsvScan when it is made current. */
+		typedef struct block_s {
+			std::istream * stream;                  ///< Stream to read from, nullptr for data in memory
+			const char separator;                   ///< Field separator
+			std::vector<char> buf;                  ///< Block buffer for a stream
+			std::vector<CsvScan::masks_t> masks;    ///< Structural characters of the block per 64 bytes
+			const char * base = nullptr;            ///< Start of the block
+			const char * cur = nullptr;             ///< Next character to parse
+			const char * end = nullptr;             ///< End of the block
+			const char * last = nullptr;            ///< End of the data in memory
+			size_t consumed = 0;                    ///< Number of bytes of the input before the block
+			char prev = 0;                          ///< Last character of the previous block
+			size_t chunk = SIZE_MAX;                ///< 64 byte chunk of the block that @p todo is for
+			bool chunkQuoted = false;               ///< Whether @p todo assumes the chunk starts quoted
+			uint64_t inside = 0;                    ///< Bytes of the chunk after which a field is quoted
+			uint64_t todo = 0;                      ///< Bytes of the chunk the parser has to handle one by one
+
+			/// Constructor for reading from a stream
+			block_s(std::istream & stream_i, const char separator_i)
+			: stream(&stream_i), separator(separator_i), buf(blockSize), masks(CsvScan::blocks(blockSize))
+			{}
+
+			/// Constructor for data in memory, which is not copied
+			block_s(const char * data_i, const size_t size_i, const char separator_i)
+			: stream(nullptr), separator(separator_i), masks(CsvScan::blocks(blockSize)), base(data_i), cur(data_i),
+			end(data_i), last(data_i + size_i)
+			{}
+
+			/** Make the next block current.
+			 * @returns False at the end of the input. */
+			bool fill()
+			{
+				// The current block stays the last one at the end, so offset() stays right
+				if (stream == nullptr ? end == last : !stream->good()) return false;
+				consumed += static_cast<size_t>(end - base);
+				if (end != base) prev = end[-1];
+				if (stream == nullptr) {
+					base = end;
+					end += std::min<size_t>(blockSize, static_cast<size_t>(last - end));
+				} else {
+					stream->read(buf.data(), static_cast<std::streamsize>(buf.size()));
+					base = buf.data();
+					end = base + stream->gcount();
+				}
+				cur = base;
+				CsvScan::classify(base, static_cast<size_t>(end - base), separator, masks.data());
+				chunk = SIZE_MAX;
+				return cur != end;
+			}
+
+			/// @returns Offset in the input of the next character to parse
+			inline size_t offset() const { return consumed + static_cast<size_t>(cur - base); }
+
+			/// @returns The next character, or EOF at the end of the stream
+			inline int get() { return cur != end || fill() ? static_cast<unsigned char>(*cur++) : EOF; }
+
+			/// @returns The next character without consuming it, or EOF at the end of the stream
+			inline int peek() { return cur != end || fill() ? static_cast<unsigned char>(*cur) : EOF; }
+
+			/** Skip plain field data, up to the next character that the parser has to handle
+			 * or the end of the stream. Outside a quoted field that is a quote, separator, CR or
+			 * LF, inside one only a quote. Quoted regions are predicted per 64 bytes from the
+			 * prefix XOR of the quote mask. The prediction is wrong after a quote that the parser
+			 * takes as data, in which case the chunk is predicted again from the actual state.
+			 * @param quoted_i Whether the parser is in a quoted field
+			 * @param f_io Field to append the skipped data to
+			 * @param line_io Line number, counting the line endings in quoted data
+			 * @param pos_io Character position, updated for the skipped data
+			 * @returns True if anything was skipped. */
+			template <typename FieldT>
+			bool skip(const bool quoted_i, FieldT & f_io, size_t & line_io, size_t & pos_io)
+			{
+				const char * start = cur;
+				bool skipped = false;
+
+				while (true) {
+					if (cur == end) {
+						// Keep what was skipped so far, the buffer is about to be reused
+						f_io.append(start, cur);
+						skipped |= cur != start;
+						if (!fill()) return skipped;
+						start = cur;
+					}
+
+					const size_t off = static_cast<size_t>(cur - base);
+					const size_t c = off / CsvScan::blockBytes;
+					const unsigned bit = off % CsvScan::blockBytes;
+					const CsvScan::masks_t & m = masks[c];
+					const uint64_t from = ~uint64_t(0) << bit;
+
+					if (c != chunk || (bit == 0 ? chunkQuoted : (inside >> (bit - 1)) & 1) != quoted_i) {
+						inside = CsvScan::prefixXor(m.quote & from) ^ (quoted_i ? ~uint64_t(0) : 0);
+						todo = m.quote | ((m.separator | m.cr | m.lf) & ~inside);
+						chunk = c;
+						chunkQuoted = quoted_i;
+					}
+
+					const uint64_t next = todo & from;
+					const char * const at = base + c * CsvScan::blockBytes;
+					const unsigned stop = next ? static_cast<unsigned>(std::countr_zero(next)) :
+						static_cast<unsigned>(std::min<size_t>(CsvScan::blockBytes, static_cast<size_t>(end - at)));
+					const uint64_t span = from & (stop == 64 ? ~uint64_t(0) : (uint64_t(1) << stop) - 1);
+
+					// Only quoted data contains line endings, CRLF counts as one
+					const uint64_t ends = (m.cr | m.lf) & span;
+					if (ends) {
+						const bool crBefore = (c == 0 ? prev : at[-1]) == '\r';
+						line_io += static_cast<size_t>(std::popcount((m.cr | (m.lf & ~((m.cr << 1) | crBefore))) & span));
+						pos_io = stop - 1 - (63 - static_cast<unsigned>(std::countl_zero(ends)));
+					} else {
+						pos_io += stop - bit;
+					}
+
+					cur = at + stop;
+					if (next) break;
+				}
+
+				f_io.append(start, cur);
+				return skipped || cur != start;
+			}
+		} block_t;
+
+		/** Field of CSV data in memory, that views into the data as long as it is a single
+		 * contiguous span of it, and only becomes a string of its own after an escaped quote. */
+		typedef struct viewField_s {
+			const char * begin = nullptr; ///< Start of the view
+			const char * end = nullptr;   ///< End of the view
+			std::string str;              ///< Contents when not a view
+			bool owned = false;           ///< Whether the contents are in @p str
+
+			/** Append data to the field, in the same way as to a std::string.
+			 * @param first_i Start of the data
+			 * @param last_i End of the data */
+			void append(const char * first_i, const char * last_i)
+			{
+				if (first_i == last_i) return;
+				if (!owned) {
+					if (begin == end) {
+						begin = first_i;
+						end = last_i;
+						return;
+					}
+					if (first_i == end) {
+						end = last_i;
+						return;
+					}
+					str.assign(begin, end);
+					owned = true;
+				}
+				str.append(first_i, last_i);
+			}
+
+			/** Append data to the field, in the same way as to a std::string.
+			 * @param first_i Start of the data
+			 * @param len_i Length of the data */
+			inline void append(const char * first_i, const size_t len_i) { append(first_i, first_i + len_i); }
+
+			/// Empty the field
+			inline void clear() { begin = end = nullptr; str.clear(); owned = false; }
+
+			/// Whether the field is empty
+			inline bool empty() const { return owned ? str.empty() : begin == end; }
+
+			/// View of the contents
+			inline std::string_view view() const { return owned ? std::string_view(str) : std::string_view(begin, end - begin); }
+		} viewField_t;
+
+		/// Column table that readCSV_() can read into
+		typedef struct columnSink_s {
+			ColumnTable & table;            ///< Table to read into
+			colidx_t cols = 0;              ///< Number of columns of the CSV
+			std::vector<std::string> names; ///< Header fields, until all are read
+
+			/// @{ Number of columns, as used by the parser
+			inline void columns(const colidx_t cols_i) { cols = cols_i; }
+			inline colidx_t columns() const { return cols; }
+			/// @}
+		} columnSink_t;
+
+		/// Fields of a single row that CsvReader reads into, reused from row to row
+		typedef struct rowSink_s {
+			std::vector<std::string> fields; ///< Fields of the row
+			bool filled = false;             ///< Whether a field was stored since the row was cleared
+
+			/// @{ Number of columns, as used by the parser
+			inline void columns(const colidx_t cols_i) { fields.resize(cols_i); }
+			inline colidx_t columns() const { return static_cast<colidx_t>(fields.size()); }
+			/// @}
+		} rowSink_t;
+
+		/** @{ Store a field in a table, depending on its type.
+		 * Fields arrive in order and the column count is checked by the parser, so only the
+		 * first field of a row needs to add a row and the rest can use unchecked access. */
+		inline void store(Table<std::string> & table_io, const colidx_t col_i, const uint32_t row_i, const std::string & f_i)
+		{
+			if (col_i == 0) table_io.rows(row_i + 1);
+			table_io(col_i, row_i) = f_i;
+		}
+
+		inline void store(ArenaTable & table_io, const colidx_t col_i, const uint32_t row_i, const std::string & f_i)
+		{
+			if (col_i == 0) table_io.rows(row_i + 1);
+			table_io(col_i, row_i) = table_io.store(f_i);
+		}
+
+		inline void store(ArenaTable & table_io, const colidx_t col_i, const uint32_t row_i, const viewField_t & f_i)
+		{
+			if (col_i == 0) table_io.rows(row_i + 1);
+			table_io(col_i, row_i) = f_i.owned ? table_io.store(f_i.str) : f_i.view();
+		}
+
+		inline void store(columnSink_t & sink_io, const colidx_t col_i, const uint32_t row_i, const std::string & f_i)
+		{
+			if (row_i == 0) {
+				// Columns are added once the whole header is known, to make the names unique
+				sink_io.names.push_back(f_i);
+				if (col_i + 1 < sink_io.cols) return;
+				HeaderedTable::uniqueHeaders(sink_io.names);
+				for (const std::string & n : sink_io.names) sink_io.table.addColumn(n, ColumnTable::text);
+				sink_io.names.clear();
+				return;
+			}
+
+			// A row can end early, so fill up the columns it skipped first
+			ColumnTable::Column & c = sink_io.table.column(col_i);
+			while (c.size() + 1 < row_i) c.appendNull();
+			c.append(f_i);
+		}
+
+		inline void store(rowSink_t & sink_io, const colidx_t col_i, const uint32_t, const std::string & f_i)
+		{
+			// Assigning keeps the memory of the field from earlier rows
+			sink_io.fields[col_i] = f_i;
+			sink_io.filled = true;
+		}
+		/** @} */
+
+	} // anonymous namespace
+
+	/** Parse CSV into any table type for which store() is defined.
+	 * The input is processed in blocks and runs of plain field data are appended as a whole, so
+	 * the state machine only handles quotes, separators and unquoted line endings one at a time.
+	 * @param in Input to read CSV from.
+	 * @param t Table to read into, should be empty. When @p part_io doesn't start with the
+	 * header, it should have its columns set and rows are stored from row 0.
+	 * @param separator_i Separator character to use
+	 * @param part_io Part of the input to parse, a part that starts after the header should
+	 * start at the start of a record.
+	 * @param f Field to collect data in, kept by the caller to reuse its memory */
+	template <typename FieldT, typename TableT>
+	static void parseCSV_(block_t & in, TableT & t, const char separator_i, part_t & part_io, FieldT & f)
 	{
 		using namespace std::string_literals;
 
-		Table<std::string> t;
-		std::vector<std::string> h; // Header
-		bool readingHeader = true;
+		std::vector<FieldT> h; // Header
+		bool readingHeader = part_io.header;
 		bool quoted = false;
-		char c;
-		std::string f; // Field with data
-		uint16_t col = 0;
+		int c;
+		colidx_t col = 0;
 		uint32_t row = 0;
-		size_t line = 1;
-		size_t pos = 1;
+		size_t line = part_io.line;
+		size_t pos = part_io.header ? 1 : 0;
 
 		enum last_e : uint8_t {
 			beginQuote,
@@ -62,24 +339,32 @@ namespace Fs2a {
 
 		last_e last = startOfRecord;
 
+		auto done = [&]() {
+			part_io.line = line;
+			part_io.end = in.offset();
+		};
+
+		f.clear();
+
 		auto fieldReady = [&]() {
 			if (readingHeader) {
 				h.push_back(f);
 			}
 			else {
-				t.cell(col, row) = f;
+				store(t, col, row, f);
 			}
 			f.clear();
 		};
 
-		// Disable exceptions for EOF on the stream, because we need to be able to handle EOF properly.
-		// If something bad happens other than EOF, throw exception.
-		stream_i.exceptions(std::istream::badbit);
+		while (true) {
+			// Skip plain field data up to the next character that matters in one go. Not at the
+			// start of the CSV, where 8-bit characters are skipped one by one below.
+			if ((!readingHeader || row > 0 || last != startOfRecord) && in.skip(quoted, f, line, pos)) {
+				last = fieldData;
+			}
 
-		while (stream_i.good()) {
-			stream_i.read(&c, 1);
-			if (stream_i.eof()) c = EOF;
-			else pos++;
+			c = in.get();
+			if (c != EOF) pos++;
 
 			// Skip valid but unused 8-bit characters at start of CSV
 			if (readingHeader && last == startOfRecord && col == 0 && row == 0 && c != EOF && c & 0x80) continue;
@@ -93,24 +378,29 @@ namespace Fs2a {
 						throw std::runtime_error(ERR + "Encountered EOF while reading quoted field");
 
 					case '\r':
-						if (stream_i.peek() == '\n') {
-							f.push_back(c);
+						// Append before peeking, which can read the next block over this one
+						f.append(in.cur - 1, 1);
+						if (in.peek() == '\n') {
 							// Swallow \r\n
-							stream_i.read(&c, 1);
+							in.get();
+							f.append(in.cur - 1, 1);
 						}
-						// Fallthrough
+						line++; pos = 0;
+						last = fieldData;
+						continue;
+
 					case '\n':
-						f.push_back(c);
+						f.append(in.cur - 1, 1);
 						line++; pos = 0;
 						last = fieldData;
 						continue;
 
 					case '"':
-						if (stream_i.peek() == '"') {
+						if (in.peek() == '"') {
 							// Escaped quote
-							stream_i.read(&c, 1);
+							in.get();
 							pos++;
-							f.push_back(c);
+							f.append(in.cur - 1, 1);
 							last = fieldData;
 						} else {
 							// End quote. The field is stored on the next separator or end of record
@@ -120,7 +410,7 @@ namespace Fs2a {
 						continue;
 
 					default:
-						f.push_back(c);
+						f.append(in.cur - 1, 1);
 						last = fieldData;
 						continue;
 				}
@@ -129,9 +419,9 @@ namespace Fs2a {
 			// From here on, we are not reading a quoted field, so parse normally
 			if (c == '\r' || c == '\n' || c == EOF) {
 				// End of record
-				if (c == '\r' && stream_i.peek() == '\n') {
+				if (c == '\r' && in.peek() == '\n') {
 					// Swallow \r\n
-					stream_i.read(&c, 1);
+					in.get();
 					pos++;
 				}
 				switch (last) {
@@ -145,23 +435,22 @@ namespace Fs2a {
 						break;
 
 					case startOfRecord:
-						if (stream_i.peek() != EOF) throw std::runtime_error(ERR + "Found empty line");
-						else return t;
+						if (in.peek() != EOF) throw std::runtime_error(ERR + "Found empty line");
+						done();
+						return;
 				}
 
 				if (readingHeader) {
 					if (h.empty()) {
 						throw std::runtime_error(ERR + "Empty line at beginning, unable to determine number of columns"s);
 					}
-					// Both column adressing and count are
-					// uint16_t, so max is UINT16_MAX - 1
-					if (h.size() >= UINT16_MAX) {
+					if (h.size() > maxColumns) {
 						throw std::out_of_range(ERR + "Encountered too many columns "s + std::to_string(h.size()) +
-							", maximum is " + std::to_string(UINT16_MAX-1));
+							", maximum is " + std::to_string(maxColumns));
 					}
-					t.columns(static_cast<uint16_t>(h.size()));
+					t.columns(static_cast<colidx_t>(h.size()));
 					for (col = 0; col < h.size(); col++) {
-						t.cell(col, 0) = h.at(col);
+						store(t, col, 0, h.at(col));
 					}
 					h.clear();
 					row = 1;
@@ -179,9 +468,17 @@ namespace Fs2a {
 					}
 					row++;
 				}
+				if (c == EOF) {
+					done();
+					return;
+				}
 				line++;
 				pos = 0;
 				last = startOfRecord;
+				if (in.offset() >= part_io.stop) {
+					done();
+					return;
+				}
 				continue;
 			}
 
@@ -194,7 +491,7 @@ namespace Fs2a {
 
 					case fieldData:
 						// Include sole " in unquoted field
-						f.push_back(c);
+						f.append(in.cur - 1, 1);
 						continue;
 
 					case separator:
@@ -221,11 +518,263 @@ namespace Fs2a {
 			}
 
 			// The default case for c:
-			f.push_back(c);
+			f.append(in.cur - 1, 1);
 			last = fieldData;
 		}
+	}
 
+	/** Parse CSV from a stream into any table type for which store() is defined.
+	 * @param stream_i Input stream to read CSV from.
+	 * @param t Table to read into, should be empty
+	 * @param separator_i Separator character to use */
+	template <typename TableT>
+	static void readCSV_(std::istream & stream_i, TableT & t, const char separator_i)
+	{
+		// Disable exceptions for EOF on the stream, because we need to be able to handle EOF properly.
+		// If something bad happens other than EOF, throw exception.
+		stream_i.exceptions(std::istream::badbit);
+		block_t in(stream_i, separator_i);
+		part_t all;
+		std::string f;
+		parseCSV_(in, t, separator_i, all, f);
+	}
+
+	Table<std::string> readCSV(std::istream & stream_i, const char separator_i)
+	{
+		Table<std::string> t;
+		readCSV_(stream_i, t, separator_i);
 		return t;
 	}
 
+	void readCSV(std::istream & stream_i, ArenaTable & table_o, const char separator_i)
+	{
+		readCSV_(stream_i, table_o, separator_i);
+	}
+
+	/** Parse the records of CSV data in memory after its header in parallel.
+	 * The data is split into parts at line endings, and every part is parsed in a thread of
+	 * its own on the assumption that it starts at the start of a record. Every part stops at
+	 * the first end of record at or after the start of the next one, so the assumption holds
+	 * for the next part when they meet. When they don't, because the line ending was in a
+	 * quoted field, the next part is parsed again from where the previous one stopped. Errors
+	 * are only reported for parts that started right, by parsing them again with the line
+	 * number they start at.
+	 * @param table_io Table with the header read, to append the records to
+	 * @param data_i Start of the records
+	 * @param end_i End of the data
+	 * @param line_i Line number of the first record
+	 * @param separator_i Separator character to use
+	 * @param parts_i Number of parts to split into */
+	static void parseParts_(ArenaTable & table_io, const char * data_i, const char * end_i, const size_t line_i,
+		const char separator_i, const size_t parts_i)
+	{
+		// Start the parts after the first line ending at or after an even split
+		std::vector<const char *> starts = { data_i };
+		for (size_t p = 1; p < parts_i; p++) {
+			const char * s = std::max(starts.back(), data_i + (end_i - data_i) * p / parts_i);
+			while (s != end_i && *s != '\n' && *s != '\r') s++;
+			if (s != end_i && *s == '\r') s++;
+			if (s != end_i && *s == '\n') s++;
+			if (s != end_i && s != starts.back()) starts.push_back(s);
+		}
+		const size_t parts = starts.size();
+
+		std::vector<ArenaTable> tables(parts);
+		std::vector<const char *> froms(starts);
+		std::vector<part_t> results(parts);
+		std::vector<std::exception_ptr> errors(parts);
+		auto parse = [&](const size_t p_i, const char * from_i, const size_t line_i) {
+			tables[p_i] = ArenaTable();
+			tables[p_i].columns(table_io.columns());
+			froms[p_i] = from_i;
+			results[p_i] = part_t{false, line_i, p_i + 1 < parts ? static_cast<size_t>(starts[p_i + 1] - from_i) : SIZE_MAX, 0};
+			block_t in(from_i, static_cast<size_t>(end_i - from_i), separator_i);
+			viewField_t f;
+			parseCSV_(in, tables[p_i], separator_i, results[p_i], f);
+		};
+
+		parallelParts(parts, [&](const size_t p_i) {
+			try { parse(p_i, starts[p_i], 1); }
+			catch (...) { errors[p_i] = std::current_exception(); }
+		});
+
+		// Walk the parts in order, to find where every one should have started
+		const char * at = data_i;
+		size_t line = line_i;
+		for (size_t p = 0; p < parts; p++) {
+			if (at == starts[p] && !errors[p]) {
+				line += results[p].line - 1;
+			} else if (p + 1 < parts && at >= starts[p + 1]) {
+				// The previous part already parsed all of this one
+				tables[p] = ArenaTable();
+				continue;
+			} else {
+				// Throws with the right line number, if the error was real
+				parse(p, at, line);
+				line = results[p].line;
+			}
+			at = froms[p] + results[p].end;
+		}
+
+		size_t rows = table_io.rows();
+		for (const ArenaTable & t : tables) rows += t.rows();
+		FCET(rows <= UINT32_MAX, std::runtime_error, "Input data has more than {:d} rows", UINT32_MAX);
+
+		// Views into the mapping can be copied in parallel, fields with escaped quotes are
+		// stored in the arena of the table afterwards
+		std::vector<uint32_t> firstRows(parts);
+		uint32_t next = table_io.rows();
+		for (size_t p = 0; p < parts; p++) {
+			firstRows[p] = next;
+			next += tables[p].rows();
+		}
+		table_io.rows(next);
+		const colidx_t cols = table_io.columns();
+		std::vector<std::vector<std::pair<colidx_t, uint32_t>>> owned(parts);
+		parallelParts(parts, [&](const size_t p_i) {
+			const ArenaTable & t = tables[p_i];
+			for (uint32_t r = 0; r < t.rows(); r++) {
+				for (colidx_t c = 0; c < cols; c++) {
+					const std::string_view v = t(c, r);
+					if (!v.empty() && (v.data() < data_i || v.data() >= end_i)) owned[p_i].emplace_back(c, r);
+					else table_io(c, firstRows[p_i] + r) = v;
+				}
+			}
+		});
+		for (size_t p = 0; p < parts; p++) {
+			for (const auto & [c, r] : owned[p]) table_io(c, firstRows[p] + r) = table_io.store(tables[p](c, r));
+		}
+	}
+
+	void readCSV(const std::filesystem::path & path_i, ArenaTable & table_o, const char separator_i,
+		const unsigned threads_i)
+	{
+		auto file = std::make_shared<const MappedFile>(path_i.string());
+		file->sequential();
+		table_o.retain(file);
+		block_t in(file->data(), file->size(), separator_i);
+		part_t head;
+		viewField_t f;
+
+		const size_t threads = std::min<size_t>(threads_i ? threads_i : hardwareThreads(),
+			file->size() / csvParallelMinimum);
+		if (threads > 1) head.stop = 0;
+		parseCSV_(in, table_o, separator_i, head, f);
+
+		if (threads > 1 && head.end != file->size() && table_o.columns() > 0) {
+			parseParts_(table_o, file->data() + head.end, file->data() + file->size(), head.line, separator_i, threads);
+		}
+	}
+
+	ArenaTable readCSV(const std::filesystem::path & path_i, const char separator_i, const unsigned threads_i)
+	{
+		ArenaTable t;
+		readCSV(path_i, t, separator_i, threads_i);
+		return t;
+	}
+
+	void readCSV(std::istream & stream_i, ColumnTable & table_o, const char separator_i)
+	{
+		FCET(table_o.columns() == 0, std::invalid_argument, "Table to read CSV into already has {:d} columns",
+			table_o.columns());
+		columnSink_t sink{table_o, 0, {}};
+		readCSV_(stream_i, sink, separator_i);
+
+		const size_t rows = table_o.rows();
+		for (colidx_t c = 1; c < table_o.columns(); c++) {
+			ColumnTable::Column & col = table_o.column(c);
+			while (col.size() < rows) col.appendNull();
+		}
+		table_o.updateAccount();
+	}
+
+	struct CsvReader::state_s {
+		block_t in;                             ///< Input, in blocks
+		rowSink_t sink;                         ///< Fields of the current row
+		std::string f;                          ///< Field the parser collects data in
+		std::vector<std::string> names;         ///< Fields of the header
+		std::vector<std::string_view> header;   ///< Views on @p names
+		std::vector<std::string_view> views;    ///< Views on the fields of the current row
+		size_t line = 1;                        ///< Line number of the next record
+		size_t rows = 0;                        ///< Number of rows read after the header
+		bool started = false;                   ///< Whether the header has been read
+		std::exception_ptr failure;             ///< Error reading the header, thrown again on later calls
+
+		/// Constructor
+		state_s(std::istream & stream_i, const char separator_i)
+		: in(stream_i, separator_i)
+		{}
+	};
+
+	CsvReader::CsvReader(std::istream & stream_i, const char separator_i)
+	: state_(std::make_unique<state_s>(stream_i, separator_i))
+	{
+		// Same as readCSV_(), EOF is handled by the parser
+		stream_i.exceptions(std::istream::badbit);
+	}
+
+	CsvReader::CsvReader(CsvReader && obj_io) noexcept = default;
+
+	CsvReader & CsvReader::operator=(CsvReader && obj_io) noexcept = default;
+
+	CsvReader::~CsvReader() = default;
+
+	std::span<const std::string_view> CsvReader::header()
+	{
+		state_s & s = *state_;
+		if (s.failure) std::rethrow_exception(s.failure);
+		if (!s.started) {
+			// Stop right after the first record
+			part_t part;
+			part.stop = 0;
+			try {
+				parseCSV_(s.in, s.sink, s.in.separator, part, s.f);
+			} catch (...) {
+				s.failure = std::current_exception();
+				throw;
+			}
+			s.started = true;
+			s.line = part.line;
+			s.names = s.sink.fields;
+			s.header.assign(s.names.begin(), s.names.end());
+			s.views.resize(s.names.size());
+		}
+		return s.header;
+	}
+
+	colidx_t CsvReader::columns()
+	{
+		return static_cast<colidx_t>(header().size());
+	}
+
+	bool CsvReader::next()
+	{
+		if (columns() == 0) return false;
+
+		state_s & s = *state_;
+		for (std::string & field : s.sink.fields) field.clear();
+		s.sink.filled = false;
+		part_t part{false, s.line, 0, 0};
+		parseCSV_(s.in, s.sink, s.in.separator, part, s.f);
+		s.line = part.line;
+		if (!s.sink.filled) {
+			s.views.assign(s.views.size(), std::string_view());
+			return false;
+		}
+
+		for (size_t c = 0; c < s.views.size(); c++) s.views[c] = s.sink.fields[c];
+		s.rows++;
+		return true;
+	}
+
+	std::span<const std::string_view> CsvReader::row() const
+	{
+		return state_->views;
+	}
+
+	size_t CsvReader::rows() const
+	{
+		return state_->rows;
+	}
+
 } // Fs2a namespace